@@ -169,6 +169,13 @@ CREATE INDEX IF NOT EXISTS transactions_first_date_index on transactions (first_
 CREATE INDEX IF NOT EXISTS transactions_last_date_index on transactions (last_date desc);
 CREATE INDEX IF NOT EXISTS transactions_next_date_index on transactions (next_date desc);
 CREATE INDEX IF NOT EXISTS transactions_unit_price_date_index on transactions (unit_price_date desc);
+CREATE INDEX IF NOT EXISTS transactions_account_id_type_valuta_date_index on transactions (account_id asc, `type` asc, valuta_date desc);
+CREATE INDEX IF NOT EXISTS transactions_sort_valuta_date_index on transactions (account_id, IFNULL(valuta_date, ''), id);
+CREATE INDEX IF NOT EXISTS transactions_sort_date_index on transactions (account_id, IFNULL(`date`, ''), id);
+CREATE INDEX IF NOT EXISTS transactions_sort_remote_name_index on transactions (account_id, IFNULL(remote_name, ''), id);
+CREATE INDEX IF NOT EXISTS transactions_sort_purpose_index on transactions (account_id, IFNULL(purpose, ''), id);
+CREATE INDEX IF NOT EXISTS transactions_sort_category_index on transactions (account_id, IFNULL(`category`, ''), id);
+CREATE INDEX IF NOT EXISTS transactions_sort_value_index on transactions (account_id, IFNULL(`value`, 0), id);
 
 CREATE TABLE IF NOT EXISTS balances
 (
@@ -184,6 +191,67 @@ CREATE TABLE IF NOT EXISTS balances
 );
 CREATE INDEX IF NOT EXISTS balances_date_index on balances (`date` desc);
 
+CREATE TABLE IF NOT EXISTS remote_accounts
+(
+    id             integer not null
+        constraint remote_accounts_id_pk primary key autoincrement,
+    iban           varchar(34) not null,
+    bic            varchar(11),
+    bank_code      varchar(10),
+    account_number varchar(10),
+    bank_name      varchar(128),
+    iban_valid     tinyint default 0,
+    account_valid  tinyint default 0,
+    bank_known     tinyint default 0,
+    UNIQUE (iban)
+);
+CREATE UNIQUE INDEX IF NOT EXISTS remote_accounts_iban_unique_index on remote_accounts (iban asc);
+CREATE INDEX IF NOT EXISTS transactions_remote_iban_index on transactions (remote_iban asc);
+
+CREATE TABLE IF NOT EXISTS category_rules
+(
+    id        integer not null
+        constraint category_rules_id_pk primary key autoincrement,
+    category  varchar not null,
+    fields    integer default 3,
+    pattern   varchar,
+    min_value double,
+    max_value double,
+    priority  integer default 0
+);
+CREATE INDEX IF NOT EXISTS category_rules_priority_index on category_rules (priority desc);
+
+CREATE TABLE IF NOT EXISTS transaction_category_rules
+(
+    id             integer not null
+        constraint transaction_category_rules_id_pk primary key autoincrement,
+    transaction_id integer not null,
+    rule_id        integer not null,
+    category       varchar not null default '',
+    UNIQUE (transaction_id),
+    FOREIGN KEY (transaction_id) REFERENCES transactions (id)
+);
+CREATE INDEX IF NOT EXISTS transaction_category_rules_rule_id_index on transaction_category_rules (rule_id asc);
+
+CREATE TABLE IF NOT EXISTS category_rule_runs
+(
+    id                  integer not null
+        constraint category_rule_runs_id_pk primary key autoincrement,
+    fingerprint         varchar not null,
+    last_transaction_id integer default 0,
+    UNIQUE (fingerprint)
+);
+
+CREATE TABLE IF NOT EXISTS account_coverage
+(
+    id         integer not null
+        constraint account_coverage_id_pk primary key autoincrement,
+    account_id unsigned integer not null,
+    from_date  date not null,
+    to_date    date not null
+);
+CREATE INDEX IF NOT EXISTS account_coverage_account_id_index on account_coverage (account_id asc, from_date asc);
+
 CREATE TABLE IF NOT EXISTS migrations
 (
     id         integer not null
@@ -211,4 +279,9 @@ VALUES ('contacts'),
        ('categories'),
        ('accounts'),
        ('transaction_categories'),
-       ('transactions');
+       ('transactions'),
+       ('remote_accounts'),
+       ('category_rules'),
+       ('transaction_category_rules'),
+       ('category_rule_runs'),
+       ('account_coverage');
@@ -0,0 +1,147 @@
+/**
+* Copyright (c) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtWidgets/QMessageBox>
+#include <QtWidgets/QSpinBox>
+
+#include "CsvProfileDialog.h"
+
+using namespace olbaflinx::core::statement;
+using namespace olbaflinx::app::assistant;
+
+namespace {
+
+QStringList splitList(const QString &text)
+{
+    QStringList items = {};
+    for (const auto &item : text.split(',', Qt::SkipEmptyParts)) {
+        if (!item.trimmed().isEmpty()) {
+            items << item.trimmed();
+        }
+    }
+    return items;
+}
+
+} // namespace
+
+CsvProfileDialog::CsvProfileDialog(const CsvProfile &profile, QWidget *parent)
+    : QDialog(parent)
+    , m_columns({})
+{
+    setupUi(this);
+
+    cbxEncoding->addItems({"UTF-8", "ISO-8859-1", "ISO-8859-15", "Windows-1252"});
+
+    // In the order of `CsvProfile::SignConvention`
+    cbxSignConvention->addItems({tr("The amount carries the sign"),
+                                 tr("The amount carries the inverted sign"),
+                                 tr("Credits and debits in columns of their own"),
+                                 tr("Unsigned amount and a debit / credit column")});
+
+    // In the order of `CsvProfile::Field`
+    const QStringList fieldNames = {tr("Booking date"),
+                                    tr("Valuta date"),
+                                    tr("Amount / credit"),
+                                    tr("Debit"),
+                                    tr("Debit / credit"),
+                                    tr("Currency"),
+                                    tr("Own IBAN"),
+                                    tr("Remote name"),
+                                    tr("Remote IBAN"),
+                                    tr("Remote BIC"),
+                                    tr("Purpose"),
+                                    tr("Transaction text"),
+                                    tr("Customer reference"),
+                                    tr("Bank reference"),
+                                    tr("End-to-end reference"),
+                                    tr("Mandate id"),
+                                    tr("Creditor id")};
+
+    for (int field = 0; field < CsvProfile::FieldCount; ++field) {
+        const auto column = new QSpinBox(gbCsvColumns);
+        column->setRange(0, 255);
+        column->setSpecialValueText(tr("Not in the file"));
+        column->setValue(profile.column((CsvProfile::Field) field) + 1);
+        flCsvColumns->addRow(fieldNames.at(field), column);
+        m_columns << column;
+    }
+
+    leProfileName->setText(profile.name);
+    cbxEncoding->setCurrentText(profile.encoding);
+    leDelimiter->setText(QString(QLatin1Char(profile.delimiter)));
+    leQuote->setText(QString(QLatin1Char(profile.quote)));
+    sbSkipLines->setValue(profile.skipLines);
+    chkHasHeader->setChecked(profile.hasHeader);
+    leDateFormats->setText(profile.dateFormats.join(", "));
+    chkDecimalComma->setChecked(profile.isDecimalComma);
+    cbxSignConvention->setCurrentIndex(profile.signConvention);
+    leDebitIndicators->setText(profile.debitIndicators.join(", "));
+    leCurrency->setText(profile.currency);
+}
+
+CsvProfileDialog::~CsvProfileDialog() = default;
+
+CsvProfile CsvProfileDialog::profile() const
+{
+    CsvProfile profile;
+    profile.name = leProfileName->text().trimmed();
+    profile.encoding = cbxEncoding->currentText().trimmed();
+    profile.skipLines = sbSkipLines->value();
+    profile.hasHeader = chkHasHeader->isChecked();
+    profile.dateFormats = splitList(leDateFormats->text());
+    profile.isDecimalComma = chkDecimalComma->isChecked();
+    profile.signConvention = (CsvProfile::SignConvention) cbxSignConvention->currentIndex();
+    profile.debitIndicators = splitList(leDebitIndicators->text());
+    profile.currency = leCurrency->text().trimmed().toUpper();
+
+    if (leDelimiter->text().size() == 1) {
+        profile.delimiter = leDelimiter->text().at(0).toLatin1();
+    }
+    if (leQuote->text().size() == 1) {
+        profile.quote = leQuote->text().at(0).toLatin1();
+    }
+
+    for (int field = 0; field < CsvProfile::FieldCount; ++field) {
+        profile.setColumn((CsvProfile::Field) field, m_columns.at(field)->value() - 1);
+    }
+
+    return profile;
+}
+
+void CsvProfileDialog::accept()
+{
+    const auto csvProfile = profile();
+
+    if (csvProfile.name.isEmpty()) {
+        QMessageBox::critical(this,
+                              tr("CSV Column Mapping"),
+                              tr("The name of the profile can not be empty."));
+        return;
+    }
+
+    if (!csvProfile.isValid()) {
+        QMessageBox::critical(this,
+                              tr("CSV Column Mapping"),
+                              tr("The date and amount columns (and the debit or debit / credit "
+                                 "column the sign needs) must be mapped. The encoding must be "
+                                 "known, delimiter and quote must differ and at least one date "
+                                 "format is needed."));
+        return;
+    }
+
+    QDialog::accept();
+}
@@ -0,0 +1,54 @@
+/**
+* Copyright (c) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_CSVPROFILEDIALOG_H
+#define OLBAFLINX_CSVPROFILEDIALOG_H
+
+#include <QtWidgets/QDialog>
+
+#include "core/Statement/CsvProfile.h"
+#include "ui_CsvProfileDialog.h"
+
+class QSpinBox;
+
+namespace olbaflinx::app::assistant {
+
+/**
+ * Edits the column mapping and the format of a CSV profile. The columns are
+ * shown one based, zero means the file doesn't have the field.
+ */
+class CsvProfileDialog : public QDialog, private Ui::UiCsvProfileDialog
+{
+    Q_OBJECT
+
+public:
+    explicit CsvProfileDialog(const core::statement::CsvProfile &profile,
+                              QWidget *parent = nullptr);
+    ~CsvProfileDialog() override;
+
+    [[nodiscard]] core::statement::CsvProfile profile() const;
+
+public Q_SLOTS:
+    void accept() override;
+
+private:
+    QVector<QSpinBox *> m_columns;
+};
+
+} // namespace olbaflinx::app::assistant
+
+#endif //OLBAFLINX_CSVPROFILEDIALOG_H
@@ -17,33 +17,47 @@
 
 #include <QtCore/QDir>
 #include <QtCore/QFile>
+#include <QtCore/QFileInfo>
 #include <QtCore/QMetaType>
+#include <QtCore/QTime>
 
 #include <QtWidgets/QComboBox>
+#include <QtWidgets/QDateEdit>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
 #include <QtWidgets/QWizardPage>
 
 #include "core/Banking/OnlineBanking.h"
+#include "core/Banking/StatementExporter.h"
+#include "core/Banking/StatementImporter.h"
+#include "core/Statement/CsvProfile.h"
+#include "core/Statement/StatementWriter.h"
 #include "core/Storage/VaultStorage.h"
 
+#include "CsvProfileDialog.h"
 #include "ImExportAssistant.h"
 
 using namespace olbaflinx::core;
 using namespace olbaflinx::core::storage;
+using namespace olbaflinx::core::storage::transaction;
 using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::statement;
 using namespace olbaflinx::app::assistant;
 
 ImExportAssistant::ImExportAssistant(QWidget *parent)
     : QWizard(parent)
     , m_imExportProfileList({})
+    , m_csvImporter(Q_NULLPTR)
     , m_metaTypeIds({})
+    , m_cancellationToken()
+    , m_isRunning(false)
 {
     setupUi(this);
     setWizardStyle(QWizard::ModernStyle);
 
     pbImExportProgress->setVisible(false);
     pbIntroductionProgress->setVisible(false);
+    tbImExportProfileEdit->setVisible(false);
 
     connect(cbxImExportProfile,
             QOverload<int>::of(&QComboBox::currentIndexChanged),
@@ -56,10 +70,30 @@ ImExportAssistant::ImExportAssistant(QWidget *parent)
             &ImExportAssistant::comboboxIndexChanged);
 
     connect(tbImExportFile, &QToolButton::clicked, this, &ImExportAssistant::openImExportFile);
-    connect(VaultStorage::instance(),
-            &VaultStorage::progress,
+    connect(tbImExportProfileEdit,
+            &QToolButton::clicked,
+            this,
+            &ImExportAssistant::editCsvProfile);
+    connect(tbImExportDirectory,
+            &QToolButton::clicked,
+            this,
+            &ImExportAssistant::openImExportDirectory);
+    connect(StatementImporter::instance(),
+            &StatementImporter::progress,
             this,
             &ImExportAssistant::imExportProgress);
+    connect(StatementImporter::instance(),
+            &StatementImporter::progressChanged,
+            this,
+            &ImExportAssistant::imExportProgressChanged);
+    connect(StatementExporter::instance(),
+            &StatementExporter::progress,
+            this,
+            &ImExportAssistant::imExportProgress);
+    connect(StatementExporter::instance(),
+            &StatementExporter::progressChanged,
+            this,
+            &ImExportAssistant::imExportProgressChanged);
 
     connect(OnlineBanking::instance(),
             &OnlineBanking::progress,
@@ -80,6 +114,31 @@ bool ImExportAssistant::validateCurrentPage()
     cbxImExportProfile->clear();
 
     m_imExportProfileList = OnlineBanking::instance()->importExportProfiles(isImportChecked);
+
+    // CSV column mappings are imported without aqbanking, the one of the own
+    // CSV export is always there
+    m_csvImporter = Q_NULLPTR;
+    if (isImportChecked) {
+        m_csvImporter = new ImExportProfile();
+        m_csvImporter->name = CsvImExporterName;
+        m_csvImporter->type = "csv";
+        m_csvImporter->profiles = csvProfiles();
+        m_imExportProfileList << m_csvImporter;
+    }
+
+    // The native exporters stream the vault without aqbanking
+    if (!isImportChecked) {
+        for (const auto &exporterName : StatementWriter::exporterNames()) {
+            auto exporter = new ImExportProfile();
+            exporter->name = exporterName;
+            auto exporterProfile = new ImExportProfileData();
+            exporterProfile->name = "Default";
+            exporterProfile->longDescr = tr("All transactions of the period, account by account");
+            exporterProfile->exp = 1;
+            exporter->profiles << exporterProfile;
+            m_imExportProfileList << exporter;
+        }
+    }
     for (const auto profile : qAsConst(m_imExportProfileList)) {
         cbxImExportPlugin->addItem(profile->name, QVariant::fromValue(profile->profiles));
     }
@@ -99,6 +158,7 @@ bool ImExportAssistant::validateCurrentPage()
             pbIntroductionProgress->setFormat(tr("Loading export profiles ... %p%"));
             pbImExportProgress->setFormat(tr("Export transactions ... %p%"));
         }
+        setExportOptions(!isImportChecked);
 
         return rbIntroductionImport->isChecked() || rbIntroductionExport->isChecked();
     }
@@ -116,6 +176,12 @@ void ImExportAssistant::setAccounts(const AccountList &accounts)
 void ImExportAssistant::done(int result)
 {
     if (result == QWizard::Rejected) {
+        if (m_isRunning) {
+            // The running im- / export stops after its current batch and closes the assistant
+            m_cancellationToken.cancel();
+            return;
+        }
+
         QWizard::done(result);
         return;
     }
@@ -130,23 +196,99 @@ void ImExportAssistant::done(int result)
         return;
     }
 
-    QFile f(leImExportFile->text());
-    if (!f.exists()) {
+    const auto imExporterName = cbxImExportPlugin->currentText();
+    const auto imExporterProfile = cbxImExportProfile->currentText();
+
+    if (!isImportChecked) {
+        m_cancellationToken = CancellationToken();
+        m_isRunning = true;
+        const int count = StatementExporter::instance()->exportTransactions(
+            exportFilter(),
+            imExporterName,
+            imExporterProfile,
+            leImExportFile->text().trimmed(),
+            m_cancellationToken);
+        m_isRunning = false;
+
+        if (count < 0 && !m_cancellationToken.isCancelled()) {
+            QMessageBox::critical(
+                this,
+                tr("Im- / Export Assistant"),
+                tr("Transactions could not be exported with the specified exporter!"));
+            return;
+        }
+
+        // A cancelled export leaves the previous file untouched
+        finish(result);
+        return;
+    }
+
+    const QStringList fileNames = imExportFileNames();
+    for (const auto &fileName : fileNames) {
+        if (!QFile::exists(fileName)) {
+            QMessageBox::critical(this,
+                                  tr("Im- / Export Assistant"),
+                                  tr("The selected file for %1 does not exist anymore!")
+                                      .arg(isImportChecked ? tr("import") : tr("export")));
+            return;
+        }
+    }
+
+    if (fileNames.isEmpty()) {
         QMessageBox::critical(this,
                               tr("Im- / Export Assistant"),
-                              tr("The selected file for %1 does not exist anymore!")
-                                  .arg(isImportChecked ? tr("import") : tr("export")));
+                              tr("The selected directory does not contain any files!"));
         return;
     }
 
-    const auto imExporterName = cbxImExportPlugin->currentText();
-    const auto imExporterProfile = cbxImExportProfile->currentText();
+    m_cancellationToken = CancellationToken();
+    m_isRunning = true;
 
-    auto transactions = OnlineBanking::instance()->importTransactionsFromFile(imExporterName,
-                                                                              imExporterProfile,
-                                                                              leImExportFile->text());
+    const int accountId = cbxIntroductionAccounts->itemData(cbxIntroductionAccounts->currentIndex())
+                              .toInt();
+
+    const auto importer = StatementImporter::instance();
+
+    int count = 0;
+    if (imExporterName == CsvImExporterName) {
+        // Each file is converted on several threads already
+        const auto csvProfile = CsvProfile::load(imExporterProfile);
+        for (const auto &fileName : fileNames) {
+            const int fileCount = importer->importCsv(accountId,
+                                                      csvProfile,
+                                                      fileName,
+                                                      m_cancellationToken);
+            if (fileCount < 0) {
+                count = -1;
+                break;
+            }
+
+            count += fileCount;
+            if (m_cancellationToken.isCancelled()) {
+                break;
+            }
+        }
+    } else if (fileNames.size() == 1) {
+        // Read and stored batch by batch
+        count = importer->import(accountId,
+                                 imExporterName,
+                                 imExporterProfile,
+                                 fileNames.first(),
+                                 m_cancellationToken);
+    } else {
+        const auto report = importer->importFiles(accountId,
+                                                  imExporterName,
+                                                  imExporterProfile,
+                                                  fileNames,
+                                                  m_cancellationToken);
+        count = report.found;
+        if (count > 0 && !m_cancellationToken.isCancelled()) {
+            showImportReport(report);
+        }
+    }
+    m_isRunning = false;
 
-    if (transactions.isEmpty()) {
+    if (count <= 0 && !m_cancellationToken.isCancelled()) {
         QMessageBox::critical(
             this,
             tr("Im- / Export Assistant"),
@@ -154,25 +296,25 @@ void ImExportAssistant::done(int result)
         return;
     }
 
-    const int accountId = cbxIntroductionAccounts->itemData(cbxIntroductionAccounts->currentIndex())
-                              .toInt();
-    VaultStorage::instance()->addTransactions(accountId, transactions);
-
-    qDeleteAll(transactions);
-    transactions.clear();
+    // Batches stored before a cancellation are kept
+    finish(result);
+}
 
+void ImExportAssistant::finish(int result)
+{
     for (const auto profile : qAsConst(m_imExportProfileList)) {
         qDeleteAll(profile->profiles);
     }
     qDeleteAll(m_imExportProfileList);
     m_imExportProfileList.clear();
+    m_csvImporter = Q_NULLPTR;
 
     for (const int type : qAsConst(m_metaTypeIds)) {
         QMetaType::unregisterType(type);
     }
     m_metaTypeIds.clear();
 
-    QWizard::done(result);
+    QWizard::done(m_cancellationToken.isCancelled() ? QWizard::Rejected : result);
 }
 
 void ImExportAssistant::initializePage(int id)
@@ -193,6 +335,9 @@ void ImExportAssistant::comboboxIndexChanged(int index)
     }
 
     if (cbx->objectName() == "cbxImExportPlugin") {
+        tbImExportProfileEdit->setVisible(isImport()
+                                          && cbx->itemText(index) == CsvImExporterName);
+
         cbxImExportProfile->clear();
         const auto profiles = qvariant_cast<ImExportProfileDataList>(cbx->itemData(index));
         for (const auto profile : profiles) {
@@ -210,17 +355,44 @@ void ImExportAssistant::comboboxIndexChanged(int index)
 
 void ImExportAssistant::openImExportFile()
 {
-    const auto fileName = QFileDialog::getOpenFileName(
+    if (!isImport()) {
+        const auto fileName = QFileDialog::getSaveFileName(
+            this,
+            tr("Im- / Export Assistant"),
+            QDir::homePath(),
+            tr("All Files (*.*);;CSV Files (*.csv);;JSON Lines Files (*.jsonl);;OFX Files "
+               "(*.ofx);;XML Files (*.xml);;SWIFT Files (*.sta)"));
+
+        if (!fileName.isEmpty()) {
+            leImExportFile->setText(fileName);
+        }
+        return;
+    }
+
+    const auto fileNames = QFileDialog::getOpenFileNames(
         this,
         tr("Im- / Export Assistant"),
         QDir::homePath(),
-        tr("All Files (*.*);;All Supported Files (*.xml *.sta *.ofx *.q43 *.ctx);;XML Files "
-           "(*.xml);;SWIFT Files (*.sta);;OFX Files (*.ofx);;Q43 Files (*.q43);;CTX Files (*.ctx)"),
+        tr("All Files (*.*);;All Supported Files (*.xml *.sta *.ofx *.q43 *.ctx *.csv);;XML Files "
+           "(*.xml);;SWIFT Files (*.sta);;OFX Files (*.ofx);;Q43 Files (*.q43);;CTX Files "
+           "(*.ctx);;CSV Files (*.csv)"),
         nullptr,
         QFileDialog::ReadOnly);
 
-    if (!fileName.isEmpty()) {
-        leImExportFile->setText(fileName);
+    if (!fileNames.isEmpty()) {
+        leImExportFile->setText(fileNames.join(";"));
+    }
+}
+
+void ImExportAssistant::openImExportDirectory()
+{
+    const auto directory = QFileDialog::getExistingDirectory(this,
+                                                             tr("Im- / Export Assistant"),
+                                                             QDir::homePath(),
+                                                             QFileDialog::ShowDirsOnly);
+
+    if (!directory.isEmpty()) {
+        leImExportFile->setText(directory);
     }
 }
 
@@ -233,6 +405,20 @@ void ImExportAssistant::imExportProgress(qreal progress)
     pbImExportProgress->setValue((int) progress);
 }
 
+void ImExportAssistant::imExportProgressChanged(const ProgressState &state)
+{
+    QString remaining = tr("unknown");
+    if (state.remaining >= 0) {
+        remaining = QTime(0, 0).addMSecs((int) state.remaining).toString("hh:mm:ss");
+    }
+
+    pbImExportProgress->setToolTip(tr("%1 of %2 (%3 per second), remaining %4")
+                                       .arg(state.processed)
+                                       .arg(state.total)
+                                       .arg(qRound(state.throughput))
+                                       .arg(remaining));
+}
+
 void ImExportAssistant::profileLoadingProgress(qreal progress)
 {
     if (!pbIntroductionProgress->isVisible()) {
@@ -242,7 +428,151 @@ void ImExportAssistant::profileLoadingProgress(qreal progress)
     pbIntroductionProgress->setValue((int) progress);
 }
 
+void ImExportAssistant::editCsvProfile()
+{
+    if (m_csvImporter == Q_NULLPTR) {
+        return;
+    }
+
+    CsvProfileDialog dialog(CsvProfile::load(cbxImExportProfile->currentText()), this);
+    if (dialog.exec() != QDialog::Accepted) {
+        return;
+    }
+
+    const auto csvProfile = dialog.profile();
+    CsvProfile::save(csvProfile);
+
+    // The profile list of the CSV importer gets the saved profile, selected
+    cbxImExportProfile->clear();
+    qDeleteAll(m_csvImporter->profiles);
+    m_csvImporter->profiles = csvProfiles();
+    cbxImExportPlugin->setItemData(cbxImExportPlugin->currentIndex(),
+                                   QVariant::fromValue(m_csvImporter->profiles));
+
+    for (const auto profile : qAsConst(m_csvImporter->profiles)) {
+        cbxImExportProfile->addItem(profile->name, QVariant::fromValue(profile));
+    }
+    cbxImExportProfile->setCurrentIndex(cbxImExportProfile->findText(csvProfile.name));
+}
+
+void ImExportAssistant::showImportReport(const StatementImportReport &report)
+{
+    QStringList lines = {};
+    for (const auto &fileReport : report.files) {
+        const QString fileName = QFileInfo(fileReport.fileName).fileName();
+        if (!fileReport.success) {
+            lines << tr("%1: could not be imported").arg(fileName);
+            continue;
+        }
+
+        lines << tr("%1: %2 found, %3 new, %4 duplicates")
+                     .arg(fileName)
+                     .arg(fileReport.found)
+                     .arg(fileReport.inserted)
+                     .arg(fileReport.duplicates);
+    }
+
+    lines << QString();
+    lines << tr("%1 transactions found, %2 new, %3 duplicates in %4 s (%5 per second)")
+                 .arg(report.found)
+                 .arg(report.inserted)
+                 .arg(report.duplicates)
+                 .arg(report.elapsed / 1000.0, 0, 'f', 1)
+                 .arg(qRound(report.throughput));
+
+    QMessageBox::information(this, tr("Im- / Export Assistant"), lines.join("\n"));
+}
+
+QStringList ImExportAssistant::imExportFileNames() const
+{
+    QStringList fileNames = {};
+
+    // Several files are separated by semicolons, a directory stands for its files
+    const auto entries = leImExportFile->text().split(';', Qt::SkipEmptyParts);
+    for (const auto &entry : entries) {
+        const QString path = entry.trimmed();
+        if (QFileInfo(path).isDir()) {
+            fileNames << StatementImporter::statementFiles(path);
+        } else if (!path.isEmpty()) {
+            fileNames << path;
+        }
+    }
+
+    return fileNames;
+}
+
+void ImExportAssistant::setExportOptions(const bool isExport)
+{
+    lblImExportPeriod->setVisible(isExport);
+    deImExportFrom->setVisible(isExport);
+    lblImExportPeriodTo->setVisible(isExport);
+    deImExportTo->setVisible(isExport);
+    lblImExportCategory->setVisible(isExport);
+    cbxImExportCategory->setVisible(isExport);
+    tbImExportDirectory->setVisible(!isExport);
+
+    if (!isExport) {
+        return;
+    }
+
+    // The lowest date stands for the first transaction of the vault
+    deImExportFrom->setMinimumDate(QDate(1900, 1, 1));
+    deImExportFrom->setSpecialValueText(tr("First transaction"));
+    deImExportFrom->setDate(deImExportFrom->minimumDate());
+    deImExportTo->setDate(QDate::currentDate());
+
+    QStringList categories = {};
+    const auto rules = VaultStorage::instance()->categoryRules();
+    for (const auto &rule : rules) {
+        if (!rule.category.isEmpty() && !categories.contains(rule.category)) {
+            categories << rule.category;
+        }
+    }
+    categories.sort(Qt::CaseInsensitive);
+
+    cbxImExportCategory->clear();
+    cbxImExportCategory->addItem(tr("All categories"));
+    for (const auto &category : qAsConst(categories)) {
+        cbxImExportCategory->addItem(category, category);
+    }
+}
+
+TransactionQuery ImExportAssistant::exportFilter() const
+{
+    // Standing orders aren't part of a statement
+    TransactionQuery filter = TransactionQuery::statements(
+        cbxIntroductionAccounts->itemData(cbxIntroductionAccounts->currentIndex()).toUInt());
+
+    if (deImExportFrom->date() > deImExportFrom->minimumDate()) {
+        filter.fromDate = deImExportFrom->date();
+    }
+    filter.toDate = deImExportTo->date();
+
+    const auto category = cbxImExportCategory->currentData().toString();
+    if (!category.isEmpty()) {
+        filter.categories = QStringList({category});
+    }
+
+    return filter;
+}
+
 bool ImExportAssistant::isImport() const
 {
     return rbIntroductionImport->isChecked() && !rbIntroductionExport->isChecked();
 }
+
+ImExportProfileDataList ImExportAssistant::csvProfiles() const
+{
+    ImExportProfileDataList profiles = {};
+    for (const auto &csvProfileName : CsvProfile::profileNames()) {
+        auto csvProfile = new ImExportProfileData();
+        csvProfile->name = csvProfileName;
+        csvProfile->longDescr = csvProfileName == CsvImExporterName
+                                    ? tr("CSV file exported by OlbaFlinx")
+                                    : tr("CSV file with the saved column mapping %1")
+                                          .arg(csvProfileName);
+        csvProfile->import = 1;
+        profiles << csvProfile;
+    }
+    return profiles;
+}
@@ -19,12 +19,17 @@
 
 #include <QtWidgets/QWizard>
 
+#include "core/Banking/StatementImporter.h"
 #include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
 #include "ui_ImExportAssistant.h"
 
 namespace olbaflinx::app::assistant {
 
 using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
 
 class ImExportAssistant : public QWizard, private Ui::UiImExportAssistant
 {
@@ -50,14 +55,26 @@ protected:
 private Q_SLOTS:
     void comboboxIndexChanged(int index);
     void openImExportFile();
+    void openImExportDirectory();
     void imExportProgress(qreal progress);
+    void imExportProgressChanged(const ProgressState &state);
     void profileLoadingProgress(qreal progress);
+    void editCsvProfile();
 
 private:
     ImExportProfileList m_imExportProfileList;
+    ImExportProfile *m_csvImporter;
     QVector<int> m_metaTypeIds;
+    CancellationToken m_cancellationToken;
+    bool m_isRunning;
 
     bool isImport() const;
+    void finish(int result);
+    void setExportOptions(const bool isExport);
+    storage::transaction::TransactionQuery exportFilter() const;
+    QStringList imExportFileNames() const;
+    void showImportReport(const banking::StatementImportReport &report);
+    ImExportProfileDataList csvProfiles() const;
 };
 
 } // namespace olbaflinx::app::assistant
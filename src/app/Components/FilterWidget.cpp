@@ -30,9 +30,16 @@ using namespace olbaflinx::app::components;
 FilterWidget::FilterWidget(QWidget *parent, Qt::WindowFlags f)
     : QWidget(parent, f)
     , mUseSearchTextAsRegEx(false)
+    , mSearchTimer(new QTimer(this))
+    , mSearchText("")
 {
     setupUi(this);
 
+    // Only the text the user stopped at is searched, not every keystroke
+    mSearchTimer->setSingleShot(true);
+    mSearchTimer->setInterval(SearchDebounceInterval);
+    connect(mSearchTimer, &QTimer::timeout, this, &FilterWidget::emitSearchText);
+
     const auto dateFormat = QLocale::system().dateFormat(QLocale::NarrowFormat);
 
     dateEditFrom->setDisplayFormat(dateFormat);
@@ -123,6 +130,21 @@ void FilterWidget::slotDateEditChanged(const QDate &dateEdit)
 
 void FilterWidget::slotSearchTextChanged(const QString &searchText)
 {
+    mSearchText = searchText;
+
+    // Clearing the search should show all transactions right away
+    if (mSearchText.isEmpty()) {
+        mSearchTimer->stop();
+        emitSearchText();
+        return;
+    }
+
+    mSearchTimer->start();
+}
+
+void FilterWidget::emitSearchText()
+{
+    const QString searchText = mSearchText;
     if (mUseSearchTextAsRegEx) {
         QRegExp regExp(QRegExp::escape(searchText));
         if (regExp.isValid()) {
@@ -17,6 +17,7 @@
 #ifndef OLBAFLINX_FILTERWIDGET_H
 #define OLBAFLINX_FILTERWIDGET_H
 
+#include <QTimer>
 #include <QWidget>
 
 #include "ui_FilterWidget.h"
@@ -48,6 +49,11 @@ public Q_SLOTS:
 
 private:
     bool mUseSearchTextAsRegEx;
+    QTimer *mSearchTimer;
+    QString mSearchText;
+
+private Q_SLOTS:
+    void emitSearchText();
 };
 
 } // namespace olbaflinx::app::components
@@ -0,0 +1,181 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QtMath>
+#include <QtGui/QPainter>
+#include <QtWidgets/QApplication>
+
+#include "TransactionItemDelegate.h"
+
+using namespace olbaflinx::app::components;
+
+#define DelegateCacheSize 8192
+#define DelegatePadding 4
+#define DelegateChipRadius 6
+
+TransactionItemDelegate::TransactionItemDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+    , m_elidedTexts(DelegateCacheSize)
+{ }
+
+TransactionItemDelegate::~TransactionItemDelegate() = default;
+
+void TransactionItemDelegate::paint(QPainter *painter,
+                                    const QStyleOptionViewItem &option,
+                                    const QModelIndex &index) const
+{
+    const auto model = qobject_cast<const TransactionViewModel *>(index.model());
+    if (model == Q_NULLPTR) {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    const QWidget *widget = option.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+    style->drawPrimitive(QStyle::PE_PanelItemViewItem, &option, painter, widget);
+
+    // Page still loading, the model repaints when it arrives
+    const auto row = model->transactionRow(index);
+    if (row == Q_NULLPTR) {
+        return;
+    }
+
+    const bool isSelected = option.state.testFlag(QStyle::State_Selected);
+    const QRect rect = option.rect.adjusted(DelegatePadding, 0, -DelegatePadding, 0);
+
+    painter->save();
+    painter->setFont(option.font);
+    painter->setPen(option.palette.color(isSelected ? QPalette::HighlightedText : QPalette::Text));
+
+    const int top = rect.top() + (rect.height() - option.fontMetrics.height()) / 2;
+    const int column = index.column();
+    const int width = rect.width();
+
+    switch (column) {
+    case TransactionViewModel::ColumnValutaDate:
+        painter->drawStaticText(rect.left(),
+                                top,
+                                elidedText(row, column, row->displayDate, option.font, width));
+        break;
+    case TransactionViewModel::ColumnRemoteName:
+        painter->drawStaticText(rect.left(),
+                                top,
+                                elidedText(row, column, row->remoteName, option.font, width));
+        break;
+    case TransactionViewModel::ColumnPurpose:
+        painter->drawStaticText(rect.left(),
+                                top,
+                                elidedText(row, column, row->purpose, option.font, width));
+        break;
+    case TransactionViewModel::ColumnCategory:
+        paintCategory(painter, option, row, rect);
+        break;
+    case TransactionViewModel::ColumnValue: {
+        if (!isSelected && row->isNegative()) {
+            painter->setPen(Qt::red);
+        }
+
+        const auto &text = elidedText(row, column, row->displayValue, option.font, width);
+        painter->drawStaticText(rect.right() - qCeil(text.size().width()), top, text);
+        break;
+    }
+    default:
+        break;
+    }
+
+    painter->restore();
+}
+
+QSize TransactionItemDelegate::sizeHint(const QStyleOptionViewItem &option,
+                                        const QModelIndex &index) const
+{
+    Q_UNUSED(index)
+
+    // Uniform rows, the chip of the category needs a little more space
+    return {option.rect.width(), option.fontMetrics.height() + 3 * DelegatePadding};
+}
+
+void TransactionItemDelegate::clearCache()
+{
+    m_elidedTexts.clear();
+}
+
+const QStaticText &TransactionItemDelegate::elidedText(const TransactionRow *row,
+                                                       const int column,
+                                                       const QString &text,
+                                                       const QFont &font,
+                                                       const int width) const
+{
+    const quint64 key = (quint64(row->id) << 3) | quint64(column);
+
+    ElidedText *cached = m_elidedTexts.object(key);
+    if (cached == Q_NULLPTR || cached->width != width || cached->source != text
+        || cached->font != font) {
+        // Purposes may span several lines, a cell shows only one
+        const QString singleLine = QString(text).replace('\n', ' ');
+        const QString elided = QFontMetrics(font).elidedText(singleLine, Qt::ElideRight, width);
+
+        cached = new ElidedText();
+        cached->width = width;
+        cached->source = text;
+        cached->font = font;
+        cached->text.setText(elided);
+        cached->text.setTextFormat(Qt::PlainText);
+        cached->text.setPerformanceHint(QStaticText::AggressiveCaching);
+        cached->text.prepare(QTransform(), font);
+        m_elidedTexts.insert(key, cached);
+    }
+
+    return cached->text;
+}
+
+void TransactionItemDelegate::paintCategory(QPainter *painter,
+                                            const QStyleOptionViewItem &option,
+                                            const TransactionRow *row,
+                                            const QRect &rect) const
+{
+    if (row->category.isEmpty()) {
+        return;
+    }
+
+    const auto &text = elidedText(row,
+                                  TransactionViewModel::ColumnCategory,
+                                  row->category,
+                                  option.font,
+                                  rect.width() - 2 * DelegateChipRadius);
+
+    const QSizeF textSize = text.size();
+    const QRectF chip(rect.left(),
+                      rect.top() + (rect.height() - textSize.height()) / 2 - 1,
+                      textSize.width() + 2 * DelegateChipRadius,
+                      textSize.height() + 2);
+
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(categoryColor(row->category));
+    painter->drawRoundedRect(chip, DelegateChipRadius, DelegateChipRadius);
+
+    painter->setPen(Qt::black);
+    painter->drawStaticText(QPointF(chip.left() + DelegateChipRadius, chip.top() + 1), text);
+}
+
+QColor TransactionItemDelegate::categoryColor(const QString &category)
+{
+    // Stable light colour per top level category
+    const QString topLevel = category.section('/', 0, 0);
+    return QColor::fromHsv(int(qHash(topLevel) % 360), 60, 235);
+}
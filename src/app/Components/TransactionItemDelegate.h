@@ -0,0 +1,82 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_TRANSACTIONITEMDELEGATE_H
+#define OLBAFLINX_TRANSACTIONITEMDELEGATE_H
+
+#include <QtCore/QCache>
+#include <QtGui/QFont>
+#include <QtGui/QStaticText>
+#include <QtWidgets/QStyledItemDelegate>
+
+#include "core/Storage/Transaction/TransactionViewModel.h"
+
+namespace olbaflinx::app::components {
+
+using namespace olbaflinx::core::storage::transaction;
+
+/**
+ * Paints the rows of a `TransactionViewModel` straight from its cached row
+ * records instead of asking `data()` for every role. Elided texts are kept as
+ * static texts per row, column and width.
+ */
+class TransactionItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit TransactionItemDelegate(QObject *parent = nullptr);
+    ~TransactionItemDelegate() override;
+
+    void paint(QPainter *painter,
+               const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+
+    void clearCache();
+
+private:
+    /**
+     * The source text and font are kept to notice rows changed in place and
+     * font changes, both keep the key of the entry.
+     */
+    struct ElidedText
+    {
+        int width = 0;
+        QString source = "";
+        QFont font = {};
+        QStaticText text = {};
+    };
+
+    mutable QCache<quint64, ElidedText> m_elidedTexts;
+
+    const QStaticText &elidedText(const TransactionRow *row,
+                                  const int column,
+                                  const QString &text,
+                                  const QFont &font,
+                                  const int width) const;
+    void paintCategory(QPainter *painter,
+                       const QStyleOptionViewItem &option,
+                       const TransactionRow *row,
+                       const QRect &rect) const;
+
+    static QColor categoryColor(const QString &category);
+};
+
+} // namespace olbaflinx::app::components
+
+#endif //OLBAFLINX_TRANSACTIONITEMDELEGATE_H
@@ -15,17 +15,107 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QTextStream>
 #include <QtCore/QTranslator>
 
 #include "app/App.h"
+#include "core/BankData/BankDirectory.h"
 #include "core/Logger/Logger.h"
 #include "core/SingleApplication/SingleApplication.h"
 
 using namespace olbaflinx::app;
+using namespace olbaflinx::core::bankdata;
 using namespace olbaflinx::core::logger;
 
+/**
+ * olbaflinx update-bankdata [-o file] [-e encoding] <file> <valid-date>
+ *
+ * Updates the bank directory from the Bundesbank bank code file without
+ * starting the user interface.
+ */
+int updateBankData(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QCoreApplication::setApplicationName("OlbaFlinx");
+    QCoreApplication::setOrganizationName("de.chm-projects.olbaflinx");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        QCoreApplication::translate("main",
+                                    "Updates the bank directory with the bank code file of the "
+                                    "Deutsche Bundesbank."));
+    parser.addHelpOption();
+    parser.addPositionalArgument("update-bankdata", "", "update-bankdata");
+    parser.addPositionalArgument("file", QCoreApplication::translate("main", "Bank code file"));
+    parser.addPositionalArgument("valid-date",
+                                 QCoreApplication::translate("main",
+                                                             "Date until deletions were valid "
+                                                             "(dd.MM.yyyy)"));
+
+    QCommandLineOption outputOption({"o", "output"},
+                                    QCoreApplication::translate("main",
+                                                                "Bank directory file to update"),
+                                    "file",
+                                    BankDirectory::defaultFilePath());
+    QCommandLineOption encodingOption({"e", "encoding"},
+                                      QCoreApplication::translate("main", "Charset of the file"),
+                                      "encoding",
+                                      BankDataFileEncoding);
+    parser.addOption(outputOption);
+    parser.addOption(encodingOption);
+    parser.process(a);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QStringList arguments = parser.positionalArguments();
+    if (arguments.size() != 3) {
+        parser.showHelp(1);
+    }
+
+    const QDate validDate = QDate::fromString(arguments.at(2), "dd.MM.yyyy");
+    if (!validDate.isValid()) {
+        err << QCoreApplication::translate("main", "Invalid date: %1").arg(arguments.at(2))
+            << Qt::endl;
+        return 1;
+    }
+
+    const auto directory = BankDirectory::instance();
+    if (!directory->open(parser.value(outputOption))) {
+        err << QCoreApplication::translate("main", "Can't open bank directory %1")
+                   .arg(parser.value(outputOption))
+            << Qt::endl;
+        return 1;
+    }
+
+    const auto result = directory->update(arguments.at(1), validDate, parser.value(encodingOption));
+    directory->close();
+
+    if (!result.success) {
+        err << result.errorMessage << Qt::endl;
+        return 1;
+    }
+
+    out << QCoreApplication::translate("main",
+                                       "%1 inserted, %2 updated, %3 deleted, %4 unchanged in %5 ms")
+               .arg(result.inserted)
+               .arg(result.updated)
+               .arg(result.deleted)
+               .arg(result.unchanged)
+               .arg(result.elapsed)
+        << Qt::endl;
+
+    return 0;
+}
+
 int main(int argc, char *argv[])
 {
+    if (argc > 1 && qstrcmp(argv[1], "update-bankdata") == 0) {
+        return updateBankData(argc, argv);
+    }
+
     Logger::instance()->enable();
 
     SingleApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
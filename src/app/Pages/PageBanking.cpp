@@ -64,6 +64,13 @@ void PageBanking::initialize(QMainWindow *mainWindow)
     initializeToolbar();
     initializeStatusBar();
 
+    // Accounts added later (setup, import) are appended to the tree
+    connect(VaultStorage::instance(),
+            &VaultStorage::storageChanged,
+            this,
+            &PageBanking::storageChanged,
+            Qt::UniqueConnection);
+
     m_accounts = VaultStorage::instance()->accounts();
     if (m_accounts.isEmpty()) {
         return;
@@ -77,17 +84,7 @@ void PageBanking::initialize(QMainWindow *mainWindow)
             &PageBanking::accountChanged);
 
     for (const auto account : m_accounts) {
-        auto item = new QTreeWidgetItem();
-
-        const auto accountItem = new AccountItem();
-        accountItem->title = account->toString();
-        accountItem->balance = account->balance();
-        accountItem->id = account->uniqueId();
-
-        item->setText(0, account->toString());
-        item->setData(0, Qt::UserRole, QVariant::fromValue(accountItem));
-
-        app->treeWidgetBankingAccounts->addTopLevelItem(item);
+        addAccountItem(account);
     }
 
     // app->tabTransactions
@@ -139,6 +136,94 @@ void PageBanking::accountChanged()
     items.clear();
 }
 
+void PageBanking::storageChanged(const StorageChange &change)
+{
+    if (change.subject != SubjectAccount) {
+        return;
+    }
+
+    if (!change.updated.isEmpty()) {
+        updateAccountItems(change.updated);
+    }
+
+    if (change.inserted.isEmpty()) {
+        return;
+    }
+
+    const auto app = d_ptr->app();
+    if (m_accounts.isEmpty()) {
+        connect(app->treeWidgetBankingAccounts,
+                &QTreeWidget::itemSelectionChanged,
+                this,
+                &PageBanking::accountChanged,
+                Qt::UniqueConnection);
+    }
+
+    const auto accounts = VaultStorage::instance()->accounts();
+    for (const auto account : accounts) {
+        if (change.inserted.contains(account->uniqueId())) {
+            m_accounts.append(account);
+            addAccountItem(account);
+        } else {
+            delete account;
+        }
+    }
+}
+
+void PageBanking::addAccountItem(const Account *account)
+{
+    auto item = new QTreeWidgetItem();
+
+    const auto accountItem = new AccountItem();
+    accountItem->title = account->toString();
+    accountItem->balance = account->balance();
+    accountItem->id = account->uniqueId();
+
+    item->setText(0, account->toString());
+    item->setData(0, Qt::UserRole, QVariant::fromValue(accountItem));
+
+    d_ptr->app()->treeWidgetBankingAccounts->addTopLevelItem(item);
+}
+
+void PageBanking::updateAccountItems(const QVector<qint64> &accountIds)
+{
+    const auto tree = d_ptr->app()->treeWidgetBankingAccounts;
+
+    const auto accounts = VaultStorage::instance()->accounts();
+    for (const auto account : accounts) {
+        const quint32 accountId = account->uniqueId();
+        if (!accountIds.contains(accountId)) {
+            delete account;
+            continue;
+        }
+
+        // The stored account replaces ours, e.g. with its new balance
+        for (int index = 0; index < m_accounts.size(); ++index) {
+            if (m_accounts.at(index)->uniqueId() == accountId) {
+                delete m_accounts.at(index);
+                m_accounts.replace(index, account);
+                break;
+            }
+        }
+
+        for (int index = 0; index < tree->topLevelItemCount(); ++index) {
+            const auto item = tree->topLevelItem(index);
+            const auto accountItem = item->data(0, Qt::UserRole).value<AccountItem *>();
+            if (accountItem != Q_NULLPTR && accountItem->id == accountId) {
+                accountItem->title = account->toString();
+                accountItem->balance = account->balance();
+                item->setText(0, accountItem->title);
+            }
+        }
+
+        if (!m_accounts.contains(account)) {
+            delete account;
+        }
+    }
+
+    tree->viewport()->update();
+}
+
 void PageBanking::initializeMenuBar() { }
 
 void PageBanking::initializeToolbar()
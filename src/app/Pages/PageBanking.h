@@ -24,10 +24,12 @@
 #include <QtWidgets/QWidget>
 
 #include "core/Container.h"
+#include "core/Storage/StorageChange.h"
 
 namespace olbaflinx::app::pages {
 
 using namespace olbaflinx::core;
+using namespace olbaflinx::core::storage;
 
 class PageBasePrivate;
 class PageBanking : public QWidget
@@ -46,6 +48,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void accountChanged();
+    void storageChanged(const StorageChange &change);
 
 private:
     friend class PageBasePrivate;
@@ -57,6 +60,8 @@ private:
     void initializeMenuBar();
     void initializeToolbar();
     void initializeStatusBar();
+    void addAccountItem(const Account *account);
+    void updateAccountItems(const QVector<qint64> &accountIds);
 };
 
 } // namespace olbaflinx::app::pages
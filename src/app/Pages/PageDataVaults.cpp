@@ -17,19 +17,23 @@
 
 #include <QtConcurrent/QtConcurrent>
 #include <QtCore/QDate>
+#include <QtCore/QFile>
 #include <QtCore/QFileInfo>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QProgressDialog>
 
 #include "app/App.h"
 #include "app/Assistant/SetupAssistant.h"
 #include "app/DataVault/DataVaultDialog.h"
 
 #include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
 #include "core/Storage/VaultStorage.h"
 
 #include "PageBasePrivate.h"
 #include "PageDataVaults.h"
 
+using namespace olbaflinx::core::progress;
 using namespace olbaflinx::core::storage;
 using namespace olbaflinx::app;
 using namespace olbaflinx::app::pages;
@@ -80,6 +84,40 @@ void PageDataVaults::addNewDataVault()
                                           newDataVaultDlg->vaultName());
 
         const auto storagePassword = newDataVaultDlg->vaultPassword();
+
+        qApp->setOverrideCursor(Qt::WaitCursor);
+
+        // The vault is registered only after it was created completely
+        CancellationToken token;
+        QProgressDialog progressDialog(tr("Creating data vault ..."), tr("Cancel"), 0, 0, this);
+        progressDialog.setWindowModality(Qt::WindowModal);
+        progressDialog.setMinimumDuration(0);
+        connect(&progressDialog, &QProgressDialog::canceled, this, [token]() { token.cancel(); });
+
+        QEventLoop loop(this);
+        QFutureWatcher<void> storageWatcher(this);
+        connect(&storageWatcher, &QFutureWatcher<void>::finished, &loop, [&]() {
+            loop.quit();
+            storageWatcher.cancel();
+            storageWatcher.waitForFinished();
+
+            qApp->restoreOverrideCursor();
+        });
+
+        storageWatcher.setFuture(QtConcurrent::run([storageFile, storagePassword, token]() -> void {
+            VaultStorage::instance()->setDatabaseKey(storageFile, storagePassword);
+            VaultStorage::instance()->initialize(true, token);
+            VaultStorage::instance()->close(token);
+        }));
+        loop.exec();
+        progressDialog.reset();
+
+        if (token.isCancelled()) {
+            QFile::remove(storageFile);
+            newDataVaultDlg->deleteLater();
+            return;
+        }
+
         auto storageFiles = VaultStorage::instance()
                                 ->setting(StorageSettingGroupKey, StorageSettingGroup, QStringList())
                                 .toStringList();
@@ -97,25 +135,6 @@ void PageDataVaults::addNewDataVault()
         m_scrollAreaDataVaultsContentsLayout->update();
         d_ptr->app()->scrollAreaDataVaultsContents->update();
         d_ptr->app()->scrollAreaDataVaults->update();
-
-        qApp->setOverrideCursor(Qt::WaitCursor);
-
-        QEventLoop loop(this);
-        QFutureWatcher<void> storageWatcher(this);
-        connect(&storageWatcher, &QFutureWatcher<void>::finished, &loop, [&]() {
-            loop.quit();
-            storageWatcher.cancel();
-            storageWatcher.waitForFinished();
-
-            qApp->restoreOverrideCursor();
-        });
-
-        storageWatcher.setFuture(QtConcurrent::run([storageFile, storagePassword]() -> void {
-            VaultStorage::instance()->setDatabaseKey(storageFile, storagePassword);
-            VaultStorage::instance()->initialize(true);
-            VaultStorage::instance()->close();
-        }));
-        loop.exec();
     }
     newDataVaultDlg->deleteLater();
 }
@@ -15,22 +15,26 @@
 * along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
-#include <QtConcurrent/QtConcurrent>
-#include "core/Storage/VaultStorage.h"
-
 #include "TabBase.h"
 
-using namespace olbaflinx::core::storage;
+using namespace olbaflinx::app::components;
 using namespace olbaflinx::core::storage::transaction;
 using namespace olbaflinx::app::pages::tabs;
 
 TabBase::TabBase(QWidget *parent, const bool isStandingOrderTab)
     : QWidget(parent)
     , m_accountId(0)
+    , m_fromDate()
+    , m_toDate()
     , m_isStandingOrderTab(isStandingOrderTab)
-    , m_transactions({})
 {
     setupUi(this);
+
+    // The date range applies as soon as the user picks one
+    connect(filterWidget, &FilterWidget::dateTimePeriodChanged, this, &TabBase::setDateRange);
+    connect(filterWidget, &FilterWidget::dateChanged, this, [this](const QDate &) {
+        setDateRange(filterWidget->fromDate(), filterWidget->toDate());
+    });
 }
 
 TabBase::~TabBase() = default;
@@ -41,34 +45,23 @@ void TabBase::setAccountId(const quint32 id)
     Q_EMIT accountChanged(m_accountId);
 }
 
-TransactionList TabBase::transactions()
+TransactionQuery TabBase::transactionQuery() const
 {
-    m_transactions = VaultStorage::instance()->transactions(m_accountId);
-    if (m_transactions.isEmpty()) {
-        return {};
-    }
-
-    qApp->setOverrideCursor(Qt::WaitCursor);
-
-    QEventLoop loop(this);
-    QFutureWatcher<TransactionList> transactionWatcher(this);
-    connect(&transactionWatcher, &QFutureWatcher<TransactionList>::finished, &loop, [&]() {
-        loop.quit();
-        transactionWatcher.cancel();
-        transactionWatcher.waitForFinished();
+    auto transactionQuery = m_isStandingOrderTab ? TransactionQuery::standingOrders(m_accountId)
+                                                 : TransactionQuery::statements(m_accountId);
+    transactionQuery.fromDate = m_fromDate;
+    transactionQuery.toDate = m_toDate;
 
-        qApp->restoreOverrideCursor();
-    });
-
-    transactionWatcher.setFuture(QtConcurrent::filteredReduced<TransactionList>(
-        m_transactions,
-        [&](const Transaction *t) -> bool {
-            return m_isStandingOrderTab ? t->isStandingOrder() : !t->isStandingOrder();
-        },
-        [](TransactionList &list, const Transaction *t) { list.append(t); },
-        QtConcurrent::OrderedReduce));
+    return transactionQuery;
+}
 
-    loop.exec();
+void TabBase::setDateRange(const QDate &from, const QDate &to)
+{
+    if (m_fromDate == from && m_toDate == to) {
+        return;
+    }
 
-    return transactionWatcher.result();
+    m_fromDate = from;
+    m_toDate = to;
+    Q_EMIT transactionQueryChanged(transactionQuery());
 }
@@ -21,6 +21,7 @@
 #include <QtWidgets/QWidget>
 
 #include "core/Container.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
 
 #include "ui_TabTransactions.h"
 
@@ -37,16 +38,21 @@ public:
     ~TabBase() override;
 
     void setAccountId(const quint32 id);
-    TransactionList transactions();
+    TransactionQuery transactionQuery() const;
 
     virtual void reset() = 0;
 
 Q_SIGNALS:
     void accountChanged(const quint32 accountId);
+    void transactionQueryChanged(const TransactionQuery &transactionQuery);
+
+public Q_SLOTS:
+    void setDateRange(const QDate &from, const QDate &to);
 
 protected:
     quint32 m_accountId;
-    TransactionList m_transactions;
+    QDate m_fromDate;
+    QDate m_toDate;
 
 private:
     bool m_isStandingOrderTab;
@@ -15,33 +15,76 @@
 * along with this program.  If not, see <https://www.gnu.org/licenses/>.
 */
 
+#include "TransactionItemDelegate.h"
+
 #include "TabTransactions.h"
 
+using namespace olbaflinx::app::components;
 using namespace olbaflinx::app::pages::tabs;
 
 TabTransactions::TabTransactions(QWidget *parent)
     : TabBase(parent, false)
     , m_transactionViewModel(Q_NULLPTR)
+    , m_transactionSearch(Q_NULLPTR)
 {
     m_transactionViewModel = new TransactionViewModel(treeViewTransactions, false);
     treeViewTransactions->setModel(m_transactionViewModel);
     treeViewTransactions->setUniformRowHeights(true);
 
+    const auto itemDelegate = new TransactionItemDelegate(treeViewTransactions);
+    treeViewTransactions->setItemDelegate(itemDelegate);
+    connect(m_transactionViewModel,
+            &TransactionViewModel::modelReset,
+            itemDelegate,
+            &TransactionItemDelegate::clearCache);
+
+    m_transactionSearch = new TransactionSearch(this);
+    connect(filterWidget,
+            &FilterWidget::searchTextChanged,
+            m_transactionSearch,
+            &TransactionSearch::search);
+    connect(m_transactionSearch,
+            &TransactionSearch::searchStarted,
+            m_transactionViewModel,
+            &TransactionViewModel::beginSearchResults);
+    connect(m_transactionSearch,
+            &TransactionSearch::resultsAvailable,
+            m_transactionViewModel,
+            &TransactionViewModel::appendSearchResults);
+    connect(m_transactionSearch,
+            &TransactionSearch::searchCleared,
+            m_transactionViewModel,
+            &TransactionViewModel::endSearchResults);
+
     connect(this, &TabBase::accountChanged, this, &TabTransactions::accountWasChanged);
+    connect(this,
+            &TabBase::transactionQueryChanged,
+            this,
+            &TabTransactions::reloadTransactions);
 }
 
 TabTransactions::~TabTransactions() = default;
 
 void TabTransactions::accountWasChanged(const quint32 accountId)
 {
-    m_transactionViewModel->clear();
+    Q_UNUSED(accountId)
+    reloadTransactions();
+}
+
+void TabTransactions::reloadTransactions()
+{
+    // Keep the sort order the user picked in the view
+    auto query = transactionQuery();
+    query.sortKey = m_transactionViewModel->transactionQuery().sortKey;
+    query.sortOrder = m_transactionViewModel->transactionQuery().sortOrder;
 
-    const auto items = transactions();
-    m_transactionViewModel->setTransactions(accountId, items);
+    m_transactionSearch->setTransactionQuery(query);
+    m_transactionViewModel->setTransactionQuery(query);
 }
 
 void TabTransactions::reset()
 {
+    m_transactionSearch->clear();
     m_transactionViewModel->clear();
     treeViewTransactions->reset();
 }
@@ -18,6 +18,7 @@
 #ifndef OLBAFLINX_TABTRANSACTIONS_H
 #define OLBAFLINX_TABTRANSACTIONS_H
 
+#include "core/Storage/Transaction/TransactionSearch.h"
 #include "core/Storage/Transaction/TransactionViewModel.h"
 
 #include "TabBase.h"
@@ -38,9 +39,11 @@ public:
 
 private:
     TransactionViewModel *m_transactionViewModel;
+    TransactionSearch *m_transactionSearch;
 
 private Q_SLOTS:
     void accountWasChanged(const quint32 accountId);
+    void reloadTransactions();
 };
 
 } // namespace olbaflinx::app::pages::tabs
@@ -0,0 +1,545 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QTextCodec>
+#include <QtCore/QThread>
+#include <QtSql/QSqlError>
+#include <QtSql/QSqlQuery>
+
+#include "core/Storage/Connection/StorageConnection.h"
+
+#include "BankDirectory.h"
+
+using namespace olbaflinx::core::bankdata;
+using namespace olbaflinx::core::storage::connection;
+
+class BankDirectory::Private
+{
+public:
+    struct l10n
+    {
+        static QString BankDirectoryNotOpen()
+        {
+            return tr("The bank directory is not open!");
+        }
+        static QString BankDirectoryFileNotReadable(const QString &fileName)
+        {
+            return tr("The bank code file %1 could not be read!").arg(fileName);
+        }
+        static QString BankDirectoryEncodingUnknown(const QString &encoding)
+        {
+            return tr("The encoding %1 is not supported!").arg(encoding);
+        }
+        static QString BankDirectoryNoRecords()
+        {
+            return tr("The bank code file does not contain any institution!");
+        }
+        static QString BankDirectoryWriteFailed(const QString &message)
+        {
+            return tr("The bank directory could not be updated: %1").arg(message);
+        }
+    };
+
+    /**
+     * One line of the Bundesbank bank code file. The file is fixed width (168
+     * characters), only the columns we store are extracted.
+     */
+    struct Record
+    {
+        QString bankCode = "";
+        QString name = "";
+        QString location = "";
+        QString bic = "";
+        QString method = "";
+        QString successor = "";
+        bool isMain = false;
+        bool isDeleted = false;
+    };
+
+    explicit Private()
+        : m_connections({})
+        , m_retiredConnections({})
+        , m_finishedConnections({})
+        , m_filePath("")
+    { }
+
+    ~Private()
+    {
+        // Only at shutdown, the threads which opened them are gone by then
+        for (const auto &finished : qAsConst(m_finishedConnections)) {
+            QObject::disconnect(finished);
+        }
+        for (const auto connection : qAsConst(m_connections)) {
+            closeConnection(connection);
+        }
+        for (const auto connection : qAsConst(m_retiredConnections)) {
+            closeConnection(connection);
+        }
+    }
+
+    bool open(const QString &fileName)
+    {
+        close();
+
+        m_filePath = fileName;
+
+        const auto directory = connection();
+        if (directory == Q_NULLPTR) {
+            close();
+            return false;
+        }
+
+        QSqlQuery query(directory->database());
+        query.exec(BankDataSqlCreateInstitutionsTable);
+        for (const auto &statement : BankDataSqlCreateInstitutionsIndexes) {
+            query.exec(statement);
+        }
+
+        return true;
+    }
+
+    /**
+     * Closes the connection of the calling thread. The connections of other
+     * threads are retired, each thread closes its own on its next lookup or
+     * once it finishes. Must be called with the mutex locked.
+     */
+    void close()
+    {
+        const auto thread = QThread::currentThread();
+        for (auto it = m_connections.constBegin(); it != m_connections.constEnd(); ++it) {
+            if (it.key() == thread) {
+                closeConnection(it.value());
+            } else {
+                m_retiredConnections.insert(it.key(), it.value());
+            }
+        }
+        m_connections.clear();
+        m_filePath.clear();
+    }
+
+    bool isOpen() const { return !m_filePath.isEmpty(); }
+
+    QString filePath() const { return m_filePath; }
+
+    /**
+     * The connection of the calling thread, opened on first use. A database
+     * connection must only be used by the thread which opened it, lookups
+     * come from the GUI, the vault executor and worker threads. Must be
+     * called with the mutex locked.
+     */
+    StorageConnection *connection()
+    {
+        if (m_filePath.isEmpty()) {
+            return Q_NULLPTR;
+        }
+
+        const auto thread = QThread::currentThread();
+        closeConnection(m_retiredConnections.take(thread));
+
+        auto connection = m_connections.value(thread, Q_NULLPTR);
+        if (connection != Q_NULLPTR) {
+            return connection;
+        }
+
+        connection = new StorageConnection(m_filePath, "QSQLITE");
+        if (!connection->isOpen()) {
+            closeConnection(connection);
+            return Q_NULLPTR;
+        }
+        m_connections.insert(thread, connection);
+
+        // The lookup table is temporary, so each connection has its own
+        QSqlQuery query(connection->database());
+        query.exec(BankDataSqlLookupCreateQuery);
+
+        if (m_finishedConnections.contains(thread)) {
+            return connection;
+        }
+
+        // A finished thread closes its connection itself
+        const auto finished = [this, thread]() {
+            QMutexLocker locker(&m_mutex);
+            m_finishedConnections.remove(thread);
+            closeConnection(m_connections.take(thread));
+            closeConnection(m_retiredConnections.take(thread));
+        };
+        m_finishedConnections.insert(thread,
+                                     QObject::connect(thread,
+                                                      &QThread::finished,
+                                                      thread,
+                                                      finished,
+                                                      Qt::DirectConnection));
+
+        return connection;
+    }
+
+    QMutex *mutex() { return &m_mutex; }
+
+    static void closeConnection(StorageConnection *connection)
+    {
+        if (connection == Q_NULLPTR) {
+            return;
+        }
+
+        connection->close();
+        delete connection;
+    }
+
+    static Institution toInstitution(const QSqlQuery &query)
+    {
+        Institution institution;
+        institution.bankCode = query.value(0).toString();
+        institution.bic = query.value(1).toString().trimmed();
+        institution.method = query.value(2).toString().trimmed();
+        institution.name = query.value(3).toString().trimmed();
+        institution.location = query.value(4).toString().trimmed();
+        institution.isValid = query.value(5).isNull();
+
+        return institution;
+    }
+
+    static bool parseRecord(const QByteArray &line, QTextCodec *codec, Record &record)
+    {
+        if (line.size() < BankDataRecordLength) {
+            return false;
+        }
+
+        const char *data = line.constData();
+        record.isMain = (data[8] == '1');
+        if (!record.isMain) {
+            return true;
+        }
+
+        record.bankCode = QString::fromLatin1(data, 8);
+        record.name = codec->toUnicode(data + 9, 58).trimmed();
+        record.location = codec->toUnicode(data + 72, 35).trimmed();
+        record.bic = QString::fromLatin1(data + 139, 11).trimmed();
+        record.method = QString::fromLatin1(data + 150, 2);
+        record.isDeleted = (data[158] == 'D');
+        record.successor = QString::fromLatin1(data + 160, 8);
+
+        return true;
+    }
+
+    static bool isEqual(const Institution &institution, const Record &record)
+    {
+        return institution.isValid && institution.bic == record.bic
+               && institution.method == record.method && institution.name == record.name
+               && institution.location == record.location;
+    }
+
+    InstitutionMap currentInstitutions()
+    {
+        InstitutionMap institutions = {};
+
+        QSqlQuery query(connection()->database());
+        query.setForwardOnly(true);
+        query.exec(BankDataSqlInstitutionSelectQuery);
+        while (query.next()) {
+            const auto institution = toInstitution(query);
+            institutions.insert(institution.bankCode, institution);
+        }
+
+        return institutions;
+    }
+
+private:
+    QHash<QThread *, StorageConnection *> m_connections;
+    QHash<QThread *, StorageConnection *> m_retiredConnections;
+    QHash<QThread *, QMetaObject::Connection> m_finishedConnections;
+    QString m_filePath;
+    QMutex m_mutex;
+};
+
+BankDirectory::BankDirectory()
+    : QObject(Q_NULLPTR)
+    , d_ptr(new Private())
+{ }
+
+BankDirectory::~BankDirectory()
+{
+    d_ptr.reset();
+}
+
+bool BankDirectory::open(const QString &fileName)
+{
+    QMutexLocker locker(d_ptr->mutex());
+
+    QString directoryFile = fileName;
+    if (directoryFile.isEmpty()) {
+        directoryFile = defaultFilePath();
+
+        // The shipped directory lives in the resources and SQLite can't open it
+        // from there, so we copy it once into the application data location.
+        if (!QFile::exists(directoryFile)) {
+            QDir().mkpath(QFileInfo(directoryFile).absolutePath());
+            if (!QFile::copy(":/app/olbaflinx-bankdata", directoryFile)) {
+                return false;
+            }
+            QFile::setPermissions(directoryFile, QFile::ReadOwner | QFile::WriteOwner);
+        }
+    }
+
+    return d_ptr->open(directoryFile);
+}
+
+bool BankDirectory::isOpen() const
+{
+    QMutexLocker locker(d_ptr->mutex());
+    return d_ptr->isOpen();
+}
+
+void BankDirectory::close()
+{
+    QMutexLocker locker(d_ptr->mutex());
+    d_ptr->close();
+}
+
+QString BankDirectory::filePath() const
+{
+    QMutexLocker locker(d_ptr->mutex());
+    return d_ptr->filePath();
+}
+
+QString BankDirectory::defaultFilePath()
+{
+    const auto path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    return QString("%1/%2").arg(path, BankDataFileName);
+}
+
+Institution BankDirectory::institution(const QString &bankCode)
+{
+    return institutions({bankCode}).value(bankCode);
+}
+
+InstitutionMap BankDirectory::institutions(const QStringList &bankCodes)
+{
+    if (bankCodes.isEmpty()) {
+        return {};
+    }
+
+    QMutexLocker locker(d_ptr->mutex());
+    if (!d_ptr->isOpen()) {
+        return {};
+    }
+
+    QVariantList codes = {};
+    for (const auto &bankCode : bankCodes) {
+        if (bankCode.length() == 8) {
+            codes << bankCode;
+        }
+    }
+
+    if (codes.isEmpty()) {
+        return {};
+    }
+
+    const auto connection = d_ptr->connection();
+    if (connection == Q_NULLPTR) {
+        return {};
+    }
+
+    // The whole batch is resolved with a single join against a temporary table
+    // instead of one lookup per bank code.
+    connection->begindTransaction();
+
+    QSqlQuery query(connection->database());
+    query.exec(BankDataSqlLookupClearQuery);
+    query.prepare(BankDataSqlLookupInsertQuery);
+    query.bindValue(":bankcode", codes);
+    query.execBatch();
+
+    InstitutionMap institutions = {};
+    query.setForwardOnly(true);
+    query.exec(BankDataSqlLookupJoinQuery);
+    while (query.next()) {
+        const auto institution = Private::toInstitution(query);
+        institutions.insert(institution.bankCode, institution);
+    }
+
+    query.exec(BankDataSqlLookupClearQuery);
+    connection->commitTransaction();
+
+    return institutions;
+}
+
+BankDirectoryUpdateResult BankDirectory::update(const QString &bankCodeFile,
+                                                const QDate &validUpTo,
+                                                const QString &encoding)
+{
+    BankDirectoryUpdateResult result;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QMutexLocker locker(d_ptr->mutex());
+    if (!d_ptr->isOpen() || d_ptr->connection() == Q_NULLPTR) {
+        result.errorMessage = Private::l10n::BankDirectoryNotOpen();
+        return result;
+    }
+
+    QTextCodec *codec = QTextCodec::codecForName(encoding.toLatin1());
+    if (codec == Q_NULLPTR) {
+        result.errorMessage = Private::l10n::BankDirectoryEncodingUnknown(encoding);
+        return result;
+    }
+
+    QFile file(bankCodeFile);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.errorMessage = Private::l10n::BankDirectoryFileNotReadable(bankCodeFile);
+        return result;
+    }
+
+    const auto current = d_ptr->currentInstitutions();
+
+    QVector<Private::Record> inserts = {};
+    QVector<Private::Record> updates = {};
+    QVector<Private::Record> successors = {};
+    QSet<QString> expires = {};
+    QSet<QString> seen = {};
+
+    const qint64 fileSize = qMax<qint64>(1, file.size());
+    qreal lastPercentage = 0.0;
+
+    Private::Record record;
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine();
+        if (!Private::parseRecord(line, codec, record)) {
+            ++result.skipped;
+            continue;
+        }
+
+        if (!record.isMain || seen.contains(record.bankCode)) {
+            continue;
+        }
+        seen.insert(record.bankCode);
+
+        const auto existing = current.constFind(record.bankCode);
+        if (record.isDeleted) {
+            if (existing != current.constEnd() && existing->isValid) {
+                expires.insert(record.bankCode);
+            } else if (existing == current.constEnd()) {
+                ++result.skipped;
+            }
+
+            if (record.successor != "00000000") {
+                successors.append(record);
+            }
+        } else if (existing == current.constEnd()) {
+            inserts.append(record);
+        } else if (!Private::isEqual(existing.value(), record)) {
+            updates.append(record);
+        } else {
+            ++result.unchanged;
+        }
+
+        const qreal percentage = file.pos() * 100.0 / fileSize;
+        if (percentage - lastPercentage >= 1.0) {
+            lastPercentage = percentage;
+            Q_EMIT progress(percentage);
+        }
+    }
+    file.close();
+
+    if (seen.isEmpty()) {
+        result.errorMessage = Private::l10n::BankDirectoryNoRecords();
+        return result;
+    }
+
+    // A deleted institution names its successor, which normally has its own
+    // record in the file. If it hasn't, the successor inherits the data of the
+    // deleted one, the same way the former python script handled it.
+    for (auto &successor : successors) {
+        if (seen.contains(successor.successor) || current.contains(successor.successor)) {
+            continue;
+        }
+        seen.insert(successor.successor);
+        successor.bankCode = successor.successor;
+        inserts.append(successor);
+    }
+
+    for (auto it = current.constBegin(); it != current.constEnd(); ++it) {
+        if (it->isValid && !seen.contains(it.key())) {
+            expires.insert(it.key());
+        }
+    }
+
+    if (inserts.isEmpty() && updates.isEmpty() && expires.isEmpty()) {
+        result.success = true;
+        result.elapsed = timer.elapsed();
+        Q_EMIT progress(100.0);
+        return result;
+    }
+
+    auto connection = d_ptr->connection();
+    connection->begindTransaction();
+
+    QSqlQuery query(connection->database());
+    const auto bindRecord = [&query](const Private::Record &record) {
+        query.bindValue(":bankcode", record.bankCode);
+        query.bindValue(":bic", record.bic);
+        query.bindValue(":method", record.method);
+        query.bindValue(":name", record.name);
+        query.bindValue(":location", record.location);
+        return query.exec();
+    };
+
+    bool success = query.prepare(BankDataSqlInstitutionInsertQuery);
+    for (const auto &insert : qAsConst(inserts)) {
+        success = success && bindRecord(insert);
+    }
+
+    success = success && query.prepare(BankDataSqlInstitutionUpdateQuery);
+    for (const auto &update : qAsConst(updates)) {
+        success = success && bindRecord(update);
+    }
+
+    success = success && query.prepare(BankDataSqlInstitutionExpireQuery);
+    const QString validUpToString = validUpTo.toString("yyyy-MM-dd");
+    for (const auto &bankCode : qAsConst(expires)) {
+        query.bindValue(":valid_upto", validUpToString);
+        query.bindValue(":bankcode", bankCode);
+        success = success && query.exec();
+    }
+
+    if (!success) {
+        result.errorMessage = Private::l10n::BankDirectoryWriteFailed(query.lastError().text());
+        connection->rollbackTransaction();
+        return result;
+    }
+
+    connection->commitTransaction();
+    query.exec("ANALYZE institutions");
+
+    result.success = true;
+    result.inserted = inserts.size();
+    result.updated = updates.size();
+    result.deleted = expires.size();
+    result.elapsed = timer.elapsed();
+
+    Q_EMIT progress(100.0);
+
+    return result;
+}
@@ -0,0 +1,110 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_BANKDIRECTORY_H
+#define OLBAFLINX_BANKDIRECTORY_H
+
+#include <QtCore/QDate>
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
+
+#include "core/Constant.h"
+#include "core/Singleton.h"
+
+namespace olbaflinx::core::bankdata {
+
+struct Institution
+{
+    QString bankCode = "";
+    QString bic = "";
+    QString method = "";
+    QString name = "";
+    QString location = "";
+    bool isValid = true;
+};
+typedef QHash<QString, Institution> InstitutionMap;
+
+struct BankDirectoryUpdateResult
+{
+    bool success = false;
+    int inserted = 0;
+    int updated = 0;
+    int deleted = 0;
+    int unchanged = 0;
+    int skipped = 0;
+    qint64 elapsed = 0;
+    QString errorMessage = "";
+};
+
+/**
+ * Access to the german bank directory (bank code, BIC, check method, name and
+ * location of each institution) and its incremental update from the bank code
+ * file published by the Deutsche Bundesbank.
+ */
+class BankDirectory : public QObject, public Singleton<BankDirectory>
+{
+    Q_OBJECT
+    friend class Singleton<BankDirectory>;
+
+public:
+    ~BankDirectory() override;
+
+    bool open(const QString &fileName = QString());
+    bool isOpen() const;
+
+    /**
+     * Closes the connection of the calling thread at once, other threads close
+     * theirs on their next lookup or once they finish.
+     */
+    void close();
+    QString filePath() const;
+
+    static QString defaultFilePath();
+
+    Institution institution(const QString &bankCode);
+    InstitutionMap institutions(const QStringList &bankCodes);
+
+    /**
+     * Reads the Bundesbank bank code file line by line, compares it against the
+     * opened directory and writes only the differences in a single transaction.
+     *
+     * Institutions flagged for deletion or missing in the file are not removed,
+     * their `valid_upto` is set to the given date.
+     */
+    BankDirectoryUpdateResult update(const QString &bankCodeFile,
+                                     const QDate &validUpTo,
+                                     const QString &encoding = BankDataFileEncoding);
+
+Q_SIGNALS:
+    void progress(const qreal progress);
+
+protected:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    BankDirectory();
+    Q_DISABLE_COPY(BankDirectory)
+};
+
+} // namespace olbaflinx::core::bankdata
+
+Q_DECLARE_METATYPE(olbaflinx::core::bankdata::Institution)
+Q_DECLARE_METATYPE(olbaflinx::core::bankdata::InstitutionMap)
+
+#endif //OLBAFLINX_BANKDIRECTORY_H
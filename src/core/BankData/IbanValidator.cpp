@@ -0,0 +1,302 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QRegularExpression>
+
+#include <ktoblzcheck.h>
+
+#include "core/BankData/BankDirectory.h"
+
+#include "IbanValidator.h"
+
+using namespace olbaflinx::core::bankdata;
+
+/**
+ * The checksum kernel works on lanes of IBANs at once. Every IBAN is expanded to
+ * its digit representation and right aligned in a column of the lane, so that
+ * all IBANs of a lane are processed in lockstep with the same loop bounds and
+ * the compiler can vectorize the inner loop.
+ */
+#define IbanKernelLanes 16
+#define IbanMaxDigits 68
+
+class IbanValidator::Private
+{
+public:
+    explicit Private()
+        : m_accountCheck(Q_NULLPTR)
+        , m_cache({})
+    { }
+
+    ~Private() { delete m_accountCheck; }
+
+    AccountNumberCheck *accountCheck()
+    {
+        if (m_accountCheck == Q_NULLPTR) {
+            m_accountCheck = new AccountNumberCheck();
+        }
+        return m_accountCheck;
+    }
+
+    static int expandDigits(const QString &iban, quint8 *digits)
+    {
+        // Move the country code and check digits to the end, letters become
+        // two digits (A = 10 ... Z = 35).
+        const QString rearranged = iban.mid(4) + iban.left(4);
+
+        int count = 0;
+        for (const QChar &c : rearranged) {
+            const ushort u = c.unicode();
+            if (u >= '0' && u <= '9') {
+                digits[count++] = (quint8) (u - '0');
+            } else {
+                const int value = u - 'A' + 10;
+                digits[count++] = (quint8) (value / 10);
+                digits[count++] = (quint8) (value % 10);
+            }
+        }
+
+        return count;
+    }
+
+    static void checkLane(const QStringList &ibans, int offset, int lanes, QVector<bool> &result)
+    {
+        quint8 digits[IbanMaxDigits][IbanKernelLanes] = {};
+        quint8 expanded[IbanMaxDigits];
+        int maxDigits = 0;
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            const int count = expandDigits(ibans.at(offset + lane), expanded);
+            const int padding = IbanMaxDigits - count;
+            for (int i = 0; i < count; ++i) {
+                digits[padding + i][lane] = expanded[i];
+            }
+            maxDigits = qMax(maxDigits, count);
+        }
+
+        // Leading zeros don't change the remainder, so all lanes start at the
+        // longest IBAN and consume two digits per step.
+        quint32 remainder[IbanKernelLanes] = {};
+        int start = IbanMaxDigits - maxDigits;
+        if ((IbanMaxDigits - start) % 2 != 0) {
+            --start;
+        }
+
+        for (int position = start; position < IbanMaxDigits; position += 2) {
+            const quint8 *high = digits[position];
+            const quint8 *low = digits[position + 1];
+            for (int lane = 0; lane < IbanKernelLanes; ++lane) {
+                remainder[lane] = (remainder[lane] * 100 + high[lane] * 10 + low[lane]) % 97;
+            }
+        }
+
+        for (int lane = 0; lane < lanes; ++lane) {
+            result[offset + lane] = (remainder[lane] == 1);
+        }
+    }
+
+    static bool isWellFormed(const QString &iban)
+    {
+        static const QRegularExpression ibanExpression("^[A-Z]{2}[0-9]{2}[A-Z0-9]{11,30}$");
+        return ibanExpression.match(iban).hasMatch();
+    }
+
+    /**
+     * Sets whether the account number could be checked and, if so, whether it
+     * is valid. Unknown bank codes or check methods leave the account unknown.
+     */
+    void checkAccount(IbanCheckResult &result)
+    {
+        const auto check = accountCheck()->check(result.bankCode.toStdString(),
+                                                 result.accountNumber.toStdString());
+        result.isAccountChecked = check != AccountNumberCheck::UNKNOWN;
+        result.isAccountValid = check == AccountNumberCheck::OK;
+    }
+
+    QMutex *mutex() { return &m_mutex; }
+    IbanCheckResults &cache() { return m_cache; }
+
+private:
+    AccountNumberCheck *m_accountCheck;
+    IbanCheckResults m_cache;
+    QMutex m_mutex;
+};
+
+IbanValidator::IbanValidator()
+    : QObject(Q_NULLPTR)
+    , d_ptr(new Private())
+{ }
+
+IbanValidator::~IbanValidator()
+{
+    d_ptr.reset();
+}
+
+IbanCheckResults IbanValidator::validate(const QStringList &ibans)
+{
+    QMutexLocker locker(d_ptr->mutex());
+
+    IbanCheckResults results = {};
+    QStringList pending = {};
+
+    for (const auto &iban : ibans) {
+        const QString normalized = normalize(iban);
+        if (normalized.isEmpty() || results.contains(normalized)) {
+            continue;
+        }
+
+        const auto cached = d_ptr->cache().constFind(normalized);
+        if (cached != d_ptr->cache().constEnd()) {
+            results.insert(normalized, cached.value());
+        } else if (!pending.contains(normalized)) {
+            pending << normalized;
+        }
+    }
+
+    if (pending.isEmpty()) {
+        return results;
+    }
+
+    QStringList wellFormed = {};
+    for (const auto &iban : qAsConst(pending)) {
+        if (Private::isWellFormed(iban)) {
+            wellFormed << iban;
+        } else {
+            IbanCheckResult result;
+            result.iban = iban;
+            results.insert(iban, result);
+            d_ptr->cache().insert(iban, result);
+        }
+    }
+
+    const auto checksums = checkDigits(wellFormed);
+
+    QStringList bankCodes = {};
+    QVector<IbanCheckResult> checked = {};
+    checked.reserve(wellFormed.size());
+
+    for (int i = 0; i < wellFormed.size(); ++i) {
+        IbanCheckResult result;
+        result.iban = wellFormed.at(i);
+        result.country = result.iban.left(2);
+        result.isIbanValid = checksums.at(i);
+
+        // German IBAN: DEkk BBBB BBBB CCCC CCCC CC
+        if (result.isIbanValid && result.country == "DE" && result.iban.length() == 22) {
+            result.bankCode = result.iban.mid(4, 8);
+            result.accountNumber = result.iban.mid(12, 10);
+            d_ptr->checkAccount(result);
+            bankCodes << result.bankCode;
+        }
+
+        checked.append(result);
+    }
+
+    const auto directory = BankDirectory::instance();
+    if (!bankCodes.isEmpty() && !directory->isOpen()) {
+        directory->open();
+    }
+
+    const auto institutions = directory->institutions(bankCodes);
+    for (auto &result : checked) {
+        const auto institution = institutions.constFind(result.bankCode);
+        if (institution != institutions.constEnd()) {
+            result.bic = institution->bic;
+            result.bankName = institution->name;
+            result.isBankKnown = institution->isValid;
+        }
+
+        results.insert(result.iban, result);
+        d_ptr->cache().insert(result.iban, result);
+    }
+
+    return results;
+}
+
+IbanCheckResult IbanValidator::validate(const QString &iban)
+{
+    return validate(QStringList({iban})).value(normalize(iban));
+}
+
+void IbanValidator::clearCache()
+{
+    QMutexLocker locker(d_ptr->mutex());
+    d_ptr->cache().clear();
+}
+
+QString IbanValidator::normalize(const QString &iban)
+{
+    QString normalized = {};
+    normalized.reserve(iban.size());
+
+    for (const QChar &c : iban) {
+        if (!c.isSpace()) {
+            normalized.append(c.toUpper());
+        }
+    }
+
+    return normalized;
+}
+
+QVector<bool> IbanValidator::checkDigits(const QStringList &normalizedIbans)
+{
+    // Only well-formed IBANs fit the digits of a lane, all others are invalid
+    QStringList ibans = {};
+    QVector<int> positions = {};
+    for (int i = 0; i < normalizedIbans.size(); ++i) {
+        if (Private::isWellFormed(normalizedIbans.at(i))) {
+            ibans << normalizedIbans.at(i);
+            positions << i;
+        }
+    }
+
+    const int size = ibans.size();
+    QVector<bool> checked(size, false);
+    for (int offset = 0; offset < size; offset += IbanKernelLanes) {
+        const int lanes = qMin(IbanKernelLanes, size - offset);
+        Private::checkLane(ibans, offset, lanes, checked);
+    }
+
+    QVector<bool> result(normalizedIbans.size(), false);
+    for (int i = 0; i < size; ++i) {
+        result[positions.at(i)] = checked.at(i);
+    }
+
+    return result;
+}
+
+bool IbanValidator::isBicValid(const QString &bic, const IbanCheckResult &result)
+{
+    static const QRegularExpression bicExpression("^[A-Z]{4}[A-Z]{2}[A-Z0-9]{2}([A-Z0-9]{3})?$");
+
+    const QString normalized = normalize(bic);
+    if (!bicExpression.match(normalized).hasMatch()) {
+        return false;
+    }
+
+    if (!result.country.isEmpty() && normalized.mid(4, 2) != result.country) {
+        return false;
+    }
+
+    if (!result.bic.isEmpty()) {
+        return normalized.left(8) == result.bic.left(8);
+    }
+
+    return true;
+}
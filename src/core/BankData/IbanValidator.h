@@ -0,0 +1,87 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_IBANVALIDATOR_H
+#define OLBAFLINX_IBANVALIDATOR_H
+
+#include <QtCore/QHash>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "core/Singleton.h"
+
+namespace olbaflinx::core::bankdata {
+
+struct IbanCheckResult
+{
+    QString iban = "";
+    QString country = "";
+    QString bankCode = "";
+    QString accountNumber = "";
+    QString bic = "";
+    QString bankName = "";
+    bool isIbanValid = false;
+    // Only meaningful if KtoBlzCheck knows a check method for the account
+    bool isAccountChecked = false;
+    bool isAccountValid = false;
+    bool isBankKnown = false;
+};
+typedef QHash<QString, IbanCheckResult> IbanCheckResults;
+
+/**
+ * Validates remote IBANs in batches: mod-97 checksum for every IBAN, account
+ * number check through KtoBlzCheck for german accounts and bank name / BIC from
+ * the bank directory. Results are cached per IBAN for the whole session.
+ */
+class IbanValidator : public QObject, public Singleton<IbanValidator>
+{
+    Q_OBJECT
+    friend class Singleton<IbanValidator>;
+
+public:
+    ~IbanValidator() override;
+
+    IbanCheckResults validate(const QStringList &ibans);
+    IbanCheckResult validate(const QString &iban);
+    void clearCache();
+
+    static QString normalize(const QString &iban);
+
+    /**
+     * Whether the check digits of the normalized IBANs are correct, IBANs
+     * with the wrong length or characters are invalid.
+     */
+    static QVector<bool> checkDigits(const QStringList &normalizedIbans);
+
+    static bool isBicValid(const QString &bic, const IbanCheckResult &result = IbanCheckResult());
+
+protected:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    IbanValidator();
+    Q_DISABLE_COPY(IbanValidator)
+};
+
+} // namespace olbaflinx::core::bankdata
+
+Q_DECLARE_METATYPE(olbaflinx::core::bankdata::IbanCheckResult)
+Q_DECLARE_METATYPE(olbaflinx::core::bankdata::IbanCheckResults)
+
+#endif //OLBAFLINX_IBANVALIDATOR_H
@@ -0,0 +1,115 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "core/Banking/OnlineBanking.h"
+#include "core/Storage/VaultStorage.h"
+
+#include "AccountSynchronizer.h"
+
+using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::storage;
+
+class AccountSynchronizer::Private
+{
+public:
+    explicit Private() = default;
+    ~Private() = default;
+
+    /**
+     * The fetched ranges without the current day.
+     */
+    static DateIntervals coveredIntervals(const DateIntervals &intervals,
+                                          const QDate &currentDate)
+    {
+        DateIntervals covered = {};
+        for (const auto &interval : intervals) {
+            const DateInterval clamped = {interval.from,
+                                          qMin(interval.to, currentDate.addDays(-1))};
+            if (clamped.isValid()) {
+                covered.append(clamped);
+            }
+        }
+        return covered;
+    }
+};
+
+AccountSynchronizer::AccountSynchronizer()
+    : QObject(Q_NULLPTR)
+    , d_ptr(new Private())
+{ }
+
+AccountSynchronizer::~AccountSynchronizer()
+{
+    d_ptr.reset();
+}
+
+bool AccountSynchronizer::synchronize(const AccountList &accounts,
+                                      const CancellationToken &token)
+{
+    const auto storage = VaultStorage::instance();
+    if (accounts.isEmpty() || !storage->isStorageValid()) {
+        return false;
+    }
+
+    const QDate currentDate = QDate::currentDate();
+
+    AccountDateIntervals ranges = {};
+    for (const auto account : accounts) {
+        const auto coverage = storage->accountCoverage(account->uniqueId());
+        ranges.insert(account->uniqueId(), pendingIntervals(coverage, currentDate));
+    }
+
+    const auto results = OnlineBanking::instance()->synchronize(accounts, ranges, token);
+
+    bool success = !results.isEmpty();
+    for (const auto &result : results) {
+        // Answers that arrived are stored even if other commands failed
+        bool isStored = !token.isCancelled();
+        if (isStored) {
+            storage->addAccountBalance(result.accountId, result.balances);
+            isStored = storage->addTransactions(result.accountId, result.transactions, token);
+        }
+
+        // Only ranges asked for and answered count as covered
+        if (isStored && !result.fetchedIntervals.isEmpty()) {
+            const auto covered = Private::coveredIntervals(result.fetchedIntervals, currentDate);
+            isStored = storage->addAccountCoverage(result.accountId, covered);
+        }
+
+        if (!result.errorMessage.isEmpty()) {
+            Q_EMIT error(result.errorMessage);
+        }
+
+        success = success && isStored && result.errorMessage.isEmpty();
+
+        qDeleteAll(result.balances);
+        qDeleteAll(result.transactions);
+    }
+
+    return success;
+}
+
+DateIntervals AccountSynchronizer::pendingIntervals(const AccountCoverage &coverage,
+                                                    const QDate &currentDate)
+{
+    QDate from = currentDate.addDays(MaxDateForTransactionsWithoutPin);
+    if (!coverage.isEmpty()) {
+        from = qMin(from, coverage.firstDate());
+    }
+
+    return coverage.missing(from, currentDate);
+}
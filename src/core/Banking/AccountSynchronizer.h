@@ -0,0 +1,77 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_ACCOUNTSYNCHRONIZER_H
+#define OLBAFLINX_ACCOUNTSYNCHRONIZER_H
+
+#include <QtCore/QDate>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+
+#include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Singleton.h"
+
+namespace olbaflinx::core::banking {
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+
+/**
+ * Synchronizes accounts into the opened vault. Only the days the vault doesn't
+ * cover yet are fetched, from the first covered day (at least four weeks back)
+ * up to today, so refreshes stay small and older gaps are filled on the way.
+ */
+class AccountSynchronizer : public QObject, public Singleton<AccountSynchronizer>
+{
+    Q_OBJECT
+    friend class Singleton<AccountSynchronizer>;
+
+public:
+    ~AccountSynchronizer() override;
+
+    /**
+     * Stores balances and transactions of the accounts and adds the fetched
+     * ranges to their coverage. Accounts with an error don't get coverage,
+     * their ranges are asked for again next time.
+     *
+     * Returns false if any of the accounts failed.
+     */
+    bool synchronize(const AccountList &accounts,
+                     const CancellationToken &token = CancellationToken());
+
+    /**
+     * Ranges to fetch for the given coverage. Today is never covered, bookings
+     * of the current day can still arrive.
+     */
+    static DateIntervals pendingIntervals(const AccountCoverage &coverage,
+                                          const QDate &currentDate = QDate::currentDate());
+
+Q_SIGNALS:
+    void error(const QString &message);
+
+protected:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    AccountSynchronizer();
+    Q_DISABLE_COPY(AccountSynchronizer)
+};
+
+} // namespace olbaflinx::core::banking
+
+#endif //OLBAFLINX_ACCOUNTSYNCHRONIZER_H
@@ -0,0 +1,238 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QLocale>
+
+#include <aqbanking/types/transactionlimits.h>
+
+#include "core/Banking/OnlineBanking.h"
+#include "core/Storage/VaultStorage.h"
+
+#include "BackfillScheduler.h"
+
+using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::storage;
+
+class BackfillScheduler::Private
+{
+public:
+    explicit Private() = default;
+    ~Private() = default;
+
+    /**
+     * A window whose transactions are being stored on the vault executor.
+     */
+    struct PendingWindow
+    {
+        quint32 accountId = 0;
+        DateInterval interval = {};
+        TransactionList transactions = {};
+        QFuture<int> future = {};
+        int task = -1;
+    };
+
+    static bool waitFor(QFuture<int> future)
+    {
+        QEventLoop loop;
+        QFutureWatcher<int> watcher;
+        QObject::connect(&watcher, &QFutureWatcher<int>::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(future);
+        if (!future.isFinished()) {
+            loop.exec();
+        }
+        return future.result() >= 0;
+    }
+
+    /**
+     * Waits for the store of the window, its interval is covered only if all of
+     * its transactions are stored.
+     */
+    static bool finish(PendingWindow &window, ProgressReporter *reporter)
+    {
+        if (window.task < 0) {
+            return true;
+        }
+
+        bool isStored = waitFor(window.future);
+        if (isStored) {
+            isStored = VaultStorage::instance()->addAccountCoverage(window.accountId,
+                                                                   {window.interval});
+        }
+
+        qDeleteAll(window.transactions);
+        reporter->finishTask(window.task);
+        window = PendingWindow();
+
+        return isStored;
+    }
+
+    static QString settingKey(const quint32 &accountId) { return QString::number(accountId); }
+};
+
+BackfillScheduler::BackfillScheduler()
+    : QObject(Q_NULLPTR)
+    , d_ptr(new Private())
+{ }
+
+BackfillScheduler::~BackfillScheduler()
+{
+    d_ptr.reset();
+}
+
+bool BackfillScheduler::backfill(const Account *account,
+                                 const QDate &from,
+                                 const CancellationToken &token)
+{
+    const auto storage = VaultStorage::instance();
+    if (account == Q_NULLPTR || !from.isValid() || !storage->isStorageValid()) {
+        return false;
+    }
+
+    const quint32 accountId = account->uniqueId();
+    const QString key = Private::settingKey(accountId);
+    storage->storeSetting(key, from, BackfillSettingsGroup);
+
+    // The current day is left to the regular sync
+    const QDate to = QDate::currentDate().addDays(-1);
+    const auto coverage = storage->accountCoverage(accountId);
+    const auto pending = windows(coverage, from, to, windowDays(account));
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+
+    // One task per window, fetched and stored
+    const QLocale locale;
+    QVector<int> tasks = {};
+    for (const auto &window : pending) {
+        const QString name = tr("Transactions %1 - %2")
+                                 .arg(locale.toString(window.from, QLocale::ShortFormat),
+                                      locale.toString(window.to, QLocale::ShortFormat));
+        tasks << reporter.addTask(name, 2);
+    }
+
+    const auto banking = OnlineBanking::instance();
+
+    bool success = true;
+    Private::PendingWindow stored;
+    for (int index = 0; index < pending.size() && success; ++index) {
+        if (token.isCancelled()) {
+            success = false;
+            break;
+        }
+
+        // Fetched while the previous window is still stored
+        const auto window = pending.at(index);
+        const auto results = banking->synchronize({account},
+                                                  {{accountId, {window}}},
+                                                  token,
+                                                  false);
+        const auto result = results.value(accountId);
+        reporter.advance(tasks.at(index));
+
+        success = Private::finish(stored, &reporter);
+
+        if (results.isEmpty() || !result.errorMessage.isEmpty()) {
+            if (!result.errorMessage.isEmpty()) {
+                Q_EMIT error(result.errorMessage);
+            }
+            qDeleteAll(result.transactions);
+            success = false;
+            break;
+        }
+
+        stored.accountId = accountId;
+        stored.interval = window;
+        stored.transactions = result.transactions;
+        stored.future = storage->queueTransactions(accountId, result.transactions, token);
+        stored.task = tasks.at(index);
+    }
+
+    success = Private::finish(stored, &reporter) && success;
+    reporter.finish();
+
+    // Done, nothing left to resume
+    if (success) {
+        storage->storeSetting(key, QVariant(), BackfillSettingsGroup);
+    }
+
+    return success;
+}
+
+bool BackfillScheduler::resume(const AccountList &accounts, const CancellationToken &token)
+{
+    bool success = true;
+    for (const auto account : accounts) {
+        if (token.isCancelled()) {
+            return false;
+        }
+
+        const QDate from = target(account->uniqueId());
+        if (from.isValid()) {
+            success = backfill(account, from, token) && success;
+        }
+    }
+    return success;
+}
+
+QDate BackfillScheduler::target(const quint32 &accountId) const
+{
+    return VaultStorage::instance()
+        ->setting(Private::settingKey(accountId), BackfillSettingsGroup)
+        .toDate();
+}
+
+int BackfillScheduler::windowDays(const Account *account)
+{
+    const auto limits = account->transactionLimitsForCommand(
+        AB_Transaction_CommandGetTransactions);
+    if (limits == Q_NULLPTR) {
+        return BackfillWindowDays;
+    }
+
+    const int maxDays = AB_TransactionLimits_GetMaxValueSetupTime(limits);
+    return maxDays > 0 ? qMin(maxDays, BackfillWindowDays) : BackfillWindowDays;
+}
+
+DateIntervals BackfillScheduler::windows(const AccountCoverage &coverage,
+                                         const QDate &from,
+                                         const QDate &to,
+                                         const int days)
+{
+    if (days <= 0) {
+        return {};
+    }
+
+    DateIntervals windows = {};
+    const auto gaps = coverage.missing(from, to);
+    for (auto gap = gaps.crbegin(); gap != gaps.crend(); ++gap) {
+        QDate end = gap->to;
+        while (end >= gap->from) {
+            const QDate start = qMax(gap->from, end.addDays(1 - days));
+            windows.append({start, end});
+            end = start.addDays(-1);
+        }
+    }
+    return windows;
+}
+
+void BackfillScheduler::connectProgress(ProgressReporter *reporter)
+{
+    connect(reporter, &ProgressReporter::progress, this, &BackfillScheduler::progress);
+    connect(reporter, &ProgressReporter::stateChanged, this, &BackfillScheduler::progressChanged);
+}
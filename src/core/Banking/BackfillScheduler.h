@@ -0,0 +1,97 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_BACKFILLSCHEDULER_H
+#define OLBAFLINX_BACKFILLSCHEDULER_H
+
+#include <QtCore/QDate>
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+
+#include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
+#include "core/Singleton.h"
+
+namespace olbaflinx::core::banking {
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+
+/**
+ * Fetches the history of an account back to a target date in windows, newest
+ * first. Each window is one job list for the bank; while the next window is
+ * fetched the previous one is hashed and stored on the vault executor.
+ *
+ * The target is kept in the vault settings and every stored window is added
+ * to the coverage of the account, so an interrupted backfill continues with
+ * the windows still missing.
+ */
+class BackfillScheduler : public QObject, public Singleton<BackfillScheduler>
+{
+    Q_OBJECT
+    friend class Singleton<BackfillScheduler>;
+
+public:
+    ~BackfillScheduler() override;
+
+    /**
+     * Returns true once everything from `from` up to yesterday is covered.
+     */
+    bool backfill(const Account *account,
+                  const QDate &from,
+                  const CancellationToken &token = CancellationToken());
+
+    /**
+     * Continues the backfills of the given accounts which were interrupted.
+     */
+    bool resume(const AccountList &accounts, const CancellationToken &token = CancellationToken());
+    [[nodiscard]] QDate target(const quint32 &accountId) const;
+
+    /**
+     * Days per window, at most `BackfillWindowDays` and not more than the bank
+     * keeps statements for the account.
+     */
+    [[nodiscard]] static int windowDays(const Account *account);
+
+    /**
+     * Splits the uncovered days from `from` to `to` into windows of at most
+     * `days` days, newest first.
+     */
+    [[nodiscard]] static DateIntervals windows(const AccountCoverage &coverage,
+                                               const QDate &from,
+                                               const QDate &to,
+                                               const int days = BackfillWindowDays);
+
+Q_SIGNALS:
+    void progress(const qreal progress);
+    void progressChanged(const ProgressState &state);
+    void error(const QString &message);
+
+protected:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    void connectProgress(ProgressReporter *reporter);
+
+    BackfillScheduler();
+    Q_DISABLE_COPY(BackfillScheduler)
+};
+
+} // namespace olbaflinx::core::banking
+
+#endif //OLBAFLINX_BACKFILLSCHEDULER_H
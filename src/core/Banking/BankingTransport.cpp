@@ -0,0 +1,37 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <aqbanking/banking_online.h>
+
+#include "BankingTransport.h"
+
+using namespace olbaflinx::core::banking;
+
+bool BankingTransport::isCommandSupported(const Account *account,
+                                          const AB_TRANSACTION_COMMAND command) const
+{
+    return account->transactionLimitsForCommand(command) != Q_NULLPTR;
+}
+
+AqBankingTransport::AqBankingTransport(AB_BANKING *abBanking)
+    : m_abBanking(abBanking)
+{ }
+
+int AqBankingTransport::sendCommands(AB_TRANSACTION_LIST2 *commands, AB_IMEXPORTER_CONTEXT *context)
+{
+    return AB_Banking_SendCommands(m_abBanking, commands, context);
+}
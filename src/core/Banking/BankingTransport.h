@@ -0,0 +1,63 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_BANKINGTRANSPORT_H
+#define OLBAFLINX_BANKINGTRANSPORT_H
+
+#include <aqbanking/banking.h>
+#include <aqbanking/types/imexporter_context.h>
+#include <aqbanking/types/transaction.h>
+
+#include "core/Container.h"
+
+namespace olbaflinx::core::banking {
+
+using namespace olbaflinx::core;
+
+/**
+ * Sends a job list of commands and fills the context with the answers of the
+ * banks. `OnlineBanking` talks to the banks only through a transport, so a
+ * recorded session can stand in for them.
+ */
+class BankingTransport
+{
+public:
+    virtual ~BankingTransport() = default;
+
+    [[nodiscard]] virtual bool isCommandSupported(const Account *account,
+                                                  const AB_TRANSACTION_COMMAND command) const;
+    virtual int sendCommands(AB_TRANSACTION_LIST2 *commands, AB_IMEXPORTER_CONTEXT *context) = 0;
+};
+
+/**
+ * Sends the commands through aqbanking, commands for the same bank share one
+ * dialog.
+ */
+class AqBankingTransport : public BankingTransport
+{
+public:
+    explicit AqBankingTransport(AB_BANKING *abBanking);
+
+    int sendCommands(AB_TRANSACTION_LIST2 *commands, AB_IMEXPORTER_CONTEXT *context) override;
+
+private:
+    AB_BANKING *m_abBanking;
+};
+
+} // namespace olbaflinx::core::banking
+
+#endif //OLBAFLINX_BANKINGTRANSPORT_H
@@ -46,12 +46,16 @@
 #define AB_ERROR GWEN_ERROR_GENERIC
 #endif
 
+#include "core/Banking/BankingTransport.h"
+#include "core/BankingHandle.h"
+#include "core/Progress/ProgressReporter.h"
 #include "core/SingleApplication/SingleApplication.h"
 #include "core/Utils.h"
 
 #include "OnlineBanking.h"
 
 using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::progress;
 
 class OnlineBanking::Private
 {
@@ -91,9 +95,10 @@ public:
         , m_gwenGui(Q_NULLPTR)
         , m_abBanking(Q_NULLPTR)
         , m_isInitialized(false)
+        , m_transport(Q_NULLPTR)
     { }
 
-    ~Private() = default;
+    ~Private() { delete m_transport; }
 
     bool initBanking(const QString &name, const QString &key, const QString &version)
     {
@@ -133,6 +138,10 @@ public:
 
         AB_Gui_Extend(m_gwenGui, m_abBanking);
 
+        if (m_transport == Q_NULLPTR) {
+            m_transport = new AqBankingTransport(m_abBanking);
+        }
+
 #ifdef USE_LIBCHIPCARD
         m_chipCardClient
             = LC_Client_new(SingleApplication::applicationName().toLocal8Bit().constData(),
@@ -170,6 +179,9 @@ public:
         }
 #endif
 
+        delete m_transport;
+        m_transport = nullptr;
+
         m_qtGui = nullptr;
         m_gwenGui = nullptr;
         m_abBanking = nullptr;
@@ -183,12 +195,23 @@ public:
 
     bool isInitialized() const { return m_isInitialized; }
 
-    AB_IMEXPORTER_ACCOUNTINFO *createImExporterAccountInfo(AB_TRANSACTION_COMMAND cmd,
-                                                           quint32 uniqueId,
-                                                           GWEN_DATE *from,
-                                                           GWEN_DATE *to) const
+    BankingTransport *transport() const { return m_transport; }
+
+    void setTransport(BankingTransport *transport)
+    {
+        delete m_transport;
+        m_transport = transport;
+
+        if (m_transport == Q_NULLPTR && m_abBanking != Q_NULLPTR) {
+            m_transport = new AqBankingTransport(m_abBanking);
+        }
+    }
+
+    static AB_TRANSACTION *createCommand(AB_TRANSACTION_COMMAND cmd,
+                                         quint32 uniqueId,
+                                         GWEN_DATE *from,
+                                         GWEN_DATE *to)
     {
-        AB_TRANSACTION_LIST2 *transactionList = AB_Transaction_List2_new();
         AB_TRANSACTION *transaction = AB_Transaction_new();
 
         AB_Transaction_SetCommand(transaction, cmd);
@@ -201,18 +224,90 @@ public:
             AB_Transaction_SetLastDate(transaction, to);
         }
 
-        AB_Transaction_List2_PushBack(transactionList, transaction);
+        return transaction;
+    }
+
+    /**
+     * Sends one command and returns the answers.
+     */
+    ImExporterContextHandle createImExporterContext(AB_TRANSACTION_COMMAND cmd,
+                                                    quint32 uniqueId,
+                                                    const QDate &from,
+                                                    const QDate &to) const
+    {
+        const GwenDateHandle gwenFromDate(Utils::qDateToGwenDate(from));
+        const GwenDateHandle gwenToDate(Utils::qDateToGwenDate(to));
+
+        const CommandListHandle commands(AB_Transaction_List2_new());
+        AB_Transaction_List2_PushBack(commands.get(),
+                                      createCommand(cmd,
+                                                    uniqueId,
+                                                    gwenFromDate.get(),
+                                                    gwenToDate.get()));
+
+        ImExporterContextHandle context(AB_ImExporterContext_new());
+        m_transport->sendCommands(commands.get(), context.get());
+
+        return context;
+    }
+
+    /**
+     * Moves at most `limit` transactions out of the account info without
+     * copying them, all of them with a negative limit.
+     */
+    static void takeTransactions(AB_IMEXPORTER_ACCOUNTINFO *accountInfo,
+                                 TransactionList &transactions,
+                                 ProgressReporter *reporter,
+                                 const int task,
+                                 const CancellationToken &token,
+                                 const int limit = -1)
+    {
+        int taken = 0;
+        auto transaction = AB_Transaction_List_First(
+            AB_ImExporterAccountInfo_GetTransactionList(accountInfo));
+        while (transaction && !token.isCancelled() && (limit < 0 || taken++ < limit)) {
+            const auto next = AB_Transaction_List_Next(transaction);
+            AB_Transaction_List_Del(transaction);
+            transactions.append(Transaction::adopt(transaction));
+
+            if (reporter != Q_NULLPTR) {
+                reporter->advance(task);
+            }
+            transaction = next;
+        }
+    }
 
-        AB_IMEXPORTER_CONTEXT *imExporterCtx = AB_ImExporterContext_new();
-        AB_Banking_SendCommands(m_abBanking, transactionList, imExporterCtx);
+    static void takeBalances(AB_IMEXPORTER_ACCOUNTINFO *accountInfo, AccountBalanceList &balances)
+    {
+        auto balance = AB_Balance_List_First(AB_ImExporterAccountInfo_GetBalanceList(accountInfo));
+        while (balance) {
+            const auto next = AB_Balance_List_Next(balance);
+            AB_Balance_List_Del(balance);
+            balances.append(AccountBalance::adopt(balance));
+            balance = next;
+        }
+    }
 
-        return AB_ImExporterContext_GetFirstAccountInfo(imExporterCtx);
+    static int transactionCount(AB_IMEXPORTER_CONTEXT *context)
+    {
+        int transactionCount = 0;
+        auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(context);
+        while (accountInfo) {
+            transactionCount += AB_Transaction_List_GetCount(
+                AB_ImExporterAccountInfo_GetTransactionList(accountInfo));
+            accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
+        }
+        return transactionCount;
     }
 
-    TransactionList transactions(
-        const AB_IMEXPORTER_ACCOUNTINFO *accountInfo,
-        const AB_TRANSACTION_COMMAND type,
-        const std::function<void(qreal)> &callback = [](qreal) {})
+    /**
+     * Transactions of all account infos of the context, they are moved out of
+     * it and handed over as they are.
+     */
+    TransactionList transactions(AB_IMEXPORTER_CONTEXT *context,
+                                 ProgressReporter *reporter,
+                                 const int task,
+                                 const CancellationToken &token)
     {
         qApp->setOverrideCursor(Qt::WaitCursor);
 
@@ -226,43 +321,35 @@ public:
             qApp->restoreOverrideCursor();
         });
 
-        transactionWatcher.setFuture(QtConcurrent::run([accountInfo,
-                                                        type,
-                                                        callback]() -> TransactionList {
-            TransactionList transactions = {};
-
-            auto accountInfoDup = AB_ImExporterAccountInfo_dup(accountInfo);
-            while (accountInfoDup) {
-                int index = 0;
-                auto abTransactionList = AB_ImExporterAccountInfo_GetTransactionList(accountInfoDup);
-                int transactionCount = AB_Transaction_List_CountByType(abTransactionList, 0, type);
-                if (abTransactionList) {
-                    auto abTransaction = AB_Transaction_List_First(abTransactionList);
-                    while (abTransaction) {
-                        transactions.append(new Transaction(abTransaction));
-
-                        const qreal percentage = index * 100.0 / transactionCount;
-                        callback(percentage);
-                        ++index;
-
-                        abTransaction = AB_Transaction_List_Next(abTransaction);
-                    }
-                    AB_Transaction_List_free(abTransactionList);
+        transactionWatcher.setFuture(
+            QtConcurrent::run([context, reporter, task, token]() -> TransactionList {
+                TransactionList transactions = {};
+
+                const int count = transactionCount(context);
+                reporter->setTaskTotal(task, count);
+                transactions.reserve(count);
+
+                auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(context);
+                while (accountInfo && !token.isCancelled()) {
+                    takeTransactions(accountInfo, transactions, reporter, task, token);
+                    accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
                 }
-                accountInfoDup = AB_ImExporterAccountInfo_List_Next(accountInfoDup);
-            }
-            AB_ImExporterAccountInfo_free(accountInfoDup);
 
-            return transactions;
-        }));
+                // A partial result is never handed out
+                if (token.isCancelled()) {
+                    qDeleteAll(transactions);
+                    transactions.clear();
+                }
+
+                return transactions;
+            }));
         loop.exec();
+        reporter->finishTask(task);
 
         return transactionWatcher.result();
     }
 
-    AccountList accounts(
-        const AB_ACCOUNT_SPEC_LIST *accountSpecList,
-        const std::function<void(qreal)> &callback = [](qreal) {})
+    AccountList accounts(const AB_ACCOUNT_SPEC_LIST *accountSpecList, ProgressReporter *reporter)
     {
         qApp->setOverrideCursor(Qt::WaitCursor);
 
@@ -276,30 +363,24 @@ public:
             qApp->restoreOverrideCursor();
         });
 
-        accountWatcher.setFuture(QtConcurrent::run([accountSpecList, callback]() -> AccountList {
-            const auto accSpecList = AB_AccountSpec_List_dup(accountSpecList);
-            const auto totalAccounts = AB_AccountSpec_List_GetCount(accSpecList);
+        accountWatcher.setFuture(QtConcurrent::run([accountSpecList, reporter]() -> AccountList {
+            const auto totalAccounts = AB_AccountSpec_List_GetCount(accountSpecList);
 
             if (totalAccounts == 0) {
                 return {};
             }
 
-            quint32 index = 0;
             AccountList accountList = {};
+            const int task = reporter->addTask(tr("Load accounts"), totalAccounts);
 
-            auto accountSpec = AB_AccountSpec_List_First(accSpecList);
+            auto accountSpec = AB_AccountSpec_List_First(accountSpecList);
             while (accountSpec) {
                 accountList.append(new Account(accountSpec));
-
-                const qreal percentage = index * 100.0 / totalAccounts;
-                callback(percentage);
+                reporter->advance(task);
 
                 accountSpec = AB_AccountSpec_List_Next(accountSpec);
-                ++index;
             }
 
-            AB_AccountSpec_List_free(accSpecList);
-
             std::sort(accountList.begin(),
                       accountList.end(),
                       [](const Account *first, const Account *second) {
@@ -313,6 +394,49 @@ public:
         return accountWatcher.result();
     }
 
+    /**
+     * Reads the answers of all accounts in one pass over the context, answers
+     * for accounts which weren't asked for are skipped. Balances and
+     * transactions are moved out of the context.
+     */
+    void readSyncResults(AB_IMEXPORTER_CONTEXT *context,
+                         AccountSyncResults &results,
+                         ProgressReporter *reporter,
+                         const int task,
+                         const CancellationToken &token)
+    {
+        qApp->setOverrideCursor(Qt::WaitCursor);
+
+        QEventLoop loop;
+        QFutureWatcher<void> syncWatcher;
+        connect(&syncWatcher, &QFutureWatcher<void>::finished, &loop, [&]() {
+            loop.quit();
+            syncWatcher.cancel();
+            syncWatcher.waitForFinished();
+
+            qApp->restoreOverrideCursor();
+        });
+
+        syncWatcher.setFuture(QtConcurrent::run([&]() -> void {
+            reporter->setTaskTotal(task, AB_ImExporterContext_GetAccountInfoCount(context));
+
+            auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(context);
+            while (accountInfo && !token.isCancelled()) {
+                const quint32 accountId = AB_ImExporterAccountInfo_GetAccountId(accountInfo);
+                const auto result = results.find(accountId);
+                if (result != results.end()) {
+                    takeBalances(accountInfo, result->balances);
+                    takeTransactions(accountInfo, result->transactions, Q_NULLPTR, -1, token);
+                }
+
+                reporter->advance(task);
+                accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
+            }
+        }));
+        loop.exec();
+        reporter->finishTask(task);
+    }
+
     QString validateAccount(const Account *account, AB_TRANSACTION_COMMAND cmd) const
     {
         if (!isInitialized()) {
@@ -349,6 +473,7 @@ private:
     QT5_Gui *m_qtGui;
     AB_BANKING *m_abBanking;
     bool m_isInitialized;
+    BankingTransport *m_transport;
 
 #ifdef USE_LIBCHIPCARD
     LC_CLIENT *m_chipCardClient;
@@ -405,6 +530,10 @@ ImExportProfileList OnlineBanking::importExportProfiles(bool import)
 
     qApp->setOverrideCursor(Qt::WaitCursor);
 
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Load profiles"));
+
     QEventLoop loop;
     QFutureWatcher<ImExportProfileList> imExporterWatcher;
     connect(&imExporterWatcher, &QFutureWatcher<ImExportProfileList>::finished, &loop, [&]() {
@@ -421,10 +550,10 @@ ImExportProfileList OnlineBanking::importExportProfiles(bool import)
         auto pluginListDup = GWEN_PluginDescription_List2_dup(pluginList);
         auto pluginListIter = GWEN_PluginDescription_List2_First(pluginListDup);
         auto pluginListCount = GWEN_PluginDescription_List2_GetSize(pluginListDup);
+        reporter.setTaskTotal(task, pluginListCount);
 
         if (pluginListIter) {
             auto gpDescr = GWEN_PluginDescription_List2Iterator_Data(pluginListIter);
-            int index = 0;
             while (gpDescr) {
                 auto iep = new ImExportProfile();
 
@@ -464,9 +593,7 @@ ImExportProfileList OnlineBanking::importExportProfiles(bool import)
                     imExportProfiles.append(iep);
                 }
 
-                const qreal percentage = index * 100.0 / pluginListCount;
-                Q_EMIT progress(percentage);
-                ++index;
+                reporter.advance(task);
 
                 gpDescr = GWEN_PluginDescription_List2Iterator_Next(pluginListIter);
             }
@@ -479,6 +606,7 @@ ImExportProfileList OnlineBanking::importExportProfiles(bool import)
         return imExportProfiles;
     }));
     loop.exec();
+    reporter.finish();
 
     GWEN_PluginDescription_List2_free(pluginList);
 
@@ -492,19 +620,16 @@ Account *OnlineBanking::account(quint32 uniqueId)
         return Q_NULLPTR;
     }
 
-    AB_ACCOUNT_SPEC *accountSpec = Q_NULLPTR;
+    AB_ACCOUNT_SPEC *abAccountSpec = Q_NULLPTR;
 
-    int rv = AB_Banking_GetAccountSpecByUniqueId(d_ptr->abBanking(), uniqueId, &accountSpec);
+    int rv = AB_Banking_GetAccountSpecByUniqueId(d_ptr->abBanking(), uniqueId, &abAccountSpec);
+    const AccountSpecHandle accountSpec(abAccountSpec);
     if (rv != AB_SUCCESS) {
         Q_EMIT error(Private::l10n::OnlineBankingNoAccountWithId(uniqueId));
         return Q_NULLPTR;
     }
 
-    const auto account = new Account(accountSpec);
-
-    AB_AccountSpec_free(accountSpec);
-
-    return account;
+    return new Account(accountSpec.get());
 }
 
 AccountIds OnlineBanking::accountIds()
@@ -533,17 +658,19 @@ AccountList OnlineBanking::accounts()
         return {};
     }
 
-    AB_ACCOUNT_SPEC_LIST *accountSpecList = Q_NULLPTR;
+    AB_ACCOUNT_SPEC_LIST *abAccountSpecList = Q_NULLPTR;
 
-    int rv = AB_Banking_GetAccountSpecList(d_ptr->abBanking(), &accountSpecList);
+    int rv = AB_Banking_GetAccountSpecList(d_ptr->abBanking(), &abAccountSpecList);
+    const AccountSpecListHandle accountSpecList(abAccountSpecList);
     if (rv != AB_SUCCESS) {
         Q_EMIT error(Private::l10n::OnlineBankingAccountError());
         return {};
     }
 
-    auto accounts = d_ptr->accounts(accountSpecList, [&](qreal value) { Q_EMIT progress(value); });
-
-    AB_AccountSpec_List_free(accountSpecList);
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    auto accounts = d_ptr->accounts(accountSpecList.get(), &reporter);
+    reporter.finish();
 
     if (accounts.isEmpty()) {
         Q_EMIT error(Private::l10n::OnlineBankingNoAccountsFound());
@@ -574,19 +701,17 @@ AccountBalanceList OnlineBanking::accountBalances(const Account *account,
         return {};
     }
 
-    GWEN_DATE *gwenFromDate = Utils::qDateToGwenDate(from);
-    GWEN_DATE *gwenToDate = Utils::qDateToGwenDate(to);
-
-    auto accountInfo = d_ptr->createImExporterAccountInfo(AB_Transaction_CommandGetBalance,
-                                                          account->uniqueId(),
-                                                          gwenFromDate,
-                                                          gwenToDate);
-
-    GWEN_Date_free(gwenFromDate);
-    GWEN_Date_free(gwenToDate);
+    const auto context = d_ptr->createImExporterContext(AB_Transaction_CommandGetBalance,
+                                                        account->uniqueId(),
+                                                        from,
+                                                        to);
 
     qApp->setOverrideCursor(Qt::WaitCursor);
 
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Load balances"));
+
     QEventLoop loop;
     QFutureWatcher<AccountBalanceList> accountBalanceWatcher;
     connect(&accountBalanceWatcher, &QFutureWatcher<AccountBalanceList>::finished, &loop, [&]() {
@@ -597,38 +722,22 @@ AccountBalanceList OnlineBanking::accountBalances(const Account *account,
         qApp->restoreOverrideCursor();
     });
 
-    accountBalanceWatcher.setFuture(QtConcurrent::run([&, accountInfo]() -> AccountBalanceList {
+    accountBalanceWatcher.setFuture(QtConcurrent::run([&]() -> AccountBalanceList {
         AccountBalanceList balanceList = {};
 
-        auto accountInfoDup = AB_ImExporterAccountInfo_dup(accountInfo);
-        while (accountInfoDup) {
-            auto accountBalanceList = AB_ImExporterAccountInfo_GetBalanceList(accountInfoDup);
-            if (accountBalanceList) {
-                int index = 0;
-                auto balanceCount = AB_Balance_List_GetCount(accountBalanceList);
-                auto balances = AB_Balance_List_First(accountBalanceList);
-                if (balances) {
-                    while (balances) {
-                        balanceList.append(new AccountBalance(balances));
-
-                        const qreal percentage = index * 100.0 / balanceCount;
-                        Q_EMIT progress(percentage);
-                        ++index;
-
-                        balances = AB_Balance_List_Next(balances);
-                    }
-                }
-                AB_Balance_List_free(accountBalanceList);
-            }
-            accountInfoDup = AB_ImExporterAccountInfo_List_Next(accountInfoDup);
+        reporter.setTaskTotal(task, AB_ImExporterContext_GetAccountInfoCount(context.get()));
+        auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(context.get());
+        while (accountInfo) {
+            Private::takeBalances(accountInfo, balanceList);
+            reporter.advance(task);
+
+            accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
         }
-        AB_ImExporterAccountInfo_free(accountInfoDup);
 
         return balanceList;
     }));
     loop.exec();
-
-    AB_ImExporterAccountInfo_free(accountInfo);
+    reporter.finish();
 
     return accountBalanceWatcher.result();
 }
@@ -636,7 +745,8 @@ AccountBalanceList OnlineBanking::accountBalances(const Account *account,
 TransactionList OnlineBanking::transactions(const Account *account,
                                             const QDate &from,
                                             const QDate &to,
-                                            const TransactionListType &type)
+                                            const TransactionListType &type,
+                                            const CancellationToken &token)
 {
     if (!d_ptr->isInitialized()) {
         Q_EMIT error(Private::l10n::OnlineBankingNotInitialized());
@@ -655,64 +765,271 @@ TransactionList OnlineBanking::transactions(const Account *account,
         return {};
     }
 
-    GWEN_DATE *gwenFromDate = Utils::qDateToGwenDate(from);
-    GWEN_DATE *gwenToDate = Utils::qDateToGwenDate(to);
+    if (token.isCancelled()) {
+        return {};
+    }
 
-    auto accountInfo = d_ptr->createImExporterAccountInfo((AB_TRANSACTION_COMMAND) type,
-                                                          account->uniqueId(),
-                                                          gwenFromDate,
-                                                          gwenToDate);
+    const auto context = d_ptr->createImExporterContext((AB_TRANSACTION_COMMAND) type,
+                                                        account->uniqueId(),
+                                                        from,
+                                                        to);
 
-    GWEN_Date_free(gwenFromDate);
-    GWEN_Date_free(gwenToDate);
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    auto transactionList = d_ptr->transactions(context.get(),
+                                               &reporter,
+                                               reporter.addTask(tr("Load transactions")),
+                                               token);
+    reporter.finish();
+
+    return transactionList;
+}
 
-    auto transactionList = d_ptr->transactions(accountInfo,
-                                               (AB_TRANSACTION_COMMAND) type,
-                                               [&](qreal value) -> void { Q_EMIT progress(value); });
+AccountSyncResults OnlineBanking::synchronize(const AccountList &accounts,
+                                              const QDate &from,
+                                              const QDate &to,
+                                              const CancellationToken &token)
+{
+    const auto dateError = d_ptr->validateDate(from, to);
+    if (!dateError.isEmpty()) {
+        Q_EMIT error(dateError);
+        return {};
+    }
 
-    AB_ImExporterAccountInfo_free(accountInfo);
+    AccountDateIntervals ranges = {};
+    for (const auto account : accounts) {
+        ranges.insert(account->uniqueId(), {{from, to}});
+    }
 
-    return transactionList;
+    return synchronize(accounts, ranges, token);
 }
 
-TransactionList banking::OnlineBanking::importTransactionsFromFile(const QString &importerName,
-                                                                   const QString &profileName,
-                                                                   const QString &fileName)
+AccountSyncResults OnlineBanking::synchronize(const AccountList &accounts,
+                                              const AccountDateIntervals &ranges,
+                                              const CancellationToken &token,
+                                              const bool includeBalances)
 {
-    const auto dbProfile = AB_Banking_GetImExporterProfile(d_ptr->abBanking(),
-                                                           importerName.toLatin1().constData(),
-                                                           profileName.toLatin1().constData());
-    if (dbProfile == Q_NULLPTR) {
+    if (!d_ptr->isInitialized()) {
+        Q_EMIT error(Private::l10n::OnlineBankingNotInitialized());
+        return {};
+    }
+
+    AccountSyncResults results = {};
+    const CommandListHandle commands(AB_Transaction_List2_new());
+    int commandCount = 0;
+
+    const auto transport = d_ptr->transport();
+    const GwenDateHandle gwenCurrentDate(Utils::qDateToGwenDate(QDate::currentDate()));
+
+    for (const auto account : accounts) {
+        auto &result = results[account->uniqueId()];
+        result.accountId = account->uniqueId();
+
+        if (!account->isValid()) {
+            result.errorMessage = Private::l10n::OnlineBankingAccountNotValid();
+            continue;
+        }
+
+        const int accountCommandCount = commandCount;
+        if (includeBalances
+            && transport->isCommandSupported(account, AB_Transaction_CommandGetBalance)) {
+            AB_Transaction_List2_PushBack(commands.get(),
+                                          Private::createCommand(AB_Transaction_CommandGetBalance,
+                                                                 account->uniqueId(),
+                                                                 Q_NULLPTR,
+                                                                 gwenCurrentDate.get()));
+            ++commandCount;
+        }
+
+        // One command per requested range, all of them in the same job list
+        const auto intervals = ranges.value(account->uniqueId());
+        if (transport->isCommandSupported(account, AB_Transaction_CommandGetTransactions)) {
+            for (const auto &interval : intervals) {
+                if (!d_ptr->validateDate(interval.from, interval.to).isEmpty()) {
+                    continue;
+                }
+
+                const GwenDateHandle gwenFromDate(Utils::qDateToGwenDate(interval.from));
+                const GwenDateHandle gwenToDate(Utils::qDateToGwenDate(interval.to));
+                AB_Transaction_List2_PushBack(commands.get(),
+                                              Private::createCommand(
+                                                  AB_Transaction_CommandGetTransactions,
+                                                  account->uniqueId(),
+                                                  gwenFromDate.get(),
+                                                  gwenToDate.get()));
+                result.fetchedIntervals.append(interval);
+                ++commandCount;
+            }
+        }
+
+        if (commandCount == accountCommandCount) {
+            result.errorMessage = Private::l10n::OnlineBankingAccountTransactionLimitNotSupported();
+        }
+    }
+
+    if (commandCount == 0 || token.isCancelled()) {
+        return results;
+    }
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int sendTask = reporter.addTask(tr("Synchronize accounts"), 1, 0.8);
+    const int readTask = reporter.addTask(tr("Read account data"), 0, 0.2);
+
+    // Commands for the same bank share one dialog
+    const ImExporterContextHandle context(AB_ImExporterContext_new());
+    const int sendResult = transport->sendCommands(commands.get(), context.get());
+    reporter.finishTask(sendTask);
+
+    d_ptr->readSyncResults(context.get(), results, &reporter, readTask, token);
+    reporter.finish();
+
+    if (token.isCancelled()) {
+        for (auto &result : results) {
+            qDeleteAll(result.balances);
+            qDeleteAll(result.transactions);
+        }
         return {};
     }
 
-    auto imExporterCtx = AB_ImExporterContext_new();
+    // Failing commands don't discard the answers of the others, but the job
+    // list doesn't tell which ranges were answered, so none counts as fetched.
+    if (sendResult < 0) {
+        Q_EMIT error(Private::l10n::OnlineBankingAccountError());
+        for (auto &result : results) {
+            result.fetchedIntervals.clear();
+            if (result.errorMessage.isEmpty()) {
+                result.errorMessage = Private::l10n::OnlineBankingAccountError();
+            }
+        }
+    }
+
+    return results;
+}
+
+void OnlineBanking::setTransport(BankingTransport *transport)
+{
+    d_ptr->setTransport(transport);
+}
+
+ImExporterContextHandle OnlineBanking::importContextFromFile(const QString &importerName,
+                                                             const QString &profileName,
+                                                             const QString &fileName)
+{
+    const GwenDbHandle dbProfile(
+        AB_Banking_GetImExporterProfile(d_ptr->abBanking(),
+                                        importerName.toLatin1().constData(),
+                                        profileName.toLatin1().constData()));
+    if (dbProfile.isNull()) {
+        return ImExporterContextHandle();
+    }
+
+    ImExporterContextHandle imExporterCtx(AB_ImExporterContext_new());
     const int result = AB_Banking_ImportFromFile(d_ptr->abBanking(),
                                                  importerName.toLatin1().constData(),
-                                                 imExporterCtx,
+                                                 imExporterCtx.get(),
                                                  fileName.toLatin1().constData(),
-                                                 dbProfile);
+                                                 dbProfile.get());
     if (result != AB_SUCCESS) {
-        return {};
+        return ImExporterContextHandle();
     }
 
-    const auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(imExporterCtx);
-    if (accountInfo == Q_NULLPTR) {
-        return {};
+    return imExporterCtx;
+}
+
+TransactionList OnlineBanking::takeTransactions(AB_IMEXPORTER_CONTEXT *context, const int limit)
+{
+    TransactionList transactions = {};
+
+    auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(context);
+    while (accountInfo && (limit < 0 || transactions.size() < limit)) {
+        Private::takeTransactions(accountInfo,
+                                  transactions,
+                                  Q_NULLPTR,
+                                  -1,
+                                  CancellationToken(),
+                                  limit < 0 ? -1 : limit - transactions.size());
+        accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
+    }
+
+    return transactions;
+}
+
+int OnlineBanking::importTransactionsFromFile(const QString &importerName,
+                                              const QString &profileName,
+                                              const QString &fileName,
+                                              const TransactionBatchHandler &handler,
+                                              const CancellationToken &token)
+{
+    const auto imExporterCtx = importContextFromFile(importerName, profileName, fileName);
+    if (imExporterCtx.isNull()) {
+        return -1;
     }
 
-    auto transactionList = d_ptr->transactions(accountInfo,
-                                               AB_Transaction_CommandGetTransactions,
-                                               [&](qreal value) -> void { Q_EMIT progress(value); });
+    const int total = Private::transactionCount(imExporterCtx.get());
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Read transactions"), total);
+
+    // Statements and standing orders share the transaction list of the file.
+    // The context shrinks with every batch taken out of it.
+    int count = 0;
+    auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(imExporterCtx.get());
+    while (accountInfo && !token.isCancelled()) {
+        TransactionList batch = {};
+        batch.reserve(StorageImportBatchSize);
+        Private::takeTransactions(accountInfo,
+                                  batch,
+                                  &reporter,
+                                  task,
+                                  token,
+                                  StorageImportBatchSize);
+        if (batch.isEmpty()) {
+            accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
+            continue;
+        }
 
-    transactionList << d_ptr->transactions(accountInfo,
-                                           AB_Transaction_CommandGetStandingOrders,
-                                           [&](qreal value) -> void { Q_EMIT progress(value); });
+        count += batch.size();
+        if (!handler(batch, total)) {
+            break;
+        }
+    }
+    reporter.finish();
 
-    AB_ImExporterAccountInfo_free(accountInfo);
-    AB_ImExporterContext_free(imExporterCtx);
+    return count;
+}
 
-    GWEN_DB_Group_free(dbProfile);
+bool OnlineBanking::exportTransactionsToFile(const QString &exporterName,
+                                            const QString &profileName,
+                                            const TransactionList &transactions,
+                                            const QString &fileName)
+{
+    const GwenDbHandle dbProfile(
+        AB_Banking_GetImExporterProfile(d_ptr->abBanking(),
+                                        exporterName.toLatin1().constData(),
+                                        profileName.toLatin1().constData()));
+    if (dbProfile.isNull()) {
+        return false;
+    }
 
-    return transactionList;
+    // The context takes the ownership of the copies
+    ImExporterContextHandle imExporterCtx(AB_ImExporterContext_new());
+    for (const auto transaction : transactions) {
+        AB_ImExporterContext_AddTransaction(imExporterCtx.get(), transaction->dup());
+    }
+
+    const int result = AB_Banking_ExportToFile(d_ptr->abBanking(),
+                                               exporterName.toLatin1().constData(),
+                                               imExporterCtx.get(),
+                                               fileName.toLocal8Bit().constData(),
+                                               dbProfile.get());
+
+    return result == AB_SUCCESS;
+}
+
+void OnlineBanking::connectProgress(ProgressReporter *reporter)
+{
+    connect(reporter, &ProgressReporter::progress, this, &OnlineBanking::progress);
+    connect(reporter, &ProgressReporter::stateChanged, this, &OnlineBanking::progressChanged);
 }
@@ -22,12 +22,18 @@
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
 
+#include "core/BankingHandle.h"
 #include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
 #include "core/Singleton.h"
 
 namespace olbaflinx::core::banking {
 
 using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+
+class BankingTransport;
 
 class OnlineBanking : public QObject, public Singleton<OnlineBanking>
 {
@@ -63,20 +69,82 @@ public:
     TransactionList transactions(const Account *account,
                                  const QDate &from = QDate::currentDate().addDays(-28),
                                  const QDate &to = QDate::currentDate(),
-                                 const TransactionListType &type = OnlineBanking::TransactionsType);
-
-    TransactionList importTransactionsFromFile(const QString &importerName,
-                                               const QString &profileName,
-                                               const QString &fileName);
+                                 const TransactionListType &type = OnlineBanking::TransactionsType,
+                                 const CancellationToken &token = CancellationToken());
+
+    /**
+     * Balances and transactions of all given accounts from one job list, so
+     * each bank is asked in a single dialog and the answers are read in one
+     * pass. Accounts which can't be synchronized carry an error message.
+     */
+    AccountSyncResults synchronize(const AccountList &accounts,
+                                   const QDate &from = QDate::currentDate().addDays(-28),
+                                   const QDate &to = QDate::currentDate(),
+                                   const CancellationToken &token = CancellationToken());
+
+    /**
+     * Same as above with date ranges per account, the balance is asked for
+     * once and the transactions for each range. Accounts without ranges only
+     * get their balance, without `includeBalances` only the ranges are asked for.
+     */
+    AccountSyncResults synchronize(const AccountList &accounts,
+                                   const AccountDateIntervals &ranges,
+                                   const CancellationToken &token = CancellationToken(),
+                                   const bool includeBalances = true);
+
+    /**
+     * Takes the ownership, Q_NULLPTR goes back to sending through aqbanking.
+     */
+    void setTransport(BankingTransport *transport);
+
+    /**
+     * Parses the file into a context owned by the caller, null if it couldn't
+     * be read. aqbanking isn't thread-safe, so this has to be called from the
+     * GUI thread; the context can be read on any thread afterwards.
+     */
+    ImExporterContextHandle importContextFromFile(const QString &importerName,
+                                                  const QString &profileName,
+                                                  const QString &fileName);
+
+    /**
+     * Moves at most `limit` transactions out of the context, all of them with
+     * a negative limit.
+     */
+    static TransactionList takeTransactions(AB_IMEXPORTER_CONTEXT *context, const int limit = -1);
+
+    /**
+     * Imports the file and hands its transactions to `handler` in batches of
+     * `StorageImportBatchSize`. Each batch is moved out of the parsed file, so
+     * the transactions exist only once while they are stored. Returns the
+     * number of transactions handed over or -1 if the file couldn't be read.
+     */
+    int importTransactionsFromFile(const QString &importerName,
+                                   const QString &profileName,
+                                   const QString &fileName,
+                                   const TransactionBatchHandler &handler,
+                                   const CancellationToken &token = CancellationToken());
+
+    /**
+     * Writes the transactions with the given aqbanking exporter, the
+     * transactions stay with the caller. Like the import this has to be called
+     * from the GUI thread.
+     */
+    bool exportTransactionsToFile(const QString &exporterName,
+                                  const QString &profileName,
+                                  const TransactionList &transactions,
+                                  const QString &fileName);
 
 Q_SIGNALS:
     void progress(qreal progress);
+    void progressChanged(const ProgressState &state);
     void error(const QString &message);
 
 protected:
     OnlineBanking();
     Q_DISABLE_COPY(OnlineBanking)
 
+    void connectProgress(ProgressReporter *reporter);
+
 private:
     class Private;
     QScopedPointer<Private> d_ptr;
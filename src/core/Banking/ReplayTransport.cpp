@@ -0,0 +1,109 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QSet>
+
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/error.h>
+
+#include "ReplayTransport.h"
+
+using namespace olbaflinx::core::banking;
+
+ReplayTransport::ReplayTransport(const QString &fileName)
+    : m_fileName(fileName)
+    , m_sendCount(0)
+    , m_commands({})
+{ }
+
+bool ReplayTransport::isCommandSupported(const Account *account,
+                                         const AB_TRANSACTION_COMMAND command) const
+{
+    Q_UNUSED(account)
+    Q_UNUSED(command)
+
+    return true;
+}
+
+int ReplayTransport::sendCommands(AB_TRANSACTION_LIST2 *commands, AB_IMEXPORTER_CONTEXT *context)
+{
+    ++m_sendCount;
+    m_commands.clear();
+
+    QSet<quint32> accountIds = {};
+    auto iterator = AB_Transaction_List2_First(commands);
+    if (iterator) {
+        auto command = AB_Transaction_List2Iterator_Data(iterator);
+        while (command) {
+            const quint32 accountId = AB_Transaction_GetUniqueAccountId(command);
+            m_commands << BankingCommand(accountId, AB_Transaction_GetCommand(command));
+            accountIds.insert(accountId);
+
+            command = AB_Transaction_List2Iterator_Next(iterator);
+        }
+        AB_Transaction_List2Iterator_free(iterator);
+    }
+
+    const QByteArray fileName = m_fileName.toLocal8Bit();
+    GWEN_DB_NODE *db = GWEN_DB_Group_new("context");
+    if (GWEN_DB_ReadFile(db, fileName.constData(), GWEN_DB_FLAGS_DEFAULT) < 0) {
+        GWEN_DB_Group_free(db);
+        return GWEN_ERROR_IO;
+    }
+
+    AB_IMEXPORTER_CONTEXT *recorded = AB_ImExporterContext_fromDb(db);
+    GWEN_DB_Group_free(db);
+    if (recorded == Q_NULLPTR) {
+        return GWEN_ERROR_BAD_DATA;
+    }
+
+    auto accountInfo = AB_ImExporterContext_GetFirstAccountInfo(recorded);
+    while (accountInfo) {
+        if (accountIds.contains(AB_ImExporterAccountInfo_GetAccountId(accountInfo))) {
+            AB_ImExporterContext_AddAccountInfo(context, AB_ImExporterAccountInfo_dup(accountInfo));
+        }
+        accountInfo = AB_ImExporterAccountInfo_List_Next(accountInfo);
+    }
+    AB_ImExporterContext_free(recorded);
+
+    return 0;
+}
+
+int ReplayTransport::sendCount() const
+{
+    return m_sendCount;
+}
+
+QVector<BankingCommand> ReplayTransport::commands() const
+{
+    return m_commands;
+}
+
+bool ReplayTransport::record(const AB_IMEXPORTER_CONTEXT *context, const QString &fileName)
+{
+    GWEN_DB_NODE *db = GWEN_DB_Group_new("context");
+    if (AB_ImExporterContext_toDb(context, db) < 0) {
+        GWEN_DB_Group_free(db);
+        return false;
+    }
+
+    const QByteArray localFileName = fileName.toLocal8Bit();
+    const int result = GWEN_DB_WriteFile(db, localFileName.constData(), GWEN_DB_FLAGS_DEFAULT);
+    GWEN_DB_Group_free(db);
+
+    return result == 0;
+}
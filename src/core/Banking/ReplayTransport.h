@@ -0,0 +1,58 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_REPLAYTRANSPORT_H
+#define OLBAFLINX_REPLAYTRANSPORT_H
+
+#include <QtCore/QPair>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include "core/Banking/BankingTransport.h"
+
+namespace olbaflinx::core::banking {
+
+typedef QPair<quint32, AB_TRANSACTION_COMMAND> BankingCommand;
+
+/**
+ * Stand-in for the banks: answers every job list from a context recorded
+ * with `record`, limited to the accounts the commands ask for. The commands
+ * of each call are kept, so tests can check what would have been sent.
+ */
+class ReplayTransport : public BankingTransport
+{
+public:
+    explicit ReplayTransport(const QString &fileName);
+
+    [[nodiscard]] bool isCommandSupported(const Account *account,
+                                          const AB_TRANSACTION_COMMAND command) const override;
+    int sendCommands(AB_TRANSACTION_LIST2 *commands, AB_IMEXPORTER_CONTEXT *context) override;
+
+    [[nodiscard]] int sendCount() const;
+    [[nodiscard]] QVector<BankingCommand> commands() const;
+
+    static bool record(const AB_IMEXPORTER_CONTEXT *context, const QString &fileName);
+
+private:
+    QString m_fileName;
+    int m_sendCount;
+    QVector<BankingCommand> m_commands;
+};
+
+} // namespace olbaflinx::core::banking
+
+#endif //OLBAFLINX_REPLAYTRANSPORT_H
@@ -0,0 +1,225 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QSaveFile>
+
+#include "core/Banking/OnlineBanking.h"
+#include "core/Statement/StatementWriter.h"
+#include "core/Storage/Transaction/TransactionCursor.h"
+#include "core/Storage/VaultStorage.h"
+
+#include "StatementExporter.h"
+
+using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::statement;
+using namespace olbaflinx::core::storage;
+
+class StatementExporter::Private
+{
+public:
+    explicit Private() = default;
+    ~Private() = default;
+
+    static TransactionQuery accountQuery(const TransactionQuery &filter, const quint32 accountId)
+    {
+        TransactionQuery query = filter;
+        query.accountId = accountId;
+        query.sortKey = SortByValutaDate;
+        query.sortOrder = Qt::AscendingOrder;
+        return query;
+    }
+
+    static QString partFileName(const QString &fileName, const int part)
+    {
+        if (part == 0) {
+            return fileName;
+        }
+
+        const QFileInfo info(fileName);
+        const QString baseName = QString("%1/%2-%3")
+                                     .arg(info.path(), info.baseName())
+                                     .arg(part + 1);
+        const QString suffix = info.completeSuffix();
+        return suffix.isEmpty() ? baseName : QString("%1.%2").arg(baseName, suffix);
+    }
+
+    static int write(const StatementWriter::Format format,
+                     const AccountList &accounts,
+                     const TransactionQuery &filter,
+                     const QString &fileName,
+                     ProgressReporter *reporter,
+                     const int task,
+                     const CancellationToken &token)
+    {
+        const QScopedPointer<StatementWriter> writer(StatementWriter::create(format));
+
+        // The previous file stays untouched until the export is complete
+        QSaveFile file(fileName);
+        if (writer.isNull() || !file.open(QIODevice::WriteOnly) || !writer->begin(&file)) {
+            return -1;
+        }
+
+        int count = 0;
+        for (const auto account : accounts) {
+            if (token.isCancelled()) {
+                break;
+            }
+
+            TransactionCursor cursor(accountQuery(filter, account->uniqueId()));
+            TransactionList page = cursor.next();
+            if (page.isEmpty()) {
+                continue;
+            }
+
+            const auto first = page.first();
+            const QDate firstDate = first->valutaDate().isValid() ? first->valutaDate()
+                                                                  : first->date();
+            writer->beginAccount(account,
+                                 filter.fromDate.isValid() ? filter.fromDate : firstDate,
+                                 filter.toDate.isValid() ? filter.toDate : QDate::currentDate());
+
+            while (!page.isEmpty()) {
+                for (const auto transaction : qAsConst(page)) {
+                    writer->write(transaction);
+                }
+
+                count += page.size();
+                reporter->advance(task, page.size());
+                qDeleteAll(page);
+
+                page = token.isCancelled() ? TransactionList() : cursor.next();
+            }
+
+            writer->endAccount();
+        }
+
+        if (!writer->end() || token.isCancelled()) {
+            file.cancelWriting();
+            return -1;
+        }
+
+        return file.commit() ? count : -1;
+    }
+
+    template<typename T> static T waitFor(QFuture<T> future)
+    {
+        QEventLoop loop;
+        QFutureWatcher<T> watcher;
+        QObject::connect(&watcher, &QFutureWatcher<T>::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(future);
+        if (!future.isFinished()) {
+            loop.exec();
+        }
+        return future.result();
+    }
+};
+
+StatementExporter::StatementExporter()
+    : QObject(Q_NULLPTR)
+    , d_ptr(new Private())
+{ }
+
+StatementExporter::~StatementExporter()
+{
+    d_ptr.reset();
+}
+
+int StatementExporter::exportTransactions(const TransactionQuery &filter,
+                                          const QString &exporterName,
+                                          const QString &profileName,
+                                          const QString &fileName,
+                                          const CancellationToken &token)
+{
+    const auto storage = VaultStorage::instance();
+
+    AccountList accounts = {};
+    for (const auto account : storage->accounts()) {
+        if (filter.accountId == 0 || account->uniqueId() == filter.accountId) {
+            accounts << account;
+        } else {
+            delete account;
+        }
+    }
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Export transactions"), storage->transactionCount(filter));
+
+    int count = 0;
+    const auto format = StatementWriter::format(exporterName);
+    if (format != StatementWriter::UnknownFormat) {
+        count = Private::waitFor(QtConcurrent::run([&]() -> int {
+            return Private::write(format, accounts, filter, fileName, &reporter, task, token);
+        }));
+    } else {
+        // aqbanking isn't thread-safe, the parts are written on this thread and
+        // only the pages are read on the pool
+        int part = 0;
+        TransactionList transactions = {};
+        const auto writePart = [&]() -> bool {
+            const bool success = OnlineBanking::instance()->exportTransactionsToFile(
+                exporterName, profileName, transactions, Private::partFileName(fileName, part++));
+            qDeleteAll(transactions);
+            transactions.clear();
+            return success;
+        };
+
+        for (const auto account : qAsConst(accounts)) {
+            TransactionCursor cursor(Private::accountQuery(filter, account->uniqueId()));
+            while (count >= 0 && !cursor.atEnd() && !token.isCancelled()) {
+                const TransactionList page = Private::waitFor(
+                    QtConcurrent::run([&cursor]() { return cursor.next(); }));
+                transactions << page;
+                count += page.size();
+                reporter.advance(task, page.size());
+
+                if (transactions.size() >= StatementExportPartSize && !writePart()) {
+                    count = -1;
+                }
+            }
+        }
+
+        if (token.isCancelled() || (count > 0 && !transactions.isEmpty() && !writePart())) {
+            count = -1;
+        }
+        qDeleteAll(transactions);
+
+        // Parts of a cancelled or failed export are incomplete
+        if (count < 0) {
+            for (int i = 0; i < part; ++i) {
+                QFile::remove(Private::partFileName(fileName, i));
+            }
+        }
+    }
+
+    reporter.finish();
+    qDeleteAll(accounts);
+
+    return count;
+}
+
+void StatementExporter::connectProgress(ProgressReporter *reporter)
+{
+    connect(reporter, &ProgressReporter::progress, this, &StatementExporter::progress);
+    connect(reporter, &ProgressReporter::stateChanged, this, &StatementExporter::progressChanged);
+}
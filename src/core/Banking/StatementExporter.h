@@ -0,0 +1,84 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_STATEMENTEXPORTER_H
+#define OLBAFLINX_STATEMENTEXPORTER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+
+#include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
+#include "core/Singleton.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
+
+namespace olbaflinx::core::banking {
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+using namespace olbaflinx::core::storage::transaction;
+
+/**
+ * Exports the transactions of the vault page by page: the next page is read
+ * on a reader thread while the current one is written, so memory stays flat
+ * however many transactions match the filter.
+ */
+class StatementExporter : public QObject, public Singleton<StatementExporter>
+{
+    Q_OBJECT
+    friend class Singleton<StatementExporter>;
+
+public:
+    ~StatementExporter() override;
+
+    /**
+     * Writes all transactions matching the filter, account by account in
+     * valuta date order. The native CSV, JSON Lines and OFX writers stream
+     * into the file on a worker thread and only replace it once everything
+     * was written. aqbanking exporters get the transactions in parts of
+     * `StatementExportPartSize`, every part after the first is written to
+     * "<name>-<n>.<suffix>".
+     *
+     * Returns the number of transactions written, -1 if the file couldn't be
+     * written or the export was cancelled. The parts already written by an
+     * aqbanking exporter are removed in that case.
+     */
+    int exportTransactions(const TransactionQuery &filter,
+                           const QString &exporterName,
+                           const QString &profileName,
+                           const QString &fileName,
+                           const CancellationToken &token = CancellationToken());
+
+Q_SIGNALS:
+    void progress(const qreal progress);
+    void progressChanged(const ProgressState &state);
+
+protected:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    void connectProgress(ProgressReporter *reporter);
+
+    StatementExporter();
+    Q_DISABLE_COPY(StatementExporter)
+};
+
+} // namespace olbaflinx::core::banking
+
+#endif //OLBAFLINX_STATEMENTEXPORTER_H
@@ -0,0 +1,433 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QEventLoop>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+#include "core/Banking/OnlineBanking.h"
+#include "core/Statement/CsvParser.h"
+#include "core/Statement/StatementParser.h"
+#include "core/Storage/VaultStorage.h"
+
+#include "StatementImporter.h"
+
+using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::statement;
+using namespace olbaflinx::core::storage;
+
+class StatementImporter::Private
+{
+public:
+    explicit Private()
+        : m_pool()
+    {
+        m_pool.setMaxThreadCount(qMin(QThread::idealThreadCount(), StatementImportThreads));
+    }
+
+    ~Private() { m_pool.waitForDone(); }
+
+    QThreadPool *pool() { return &m_pool; }
+
+    /**
+     * A batch whose transactions are being stored on the vault executor.
+     */
+    struct PendingBatch
+    {
+        TransactionList transactions = {};
+        QFuture<int> future = {};
+    };
+
+    /**
+     * Hands the files of a batch import to the vault executor one after
+     * another in the given order, a file waits for its turn with its first
+     * batch converted.
+     */
+    class StoreOrder
+    {
+    public:
+        void waitFor(const int turn)
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_turn < turn) {
+                m_changed.wait(&m_mutex);
+            }
+        }
+
+        void finish(const int turn)
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_turn < turn) {
+                m_changed.wait(&m_mutex);
+            }
+            m_turn = turn + 1;
+            m_changed.wakeAll();
+        }
+
+    private:
+        QMutex m_mutex;
+        QWaitCondition m_changed;
+        int m_turn = 0;
+    };
+
+    struct StoredFile
+    {
+        int found = 0;
+        int inserted = 0;
+        bool success = true;
+    };
+
+    struct PendingFile
+    {
+        int index = -1;
+        QFuture<StoredFile> future = {};
+    };
+
+    typedef std::function<bool(const TransactionBatchHandler &)> FileReader;
+
+    /**
+     * Runs on the pool: hashes the batches `read` hands over and stores them
+     * once it is the turn of the file. The previous batch is stored while the
+     * next one is read, so only these two batches of the file are held.
+     */
+    static StoredFile storeFile(QObject *receiver,
+                                StoreOrder *order,
+                                const int turn,
+                                const quint32 accountId,
+                                const FileReader &read,
+                                const CancellationToken &token)
+    {
+        StoredFile file;
+        PendingBatch stored;
+        bool hasTurn = false;
+
+        const auto finishStored = [&]() {
+            if (stored.transactions.isEmpty()) {
+                return;
+            }
+
+            const int inserted = stored.future.result();
+            if (inserted < 0) {
+                file.success = false;
+            } else {
+                file.inserted += inserted;
+            }
+            qDeleteAll(stored.transactions);
+            stored = PendingBatch();
+        };
+
+        const auto handler = [&](const TransactionList &batch, int) -> bool {
+            for (const auto transaction : batch) {
+                transaction->fingerprint();
+            }
+
+            if (!hasTurn) {
+                order->waitFor(turn);
+                hasTurn = true;
+            }
+            finishStored();
+
+            file.found += batch.size();
+            stored.transactions = batch;
+
+            // The vault publishes the change from the thread it lives on
+            QMetaObject::invokeMethod(
+                receiver,
+                [&]() {
+                    stored.future = VaultStorage::instance()->queueTransactions(accountId,
+                                                                                batch,
+                                                                                token);
+                },
+                Qt::BlockingQueuedConnection);
+
+            return !token.isCancelled();
+        };
+
+        const bool isValid = read(handler);
+        finishStored();
+        order->finish(turn);
+
+        file.success = isValid && file.success;
+        return file;
+    }
+
+    /**
+     * Takes the transactions out of the aqbanking context batch by batch, the
+     * context shrinks with every batch.
+     */
+    static bool takeTransactions(AB_IMEXPORTER_CONTEXT *context,
+                                 const TransactionBatchHandler &handler,
+                                 const CancellationToken &token)
+    {
+        while (!token.isCancelled()) {
+            const auto batch = OnlineBanking::takeTransactions(context, StorageImportBatchSize);
+            if (batch.isEmpty() || !handler(batch, -1)) {
+                break;
+            }
+        }
+        return true;
+    }
+
+    template<typename T> static T waitFor(QFuture<T> future)
+    {
+        QEventLoop loop;
+        QFutureWatcher<T> watcher;
+        QObject::connect(&watcher, &QFutureWatcher<T>::finished, &loop, &QEventLoop::quit);
+        watcher.setFuture(future);
+        if (!future.isFinished()) {
+            loop.exec();
+        }
+        return future.result();
+    }
+
+    /**
+     * Waits for the store of the batch and frees its transactions.
+     */
+    static bool finish(PendingBatch &batch)
+    {
+        if (batch.transactions.isEmpty()) {
+            return true;
+        }
+
+        const bool isStored = waitFor(batch.future) >= 0;
+        qDeleteAll(batch.transactions);
+        batch = PendingBatch();
+
+        return isStored;
+    }
+
+private:
+    QThreadPool m_pool;
+};
+
+StatementImporter::StatementImporter()
+    : QObject(Q_NULLPTR)
+    , d_ptr(new Private())
+{ }
+
+StatementImporter::~StatementImporter()
+{
+    d_ptr.reset();
+}
+
+int StatementImporter::import(const quint32 &accountId,
+                              const QString &importerName,
+                              const QString &profileName,
+                              const QString &fileName,
+                              const CancellationToken &token)
+{
+    const auto read = [&](const TransactionBatchHandler &handler) -> int {
+        // MT940 and CAMT.053 files don't need the aqbanking importer
+        const QScopedPointer<StatementParser> parser(
+            StatementParser::create(StatementParser::detect(fileName)));
+        if (!parser.isNull()) {
+            return parser->parseFile(fileName, handler, token);
+        }
+
+        return OnlineBanking::instance()->importTransactionsFromFile(importerName,
+                                                                     profileName,
+                                                                     fileName,
+                                                                     handler,
+                                                                     token);
+    };
+
+    return importBatches(accountId, read, token);
+}
+
+int StatementImporter::importCsv(const quint32 &accountId,
+                                 const CsvProfile &profile,
+                                 const QString &fileName,
+                                 const CancellationToken &token)
+{
+    const auto read = [&](const TransactionBatchHandler &handler) -> int {
+        CsvParser parser(profile);
+        return parser.parseFile(fileName, handler, token);
+    };
+
+    return importBatches(accountId, read, token);
+}
+
+StatementImportReport StatementImporter::importFiles(const quint32 &accountId,
+                                                     const QString &importerName,
+                                                     const QString &profileName,
+                                                     const QStringList &fileNames,
+                                                     const CancellationToken &token)
+{
+    StatementImportReport report;
+    for (const auto &fileName : fileNames) {
+        StatementFileReport fileReport;
+        fileReport.fileName = fileName;
+        report.files << fileReport;
+    }
+
+    const auto storage = VaultStorage::instance();
+    if (fileNames.isEmpty() || !storage->isStorageValid()) {
+        return report;
+    }
+
+    QElapsedTimer elapsed;
+    elapsed.start();
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Import files"), fileNames.size());
+
+    Private::StoreOrder order;
+    QObject receiver;
+    QList<Private::PendingFile> pending = {};
+
+    // Stored in file order, so the first file of a transaction counts it as
+    // new and every later one as duplicate
+    const auto finish = [&](const Private::PendingFile &file) {
+        const auto stored = Private::waitFor(file.future);
+
+        auto &fileReport = report.files[file.index];
+        fileReport.found = stored.found;
+        fileReport.inserted = stored.inserted;
+        fileReport.duplicates = stored.found - stored.inserted;
+        fileReport.success = stored.success;
+
+        reporter.advance(task);
+    };
+
+    const auto banking = OnlineBanking::instance();
+    const int maxPending = d_ptr->pool()->maxThreadCount();
+
+    int turn = 0;
+    for (int index = 0; index < fileNames.size() && !token.isCancelled(); ++index) {
+        const QString fileName = fileNames.at(index);
+
+        Private::PendingFile file;
+        file.index = index;
+
+        // Native formats are read on the pool, other files only after
+        // aqbanking read them on this thread
+        const auto format = StatementParser::detect(fileName);
+        if (format != StatementParser::UnknownFormat) {
+            file.future = QtConcurrent::run(d_ptr->pool(), [&, turn, format, fileName]() {
+                const QScopedPointer<StatementParser> parser(StatementParser::create(format));
+                const auto read = [&](const TransactionBatchHandler &handler) {
+                    return parser->parseFile(fileName, handler, token) >= 0;
+                };
+                return Private::storeFile(&receiver, &order, turn, accountId, read, token);
+            });
+        } else {
+            auto context = banking->importContextFromFile(importerName, profileName, fileName);
+            if (context.isNull()) {
+                reporter.advance(task);
+                continue;
+            }
+
+            const auto abContext = context.release();
+            file.future = QtConcurrent::run(d_ptr->pool(), [&, turn, abContext]() {
+                const ImExporterContextHandle owned(abContext);
+                const auto read = [&](const TransactionBatchHandler &handler) {
+                    return Private::takeTransactions(owned.get(), handler, token);
+                };
+                return Private::storeFile(&receiver, &order, turn, accountId, read, token);
+            });
+        }
+        pending << file;
+        ++turn;
+
+        // Every file in flight has a thread, a file waiting for its turn
+        // never holds back the one before
+        while (!pending.isEmpty()
+               && (pending.first().future.isFinished() || pending.size() >= maxPending)) {
+            finish(pending.takeFirst());
+        }
+    }
+
+    while (!pending.isEmpty()) {
+        finish(pending.takeFirst());
+    }
+    reporter.finish();
+
+    for (const auto &fileReport : qAsConst(report.files)) {
+        report.found += fileReport.found;
+        report.inserted += fileReport.inserted;
+        report.duplicates += fileReport.duplicates;
+    }
+
+    report.elapsed = elapsed.elapsed();
+    report.throughput = report.found * 1000.0 / qMax<qint64>(1, report.elapsed);
+
+    return report;
+}
+
+QStringList StatementImporter::statementFiles(const QString &directory)
+{
+    QStringList fileNames = {};
+
+    const auto entries = QDir(directory).entryInfoList(QDir::Files | QDir::Readable, QDir::Name);
+    for (const auto &entry : entries) {
+        fileNames << entry.absoluteFilePath();
+    }
+
+    return fileNames;
+}
+
+int StatementImporter::importBatches(
+    const quint32 &accountId,
+    const std::function<int(const TransactionBatchHandler &)> &read,
+    const CancellationToken &token)
+{
+    const auto storage = VaultStorage::instance();
+    if (!storage->isStorageValid()) {
+        return -1;
+    }
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Import transactions"));
+
+    bool success = true;
+    Private::PendingBatch stored;
+    const auto handler = [&](const TransactionList &batch, const int total) -> bool {
+        if (total >= 0) {
+            reporter.setTaskTotal(task, total);
+        }
+
+        // The previous batch is stored while this one was read
+        const int storedCount = stored.transactions.size();
+        success = Private::finish(stored) && success;
+        reporter.advance(task, storedCount);
+
+        stored.transactions = batch;
+        stored.future = storage->queueTransactions(accountId, batch, token);
+
+        return !token.isCancelled();
+    };
+
+    const int count = read(handler);
+    success = Private::finish(stored) && success;
+    reporter.finish();
+
+    return (success || token.isCancelled()) ? count : -1;
+}
+
+void StatementImporter::connectProgress(ProgressReporter *reporter)
+{
+    connect(reporter, &ProgressReporter::progress, this, &StatementImporter::progress);
+    connect(reporter, &ProgressReporter::stateChanged, this, &StatementImporter::progressChanged);
+}
@@ -0,0 +1,142 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_STATEMENTIMPORTER_H
+#define OLBAFLINX_STATEMENTIMPORTER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
+#include "core/Singleton.h"
+#include "core/Statement/CsvProfile.h"
+
+namespace olbaflinx::core::banking {
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+
+struct StatementFileReport
+{
+    QString fileName = "";
+    int found = 0;
+    int inserted = 0;
+    int duplicates = 0;
+    bool success = false;
+};
+typedef QVector<StatementFileReport> StatementFileReports;
+
+struct StatementImportReport
+{
+    StatementFileReports files = {};
+    int found = 0;
+    int inserted = 0;
+    int duplicates = 0;
+    qint64 elapsed = 0;
+    // Transactions found per second
+    qreal throughput = 0.0;
+};
+
+/**
+ * Imports statement files into the vault as a pipeline: batches are taken
+ * out of the parsed file, hashed and stored on the vault executor while the
+ * next batch is read. At most two batches are converted at any time, no
+ * matter how many transactions the file holds.
+ */
+class StatementImporter : public QObject, public Singleton<StatementImporter>
+{
+    Q_OBJECT
+    friend class Singleton<StatementImporter>;
+
+public:
+    ~StatementImporter() override;
+
+    /**
+     * MT940 and CAMT.053 files are read by the native parsers, all other files
+     * by the given aqbanking importer.
+     *
+     * Returns the number of transactions found in the file, -1 if the file
+     * couldn't be read or not every batch was stored. Batches stored before a
+     * cancellation are kept.
+     */
+    int import(const quint32 &accountId,
+               const QString &importerName,
+               const QString &profileName,
+               const QString &fileName,
+               const CancellationToken &token = CancellationToken());
+
+    /**
+     * Reads the CSV file as laid out by the profile, the file is converted on
+     * several threads while the batches before are stored.
+     */
+    int importCsv(const quint32 &accountId,
+                  const statement::CsvProfile &profile,
+                  const QString &fileName,
+                  const CancellationToken &token = CancellationToken());
+
+    /**
+     * Imports several files at once. MT940 and CAMT.053 files are read batch
+     * by batch on a thread pool, aqbanking parses the others one after another
+     * on the calling thread while the files before are converted and hashed.
+     * The vault executor stores them in the given order, a transaction already
+     * stored from an earlier file is counted as duplicate. A file waiting for
+     * its turn holds a single batch, none is kept as a whole.
+     */
+    StatementImportReport importFiles(const quint32 &accountId,
+                                      const QString &importerName,
+                                      const QString &profileName,
+                                      const QStringList &fileNames,
+                                      const CancellationToken &token = CancellationToken());
+
+    /**
+     * Readable files of the directory sorted by name, sub directories are
+     * not searched.
+     */
+    [[nodiscard]] static QStringList statementFiles(const QString &directory);
+
+Q_SIGNALS:
+    void progress(const qreal progress);
+    void progressChanged(const ProgressState &state);
+
+protected:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    void connectProgress(ProgressReporter *reporter);
+
+    /**
+     * Stores the batches `read` hands over while it reads the next one.
+     */
+    int importBatches(const quint32 &accountId,
+                      const std::function<int(const TransactionBatchHandler &)> &read,
+                      const CancellationToken &token);
+
+    StatementImporter();
+    Q_DISABLE_COPY(StatementImporter)
+};
+
+} // namespace olbaflinx::core::banking
+
+Q_DECLARE_METATYPE(olbaflinx::core::banking::StatementFileReport)
+Q_DECLARE_METATYPE(olbaflinx::core::banking::StatementImportReport)
+
+#endif //OLBAFLINX_STATEMENTIMPORTER_H
@@ -0,0 +1,125 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_BANKINGHANDLE_H
+#define OLBAFLINX_BANKINGHANDLE_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/qglobal.h>
+
+#include <aqbanking/types/account_spec.h>
+#include <aqbanking/types/balance.h>
+#include <aqbanking/types/imexporter_context.h>
+#include <aqbanking/types/transaction.h>
+#include <aqbanking/types/value.h>
+#include <gwenhywfar/buffer.h>
+#include <gwenhywfar/db.h>
+#include <gwenhywfar/gwendate.h>
+
+namespace olbaflinx::core {
+
+/**
+ * Owns one aqbanking / gwenhywfar object and frees it with `Free` when it goes
+ * out of scope. Handles can only be moved, `release` hands the object over to
+ * aqbanking or another owner.
+ *
+ * Each handle type counts the objects it owns, a leak shows up as a count that
+ * keeps growing over repeated operations.
+ */
+template<typename T, void (*Free)(T *)> class BankingHandle
+{
+public:
+    explicit BankingHandle(T *handle = Q_NULLPTR) noexcept
+        : m_handle(Q_NULLPTR)
+    {
+        reset(handle);
+    }
+
+    ~BankingHandle() { reset(); }
+
+    BankingHandle(BankingHandle &&other) noexcept
+        : m_handle(Q_NULLPTR)
+    {
+        reset(other.release());
+    }
+
+    BankingHandle &operator=(BankingHandle &&other) noexcept
+    {
+        if (this != &other) {
+            reset(other.release());
+        }
+        return *this;
+    }
+
+    BankingHandle(const BankingHandle &) = delete;
+    BankingHandle &operator=(const BankingHandle &) = delete;
+
+    [[nodiscard]] T *get() const noexcept { return m_handle; }
+    [[nodiscard]] bool isNull() const noexcept { return m_handle == Q_NULLPTR; }
+    explicit operator bool() const noexcept { return m_handle != Q_NULLPTR; }
+
+    [[nodiscard]] T *release() noexcept
+    {
+        T *handle = m_handle;
+        if (handle != Q_NULLPTR) {
+            s_owned.fetchAndSubRelaxed(1);
+        }
+        m_handle = Q_NULLPTR;
+        return handle;
+    }
+
+    void reset(T *handle = Q_NULLPTR) noexcept
+    {
+        if (handle == m_handle) {
+            return;
+        }
+
+        if (m_handle != Q_NULLPTR) {
+            Free(m_handle);
+            s_owned.fetchAndSubRelaxed(1);
+        }
+
+        m_handle = handle;
+        if (m_handle != Q_NULLPTR) {
+            s_owned.fetchAndAddRelaxed(1);
+        }
+    }
+
+    /**
+     * Number of objects of this type currently owned by handles.
+     */
+    [[nodiscard]] static int ownedCount() noexcept { return s_owned.loadRelaxed(); }
+
+private:
+    T *m_handle;
+    static inline QAtomicInt s_owned = 0;
+};
+
+typedef BankingHandle<AB_TRANSACTION, AB_Transaction_free> TransactionHandle;
+typedef BankingHandle<AB_TRANSACTION_LIST2, AB_Transaction_List2_freeAll> CommandListHandle;
+typedef BankingHandle<AB_BALANCE, AB_Balance_free> BalanceHandle;
+typedef BankingHandle<AB_VALUE, AB_Value_free> ValueHandle;
+typedef BankingHandle<AB_ACCOUNT_SPEC, AB_AccountSpec_free> AccountSpecHandle;
+typedef BankingHandle<AB_ACCOUNT_SPEC_LIST, AB_AccountSpec_List_free> AccountSpecListHandle;
+typedef BankingHandle<AB_IMEXPORTER_CONTEXT, AB_ImExporterContext_free> ImExporterContextHandle;
+typedef BankingHandle<GWEN_DATE, GWEN_Date_free> GwenDateHandle;
+typedef BankingHandle<GWEN_DB_NODE, GWEN_DB_Group_free> GwenDbHandle;
+typedef BankingHandle<GWEN_BUFFER, GWEN_Buffer_free> GwenBufferHandle;
+
+} // namespace olbaflinx::core
+
+#endif //OLBAFLINX_BANKINGHANDLE_H
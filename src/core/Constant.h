@@ -58,6 +58,9 @@
     "   currency = excluded.currency " \
     "WHERE excluded.account_id = balances.account_id"
 
+#define StorageSqlAccountBalanceUpdateQuery \
+    "UPDATE accounts SET balance = :balance WHERE unique_id = :account_id"
+
 #define StorageSqlAccountSelectQuery "SELECT * FROM accounts"
 #define StorageSqlAccountSelectByIdQuery \
     QString("%1 WHERE id = :id").args(StorageSqlAccountSelectQuery)
@@ -102,16 +105,195 @@
     QString("%1 ORDER BY valuta_date DESC LIMIT :limit OFFSET :offset") \
         .arg(StorageSqlTransactionByAccountIdQuery)
 
+#define StorageSqlTransactionQuerySelect "SELECT %1 FROM transactions WHERE %2"
+#define StorageSqlTransactionQueryOrder " ORDER BY %1 %2, id %2"
+#define StorageSqlTransactionQueryLimit " LIMIT :limit OFFSET :offset"
+#define StorageSqlTransactionPositionColumns \
+    "id, ROW_NUMBER() OVER (ORDER BY %1 %2, id %2) - 1 AS row_position"
+#define StorageSqlTransactionPositionQuery \
+    "SELECT id, row_position FROM (%1) WHERE id IN (%2) ORDER BY row_position"
+#define StorageSqlTransactionRowColumns \
+    "id, valuta_date, remote_name, purpose, `category`, `value`, currency"
+#define StorageSqlTransactionRowsByIdsQuery \
+    QString("SELECT %1 FROM transactions WHERE id IN (%2)") \
+        .arg(StorageSqlTransactionRowColumns, "%1")
+
 #define StorageSqlTransactionExists \
     "SELECT COUNT(id) AS CNT FROM transactions WHERE account_id = :account_id AND hash = :hash"
 
+#define StorageSqlRemoteAccountInsertQuery \
+    "INSERT OR REPLACE INTO remote_accounts (iban, bic, bank_code, account_number, bank_name, " \
+    "iban_valid, account_valid, bank_known) " \
+    "VALUES (:iban, :bic, :bank_code, :account_number, :bank_name, :iban_valid, " \
+    ":account_valid, :bank_known)"
+#define StorageSqlRemoteAccountKnownQuery \
+    "SELECT iban, bic, bank_code, bank_known FROM remote_accounts WHERE iban IN (%1)"
+#define StorageSqlRemoteAccountEnrichTransactionsQuery \
+    "UPDATE transactions SET " \
+    "remote_bic = CASE WHEN remote_bic IS NULL OR remote_bic = '' " \
+    "   THEN :bic ELSE remote_bic END, " \
+    "remote_bank_code = CASE WHEN remote_bank_code IS NULL OR remote_bank_code = '' " \
+    "   THEN :bank_code ELSE remote_bank_code END " \
+    "WHERE account_id = :account_id AND remote_iban = :iban"
+
+#define StorageSqlCategoryRuleSelectQuery \
+    "SELECT id, category, fields, pattern, min_value, max_value, priority " \
+    "FROM category_rules ORDER BY priority DESC, id ASC"
+#define StorageSqlCategoryRuleInsertQuery \
+    "INSERT INTO category_rules (category, fields, pattern, min_value, max_value, priority) " \
+    "VALUES (:category, :fields, :pattern, :min_value, :max_value, :priority)"
+#define StorageSqlCategoryRuleUpdateQuery \
+    "UPDATE category_rules SET category = :category, fields = :fields, pattern = :pattern, " \
+    "min_value = :min_value, max_value = :max_value, priority = :priority WHERE id = :id"
+#define StorageSqlCategoryRuleDeleteQuery "DELETE FROM category_rules WHERE id = :id"
+
+#define StorageSqlCategoryRuleRunSelectQuery \
+    "SELECT last_transaction_id FROM category_rule_runs WHERE fingerprint = :fingerprint"
+#define StorageSqlCategoryRuleRunClearQuery \
+    "DELETE FROM category_rule_runs WHERE fingerprint <> :fingerprint"
+#define StorageSqlCategoryRuleRunUpdateQuery \
+    "INSERT OR REPLACE INTO category_rule_runs (fingerprint, last_transaction_id) " \
+    "VALUES (:fingerprint, :last_transaction_id)"
+
+#define StorageSqlWriteSavepointQuery "SAVEPOINT storage_write"
+#define StorageSqlWriteRollbackQuery "ROLLBACK TO SAVEPOINT storage_write"
+#define StorageSqlWriteReleaseQuery "RELEASE SAVEPOINT storage_write"
+
+#define StorageSqlAccountCoverageSelectQuery \
+    "SELECT from_date, to_date FROM account_coverage WHERE account_id = :account_id " \
+    "ORDER BY from_date ASC"
+#define StorageSqlAccountCoverageDeleteQuery \
+    "DELETE FROM account_coverage WHERE account_id = :account_id"
+#define StorageSqlAccountCoverageInsertQuery \
+    "INSERT INTO account_coverage (account_id, from_date, to_date) " \
+    "VALUES (:account_id, :from_date, :to_date)"
+
+#define StorageSqlTransactionCategorizeQuery \
+    "SELECT t.id, t.remote_name, t.purpose, t.remote_iban, t.`value`, t.`category`, r.rule_id, " \
+    "t.account_id, r.`category` " \
+    "FROM transactions t LEFT JOIN transaction_category_rules r ON r.transaction_id = t.id " \
+    "WHERE t.id > :last_id ORDER BY t.id ASC LIMIT :limit"
+#define StorageSqlTransactionCategoryUpdateQuery \
+    "UPDATE transactions SET `category` = :category WHERE id = :id"
+#define StorageSqlTransactionCategoryRuleInsertQuery \
+    "INSERT OR REPLACE INTO transaction_category_rules (transaction_id, rule_id, `category`) " \
+    "VALUES (:transaction_id, :rule_id, :category)"
+#define StorageSqlTransactionCategoryRuleDeleteQuery \
+    "DELETE FROM transaction_category_rules WHERE transaction_id = :transaction_id"
+#define StorageCategorizeChunkSize 1000
+#define StorageImportBatchSize 500
+#define StorageVacuumPageStep 256
+#define StorageGroupCommitSize 64
+#define StorageReaderCount 3
+#define StorageCheckpointInterval 2000
+
+/**
+ * Bank directory (Bundesbank bank code file)
+ */
+#define BankDataSqlCreateInstitutionsTable \
+    "CREATE TABLE IF NOT EXISTS institutions (" \
+    " country CHAR(2) DEFAULT 'DE' CONSTRAINT germanCountryCode NOT NULL CHECK(country == 'DE')," \
+    " bankcode CHAR(8) NOT NULL PRIMARY KEY CHECK(length(bankcode) = 8)," \
+    " bic CHAR(11)," \
+    " method CHAR(2)," \
+    " name VARCHAR(60)," \
+    " location VARCHAR(40)," \
+    " valid_upto real" \
+    " )"
+#define BankDataSqlCreateInstitutionsIndexes \
+    QStringList({"CREATE INDEX IF NOT EXISTS bic_index ON institutions (bic)", \
+                 "CREATE INDEX IF NOT EXISTS name_index ON institutions (name)", \
+                 "CREATE INDEX IF NOT EXISTS location_index ON institutions (location)", \
+                 "CREATE INDEX IF NOT EXISTS valid_upto_index ON institutions (valid_upto)"})
+
+#define BankDataSqlInstitutionSelectQuery \
+    "SELECT bankcode, bic, method, name, location, valid_upto FROM institutions"
+#define BankDataSqlInstitutionInsertQuery \
+    "INSERT INTO institutions (bankcode, bic, method, name, location, valid_upto) " \
+    "VALUES (:bankcode, :bic, :method, :name, :location, NULL)"
+#define BankDataSqlInstitutionUpdateQuery \
+    "UPDATE institutions SET bic = :bic, method = :method, name = :name, " \
+    "location = :location, valid_upto = NULL WHERE bankcode = :bankcode"
+#define BankDataSqlInstitutionExpireQuery \
+    "UPDATE institutions SET valid_upto = julianday(:valid_upto) WHERE bankcode = :bankcode"
+
+#define BankDataSqlLookupCreateQuery \
+    "CREATE TEMP TABLE IF NOT EXISTS lookup_bankcodes (bankcode CHAR(8) NOT NULL PRIMARY KEY)"
+#define BankDataSqlLookupClearQuery "DELETE FROM lookup_bankcodes"
+#define BankDataSqlLookupInsertQuery \
+    "INSERT OR IGNORE INTO lookup_bankcodes (bankcode) VALUES (:bankcode)"
+#define BankDataSqlLookupJoinQuery \
+    "SELECT i.bankcode, i.bic, i.method, i.name, i.location, i.valid_upto " \
+    "FROM institutions i INNER JOIN lookup_bankcodes l ON l.bankcode = i.bankcode"
+
+#define BankDataFileName "olbaflinx-bankdata.obfx"
+#define BankDataFileEncoding "ISO-8859-1"
+#define BankDataRecordLength 168
+
 /**
  * Group & Key for settings
  */
 #define StorageSettingGroup "Vaults"
 #define StorageSettingGroupKey "Paths"
 
+/**
+ * Transaction search
+ */
+#define SearchDebounceInterval 250
+#define SearchResultBatchSize 200
+#define SearchCancelCheckInterval 256
+#define SearchIndexChunkSize 2000
+#define SearchNarrowingLimit 10000
+
+/**
+ * Transaction view model paging
+ */
+#define TransactionPageSize 100
+#define TransactionPageCacheSize 12
+#define TransactionPrefetchPages 2
+
+/**
+ * Shared transaction cache of the vault (bytes)
+ */
+#define TransactionCacheMemoryBudget (64 * 1024 * 1024)
+#define TransactionCacheSettingKey "TransactionCacheMemoryBudget"
+
+/**
+ * Progress reporting of long running operations (ms)
+ */
+#define ProgressReportInterval 100
+
 #define MaxDateForTransactionsWithoutPin -28
+
+/**
+ * Historical backfill: days fetched per window and the settings group of the
+ * backfill targets per account
+ */
+#define BackfillWindowDays 90
+#define BackfillSettingsGroup "Backfill"
+
+/**
+ * Batch import of statement files: files read and stored at the same time
+ */
+#define StatementImportThreads 4
+
+/**
+ * CSV import: bytes scanned per chunk, chunks converted at the same time per
+ * thread and the settings group of the column mapping profiles
+ */
+#define CsvChunkSize (4 * 1024 * 1024)
+#define CsvPendingChunksPerThread 2
+#define CsvProfileSettingsGroup "CsvProfiles"
+
+/**
+ * Export of the vault: transactions read per page, transactions per file of an
+ * aqbanking exporter and the names of the native im- / exporters
+ */
+#define StatementExportPageSize 1000
+#define StatementExportPartSize 50000
+#define CsvImExporterName "OlbaFlinx CSV"
+#define JsonLinesExporterName "OlbaFlinx JSON Lines"
+#define OfxExporterName "OlbaFlinx OFX"
 #define GwenDateFormat "yyyyMMdd"
 #define DateTimeFormat "dd.MM.yyyy hh:mm"
 
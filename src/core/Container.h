@@ -18,14 +18,18 @@
 #ifndef OLBAFLINX_CONTAINER_H
 #define OLBAFLINX_CONTAINER_H
 
+#include <QtCore/QHash>
 #include <QtCore/QObject>
 #include <QtCore/QRegularExpression>
 #include <QtCore/QVector>
 #include <QtGui/QImage>
 
+#include <functional>
+
 #include "core/Constant.h"
 #include "core/Storage/Account/Account.h"
 #include "core/Storage/Account/AccountBalance.h"
+#include "core/Storage/Account/AccountCoverage.h"
 #include "core/Storage/Transaction/Transaction.h"
 
 namespace olbaflinx::core {
@@ -38,6 +42,13 @@ typedef QVector<const AccountBalance *> AccountBalanceList;
 typedef QVector<const Transaction *> TransactionList;
 typedef QVector<quint32> AccountIds;
 
+/**
+ * Receives the transactions of an import batch by batch and takes their
+ * ownership, `total` is the number of transactions in the file, an estimate
+ * while the file is read or -1 while unknown. Returning false stops the import.
+ */
+typedef std::function<bool(const TransactionList &batch, const int total)> TransactionBatchHandler;
+
 template<class T> class SignalBlocker
 {
     T *blocked;
@@ -91,6 +102,17 @@ struct ImExportProfile
 };
 typedef QVector<const ImExportProfile *> ImExportProfileList;
 
+struct AccountSyncResult
+{
+    quint32 accountId = 0;
+    AccountBalanceList balances = {};
+    TransactionList transactions = {};
+    // Ranges asked for with a transaction command and answered by the bank
+    DateIntervals fetchedIntervals = {};
+    QString errorMessage = "";
+};
+typedef QHash<quint32, AccountSyncResult> AccountSyncResults;
+
 } // namespace olbaflinx::core
 
 Q_DECLARE_METATYPE(olbaflinx::core::AccountList)
@@ -110,4 +132,7 @@ Q_DECLARE_METATYPE(const olbaflinx::core::ImExportProfile *)
 Q_DECLARE_METATYPE(olbaflinx::core::ImExportProfileList)
 Q_DECLARE_METATYPE(olbaflinx::core::ImExportProfileDataList)
 
+Q_DECLARE_METATYPE(olbaflinx::core::AccountSyncResult)
+Q_DECLARE_METATYPE(olbaflinx::core::AccountSyncResults)
+
 #endif // OLBAFLINX_CONTAINER_H
@@ -0,0 +1,50 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_CANCELLATIONTOKEN_H
+#define OLBAFLINX_CANCELLATIONTOKEN_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QMetaType>
+#include <QtCore/QSharedPointer>
+
+namespace olbaflinx::core::progress {
+
+/**
+ * Shared flag to stop a long running operation. Copies refer to the same
+ * flag, so the GUI keeps one and the worker checks another between batches.
+ * A default constructed token is never cancelled unless `cancel` is called.
+ */
+class CancellationToken
+{
+public:
+    CancellationToken()
+        : m_isCancelled(new QAtomicInt(0))
+    { }
+
+    void cancel() const { m_isCancelled->storeRelease(1); }
+    [[nodiscard]] bool isCancelled() const { return m_isCancelled->loadAcquire() != 0; }
+
+private:
+    QSharedPointer<QAtomicInt> m_isCancelled;
+};
+
+} // namespace olbaflinx::core::progress
+
+Q_DECLARE_METATYPE(olbaflinx::core::progress::CancellationToken)
+
+#endif //OLBAFLINX_CANCELLATIONTOKEN_H
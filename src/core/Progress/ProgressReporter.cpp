@@ -0,0 +1,199 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QMutexLocker>
+
+#include "ProgressReporter.h"
+
+using namespace olbaflinx::core::progress;
+
+ProgressReporter::ProgressReporter(QObject *parent, const int interval)
+    : QObject(parent)
+    , m_tasks({})
+    , m_interval(interval)
+    , m_lastPercentage(-1)
+    , m_currentTask(-1)
+    , m_isFinished(false)
+{
+    qRegisterMetaType<ProgressState>();
+
+    m_elapsed.start();
+    m_sinceReport.start();
+}
+
+ProgressReporter::~ProgressReporter() = default;
+
+int ProgressReporter::addTask(const QString &name,
+                              const qint64 total,
+                              const qreal weight,
+                              const int parentTask)
+{
+    QMutexLocker locker(&m_mutex);
+
+    Task task;
+    task.name = name;
+    task.total = total;
+    task.weight = qMax(0.0, weight);
+    task.parent = parentTask;
+    m_tasks.append(task);
+
+    return m_tasks.size() - 1;
+}
+
+void ProgressReporter::setTaskTotal(const int task, const qint64 total)
+{
+    QMutexLocker locker(&m_mutex);
+    if (task >= 0 && task < m_tasks.size()) {
+        m_tasks[task].total = total;
+    }
+}
+
+void ProgressReporter::advance(const int task, const qint64 steps)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (task < 0 || task >= m_tasks.size()) {
+            return;
+        }
+
+        m_tasks[task].done += steps;
+        m_currentTask = task;
+    }
+
+    report(false);
+}
+
+void ProgressReporter::finishTask(const int task)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (task < 0 || task >= m_tasks.size()) {
+            return;
+        }
+
+        m_tasks[task].isFinished = true;
+    }
+
+    report(false);
+}
+
+void ProgressReporter::finish()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_isFinished) {
+            return;
+        }
+
+        m_isFinished = true;
+        for (auto &task : m_tasks) {
+            task.isFinished = true;
+        }
+    }
+
+    report(true);
+}
+
+ProgressState ProgressReporter::state() const
+{
+    QMutexLocker locker(&m_mutex);
+    return createState();
+}
+
+qreal ProgressReporter::fraction(const int parent) const
+{
+    qreal weights = 0.0;
+    qreal weighted = 0.0;
+    for (int task = 0; task < m_tasks.size(); ++task) {
+        if (m_tasks.at(task).parent != parent) {
+            continue;
+        }
+
+        weights += m_tasks.at(task).weight;
+        weighted += m_tasks.at(task).weight * taskFraction(task);
+    }
+
+    return weights > 0.0 ? weighted / weights : 0.0;
+}
+
+qreal ProgressReporter::taskFraction(const int task) const
+{
+    const auto &current = m_tasks.at(task);
+    if (current.isFinished) {
+        return 1.0;
+    }
+
+    for (const auto &other : m_tasks) {
+        if (other.parent == task) {
+            return fraction(task);
+        }
+    }
+
+    if (current.total <= 0) {
+        return 0.0;
+    }
+
+    return qBound(0.0, qreal(current.done) / current.total, 1.0);
+}
+
+ProgressState ProgressReporter::createState() const
+{
+    ProgressState state;
+    state.percentage = m_isFinished ? 100.0 : fraction(-1) * 100.0;
+
+    for (int task = 0; task < m_tasks.size(); ++task) {
+        const auto &current = m_tasks.at(task);
+        state.processed += current.done;
+        state.total += current.total;
+        if (task == m_currentTask) {
+            state.task = current.name;
+        }
+    }
+
+    const qint64 elapsed = m_elapsed.elapsed();
+    if (elapsed > 0) {
+        state.throughput = state.processed * 1000.0 / elapsed;
+    }
+    if (state.percentage >= 100.0) {
+        state.remaining = 0;
+    } else if (state.percentage > 0.0) {
+        state.remaining = qint64(elapsed * (100.0 - state.percentage) / state.percentage);
+    }
+
+    return state;
+}
+
+void ProgressReporter::report(const bool force)
+{
+    ProgressState state;
+    {
+        QMutexLocker locker(&m_mutex);
+        state = createState();
+
+        const int percentage = int(state.percentage);
+        const bool isThrottled = m_lastPercentage >= 0 && m_sinceReport.elapsed() < m_interval;
+        if (!force && (percentage == m_lastPercentage || isThrottled)) {
+            return;
+        }
+
+        m_lastPercentage = percentage;
+        m_sinceReport.restart();
+    }
+
+    Q_EMIT progress(state.percentage);
+    Q_EMIT stateChanged(state);
+}
@@ -0,0 +1,107 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_PROGRESSREPORTER_H
+#define OLBAFLINX_PROGRESSREPORTER_H
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QMetaType>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QVector>
+
+#include "core/Constant.h"
+
+namespace olbaflinx::core::progress {
+
+struct ProgressState
+{
+    qreal percentage = 0.0;
+    qint64 processed = 0;
+    qint64 total = 0;
+    // Processed items per second since the start
+    qreal throughput = 0.0;
+    // Estimated remaining time in milliseconds, -1 while unknown
+    qint64 remaining = -1;
+    QString task = "";
+};
+
+/**
+ * Collects the progress of a long running operation from any thread and
+ * publishes it coalesced: `progress` and `stateChanged` are emitted only when
+ * the whole percentage changed and at most every `interval` milliseconds, the
+ * final 100% always.
+ *
+ * An operation consists of tasks, each with its own number of items and a
+ * weight relative to its siblings. A task with sub tasks takes its progress
+ * from them instead of its own items.
+ */
+class ProgressReporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ProgressReporter(QObject *parent = Q_NULLPTR,
+                              const int interval = ProgressReportInterval);
+    ~ProgressReporter() override;
+
+    int addTask(const QString &name,
+                const qint64 total = 0,
+                const qreal weight = 1.0,
+                const int parentTask = -1);
+    void setTaskTotal(const int task, const qint64 total);
+    void advance(const int task, const qint64 steps = 1);
+    void finishTask(const int task);
+    void finish();
+
+    [[nodiscard]] ProgressState state() const;
+
+Q_SIGNALS:
+    void progress(const qreal percentage);
+    void stateChanged(const ProgressState &state);
+
+private:
+    struct Task
+    {
+        QString name = "";
+        qint64 done = 0;
+        qint64 total = 0;
+        qreal weight = 1.0;
+        int parent = -1;
+        bool isFinished = false;
+    };
+
+    QVector<Task> m_tasks;
+    QElapsedTimer m_elapsed;
+    QElapsedTimer m_sinceReport;
+    int m_interval;
+    int m_lastPercentage;
+    int m_currentTask;
+    bool m_isFinished;
+    mutable QMutex m_mutex;
+
+    [[nodiscard]] qreal fraction(const int parent) const;
+    [[nodiscard]] qreal taskFraction(const int task) const;
+    [[nodiscard]] ProgressState createState() const;
+    void report(const bool force);
+};
+
+} // namespace olbaflinx::core::progress
+
+Q_DECLARE_METATYPE(olbaflinx::core::progress::ProgressState)
+
+#endif //OLBAFLINX_PROGRESSREPORTER_H
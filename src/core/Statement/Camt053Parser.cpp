@@ -0,0 +1,209 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtCore/QStringList>
+#include <QtCore/QXmlStreamReader>
+
+#include "Camt053Parser.h"
+
+using namespace olbaflinx::core::statement;
+
+namespace {
+
+/**
+ * Fields of an `Ntry`, the parties are assigned once the direction is known.
+ */
+struct CamtEntry
+{
+    StatementEntry entry = {};
+    bool isDebit = false;
+    int details = 0;
+    QStringList purpose = {};
+    QString debtorName = "";
+    QString debtorIban = "";
+    QString debtorBic = "";
+    QString creditorName = "";
+    QString creditorIban = "";
+    QString creditorBic = "";
+};
+
+QDate readDate(const QString &text)
+{
+    // Dt or the date part of DtTm
+    return QDate::fromString(text.left(10), Qt::ISODate);
+}
+
+} // namespace
+
+Camt053Parser::Camt053Parser()
+    : StatementParser()
+{ }
+
+Camt053Parser::~Camt053Parser() = default;
+
+bool Camt053Parser::read(QIODevice *device, const EntryHandler &handler)
+{
+    QXmlStreamReader xml(device);
+
+    StatementEntry account;
+    CamtEntry current;
+    QStringList path = {};
+    int entryDepth = -1;
+    bool isStopped = false;
+
+    while (!xml.atEnd() && !isStopped) {
+        const auto token = xml.readNext();
+
+        if (token == QXmlStreamReader::EndElement) {
+            if (path.size() - 1 == entryDepth && path.last() == "Ntry") {
+                auto &entry = current.entry;
+                entry.purpose = current.purpose.join('\n');
+                if (current.isDebit) {
+                    if (!entry.value.isEmpty()) {
+                        entry.value.prepend('-');
+                    }
+                    entry.remoteName = current.creditorName;
+                    entry.remoteIban = current.creditorIban;
+                    entry.remoteBic = current.creditorBic;
+                } else {
+                    entry.remoteName = current.debtorName;
+                    entry.remoteIban = current.debtorIban;
+                    entry.remoteBic = current.debtorBic;
+                }
+
+                isStopped = !handler(entry);
+                entryDepth = -1;
+            }
+            path.removeLast();
+            continue;
+        }
+
+        if (token != QXmlStreamReader::StartElement) {
+            continue;
+        }
+
+        path << xml.name().toString();
+        const QString name = path.last();
+
+        if (name == "Ntry" && entryDepth < 0) {
+            entryDepth = path.size() - 1;
+            current = CamtEntry();
+            current.entry = account;
+            continue;
+        }
+
+        if (entryDepth < 0) {
+            if (name == "Stmt") {
+                account = StatementEntry();
+            } else if (path.mid(path.size() - 4).join('/') == "Stmt/Acct/Id/IBAN") {
+                account.localIban = xml.readElementText().trimmed();
+                path.removeLast();
+            } else if (path.mid(path.size() - 3).join('/') == "Stmt/Acct/Ccy") {
+                account.currency = xml.readElementText().trimmed();
+                path.removeLast();
+            } else if (name == "BIC" || name == "BICFI") {
+                if (path.contains("Acct") && path.contains("Svcr")) {
+                    account.localBic = xml.readElementText().trimmed();
+                    path.removeLast();
+                }
+            }
+            continue;
+        }
+
+        // Path below the Ntry, the party wrapper of newer versions is left out
+        QStringList relativePath = path.mid(entryDepth + 1);
+        relativePath.removeAll("Pty");
+        const QString relative = relativePath.join('/');
+
+        if (relative == "NtryDtls/TxDtls") {
+            ++current.details;
+            continue;
+        }
+
+        // Only the first transaction details of a batch booking are read
+        if (relative.startsWith("NtryDtls/") && current.details > 1) {
+            continue;
+        }
+
+        auto &entry = current.entry;
+        QString *text = Q_NULLPTR;
+        QString value = "";
+
+        if (relative == "Amt") {
+            const QString currency = xml.attributes().value("Ccy").toString();
+            if (!currency.isEmpty()) {
+                entry.currency = currency;
+            }
+            text = &entry.value;
+        } else if (relative == "CdtDbtInd") {
+            text = &value;
+        } else if (relative == "BookgDt/Dt" || relative == "BookgDt/DtTm") {
+            entry.date = readDate(xml.readElementText());
+        } else if (relative == "ValDt/Dt" || relative == "ValDt/DtTm") {
+            entry.valutaDate = readDate(xml.readElementText());
+        } else if (relative == "AcctSvcrRef") {
+            text = &entry.bankReference;
+        } else if (relative == "AddtlNtryInf") {
+            text = &entry.transactionText;
+        } else if (relative == "NtryDtls/TxDtls/Refs/EndToEndId") {
+            text = &entry.endToEndReference;
+        } else if (relative == "NtryDtls/TxDtls/Refs/MndtId") {
+            text = &entry.mandateId;
+        } else if (relative == "NtryDtls/TxDtls/RltdPties/Dbtr/Nm") {
+            text = &current.debtorName;
+        } else if (relative == "NtryDtls/TxDtls/RltdPties/DbtrAcct/Id/IBAN") {
+            text = &current.debtorIban;
+        } else if (relative == "NtryDtls/TxDtls/RltdPties/Cdtr/Nm") {
+            text = &current.creditorName;
+        } else if (relative == "NtryDtls/TxDtls/RltdPties/CdtrAcct/Id/IBAN") {
+            text = &current.creditorIban;
+        } else if (relative == "NtryDtls/TxDtls/RltdPties/Cdtr/Id/PrvtId/Othr/Id") {
+            text = &entry.creditorSchemeId;
+        } else if (relative == "NtryDtls/TxDtls/RltdAgts/DbtrAgt/FinInstnId/BIC"
+                   || relative == "NtryDtls/TxDtls/RltdAgts/DbtrAgt/FinInstnId/BICFI") {
+            text = &current.debtorBic;
+        } else if (relative == "NtryDtls/TxDtls/RltdAgts/CdtrAgt/FinInstnId/BIC"
+                   || relative == "NtryDtls/TxDtls/RltdAgts/CdtrAgt/FinInstnId/BICFI") {
+            text = &current.creditorBic;
+        } else if (relative == "NtryDtls/TxDtls/RmtInf/Ustrd") {
+            current.purpose << xml.readElementText().trimmed();
+        } else {
+            continue;
+        }
+
+        // readElementText consumed the end element
+        if (text != Q_NULLPTR) {
+            *text = xml.readElementText().trimmed();
+        }
+        path.removeLast();
+
+        if (relative == "CdtDbtInd") {
+            current.isDebit = (value == "DBIT");
+        } else if (relative == "NtryDtls/TxDtls/Refs/EndToEndId"
+                   && entry.endToEndReference == "NOTPROVIDED") {
+            entry.endToEndReference.clear();
+        }
+    }
+
+    if (xml.hasError() && !isStopped) {
+        setErrorMessage(xml.errorString());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,43 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_CAMT053PARSER_H
+#define OLBAFLINX_CAMT053PARSER_H
+
+#include "core/Statement/StatementParser.h"
+
+namespace olbaflinx::core::statement {
+
+/**
+ * ISO 20022 CAMT.053 bank to customer statements, read incrementally with a
+ * `QXmlStreamReader`. Each `Ntry` is one transaction, the related party and
+ * remittance information are taken from its first `TxDtls`.
+ */
+class Camt053Parser : public StatementParser
+{
+public:
+    Camt053Parser();
+    ~Camt053Parser() override;
+
+protected:
+    bool read(QIODevice *device, const EntryHandler &handler) override;
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_CAMT053PARSER_H
@@ -0,0 +1,561 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <cstring>
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QTextCodec>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/QtAlgorithms>
+
+#include "CsvParser.h"
+
+using namespace olbaflinx::core::statement;
+
+/**
+ * Complete records of the file and the offsets of their separators.
+ */
+struct CsvParser::Chunk
+{
+    QByteArray data = {};
+    QVector<quint32> separators = {};
+    // Preamble and header, only in the first chunk
+    int skipRecords = 0;
+};
+
+struct CsvParser::ConvertedChunk
+{
+    TransactionList transactions = {};
+    int records = 0;
+    int skipped = 0;
+    int bytes = 0;
+};
+
+namespace {
+
+/**
+ * Reads the records of a chunk into statement entries, the same for the
+ * parallel and the sequential path.
+ */
+class RecordReader
+{
+public:
+    RecordReader(const CsvProfile &profile, QTextCodec *codec)
+        : m_profile(profile)
+        , m_codec(codec)
+        , m_data(Q_NULLPTR)
+        , m_fields()
+        , m_lastDateText()
+        , m_lastDate()
+    { }
+
+    /**
+     * Hands each entry to `handler` until it returns false, returns the number
+     * of records without a valid date or value.
+     */
+    template<typename Handler>
+    int read(const QByteArray &data,
+             const QVector<quint32> &separators,
+             const int skipRecords,
+             Handler handler)
+    {
+        m_data = data.constData();
+
+        int skipped = 0;
+        int records = 0;
+        quint32 fieldStart = 0;
+        StatementEntry entry;
+
+        for (const quint32 separator : separators) {
+            const quint32 position = separator & ~CsvParser::RecordEnd;
+            m_fields.append(qMakePair(fieldStart, position));
+            fieldStart = position + 1;
+
+            if ((separator & CsvParser::RecordEnd) == 0) {
+                continue;
+            }
+
+            if (records++ >= skipRecords && !isBlank()) {
+                if (!toEntry(entry)) {
+                    ++skipped;
+                } else if (!handler(entry)) {
+                    break;
+                }
+            }
+            m_fields.clear();
+        }
+        m_fields.clear();
+
+        return skipped;
+    }
+
+private:
+    const CsvProfile &m_profile;
+    QTextCodec *m_codec;
+    const char *m_data;
+    QVarLengthArray<QPair<quint32, quint32>, 32> m_fields;
+    QByteArray m_lastDateText;
+    QDate m_lastDate;
+
+    bool isBlank() const
+    {
+        return m_fields.size() == 1 && field(0).isEmpty();
+    }
+
+    /**
+     * The field without surrounding white space and quotes, not copied unless
+     * it contains escaped quotes.
+     */
+    QByteArray field(const int column) const
+    {
+        if (column < 0 || column >= m_fields.size()) {
+            return QByteArray();
+        }
+
+        const char *begin = m_data + m_fields.at(column).first;
+        const char *end = m_data + m_fields.at(column).second;
+        while (begin < end && (*begin == ' ' || *begin == '\t' || *begin == '\r')) {
+            ++begin;
+        }
+        while (end > begin && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+            --end;
+        }
+
+        const char quote = m_profile.quote;
+        if (end - begin >= 2 && *begin == quote && end[-1] == quote) {
+            ++begin;
+            --end;
+            const QByteArray quoted = QByteArray::fromRawData(begin, int(end - begin));
+            const QByteArray escaped(2, quote);
+            if (quoted.contains(escaped)) {
+                return QByteArray(quoted).replace(escaped, QByteArray(1, quote));
+            }
+        }
+
+        return QByteArray::fromRawData(begin, int(end - begin));
+    }
+
+    QString text(const CsvProfile::Field field) const
+    {
+        const QByteArray bytes = this->field(m_profile.column(field));
+        return bytes.isEmpty() ? QString() : m_codec->toUnicode(bytes).trimmed();
+    }
+
+    QDate date(const CsvProfile::Field field)
+    {
+        const QByteArray bytes = this->field(m_profile.column(field));
+        if (bytes.isEmpty()) {
+            return QDate();
+        }
+
+        // Statements are sorted by date, most rows repeat the date before
+        if (bytes == m_lastDateText) {
+            return m_lastDate;
+        }
+
+        const QString text = QString::fromLatin1(bytes);
+        QDate date = {};
+        for (const auto &format : m_profile.dateFormats) {
+            date = QDate::fromString(text, format);
+            if (date.isValid()) {
+                // Two digit years are read as 19xx
+                if (!format.contains("yyyy") && date.year() < 1970) {
+                    date = date.addYears(100);
+                }
+                break;
+            }
+        }
+
+        m_lastDateText = QByteArray(bytes.constData(), bytes.size());
+        m_lastDate = date;
+        return date;
+    }
+
+    /**
+     * Digits of the amount with a dot as decimal separator, thousands
+     * separators, currency symbols and blanks are dropped. Empty if the field
+     * has no digits.
+     */
+    QByteArray amount(const CsvProfile::Field field, bool &isNegative) const
+    {
+        const QByteArray bytes = this->field(m_profile.column(field));
+        const char decimalSeparator = m_profile.isDecimalComma ? ',' : '.';
+
+        QByteArray digits = {};
+        digits.reserve(bytes.size() + 1);
+        bool hasDigits = false;
+        isNegative = false;
+
+        for (const char c : bytes) {
+            if (c >= '0' && c <= '9') {
+                digits.append(c);
+                hasDigits = true;
+            } else if (c == decimalSeparator) {
+                if (!hasDigits) {
+                    digits.append('0');
+                }
+                digits.append('.');
+            } else if (c == '-' || c == '(') {
+                isNegative = true;
+            }
+        }
+
+        return hasDigits ? digits : QByteArray();
+    }
+
+    bool isDebitIndicator(const QString &indicator) const
+    {
+        for (const auto &debitIndicator : m_profile.debitIndicators) {
+            if (indicator.compare(debitIndicator, Qt::CaseInsensitive) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool toEntry(StatementEntry &entry)
+    {
+        entry = StatementEntry();
+
+        entry.date = date(CsvProfile::DateField);
+        if (!entry.date.isValid()) {
+            return false;
+        }
+
+        bool isNegative = false;
+        QByteArray value = amount(CsvProfile::ValueField, isNegative);
+
+        switch (m_profile.signConvention) {
+        case CsvProfile::InvertedValue:
+            isNegative = !isNegative;
+            break;
+        case CsvProfile::DebitCreditColumns: {
+            bool isDebitNegative = false;
+            const QByteArray debit = amount(CsvProfile::DebitField, isDebitNegative);
+            if (!debit.isEmpty() && debit.toDouble() != 0.0) {
+                value = debit;
+                isNegative = true;
+            }
+            break;
+        }
+        case CsvProfile::DebitCreditIndicator:
+            isNegative = isDebitIndicator(text(CsvProfile::IndicatorField));
+            break;
+        default:
+            break;
+        }
+
+        if (value.isEmpty()) {
+            return false;
+        }
+        entry.value = QString::fromLatin1(isNegative ? value.prepend('-') : value);
+
+        entry.valutaDate = date(CsvProfile::ValutaDateField);
+        entry.currency = text(CsvProfile::CurrencyField);
+        if (entry.currency.isEmpty()) {
+            entry.currency = m_profile.currency;
+        }
+
+        entry.localIban = text(CsvProfile::LocalIbanField).remove(' ');
+        entry.remoteName = text(CsvProfile::RemoteNameField);
+        entry.remoteIban = text(CsvProfile::RemoteIbanField).remove(' ');
+        entry.remoteBic = text(CsvProfile::RemoteBicField);
+        entry.purpose = text(CsvProfile::PurposeField);
+        entry.transactionText = text(CsvProfile::TransactionTextField);
+        entry.customerReference = text(CsvProfile::CustomerReferenceField);
+        entry.bankReference = text(CsvProfile::BankReferenceField);
+        entry.endToEndReference = text(CsvProfile::EndToEndReferenceField);
+        entry.mandateId = text(CsvProfile::MandateIdField);
+        entry.creditorSchemeId = text(CsvProfile::CreditorSchemeIdField);
+
+        if (entry.endToEndReference == "NOTPROVIDED") {
+            entry.endToEndReference.clear();
+        }
+
+        return true;
+    }
+};
+
+QString invalidProfileMessage(const CsvProfile &profile)
+{
+    return QString("The CSV profile %1 does not map the date and value columns "
+                   "or its encoding %2 is unknown")
+        .arg(profile.name, profile.encoding);
+}
+
+} // namespace
+
+CsvParser::CsvParser(const CsvProfile &profile)
+    : StatementParser()
+    , m_profile(profile)
+    , m_pool()
+    , m_skippedRecords(0)
+{ }
+
+CsvParser::~CsvParser()
+{
+    m_pool.waitForDone();
+}
+
+int CsvParser::parse(QIODevice *device,
+                     const TransactionBatchHandler &handler,
+                     const CancellationToken &token)
+{
+    // A single chunk isn't worth the pool
+    const qint64 size = device->isSequential() ? -1 : device->size() - device->pos();
+    if (size >= 0 && size <= CsvChunkSize) {
+        return StatementParser::parse(device, handler, token);
+    }
+
+    m_skippedRecords = 0;
+    setErrorMessage(QString());
+
+    if (!m_profile.isValid()) {
+        setErrorMessage(invalidProfileMessage(m_profile));
+        return -1;
+    }
+
+    const int maxPending = m_pool.maxThreadCount() * CsvPendingChunksPerThread;
+    QList<QFuture<ConvertedChunk>> pending = {};
+
+    int count = 0;
+    qint64 records = 0;
+    qint64 bytes = 0;
+    bool isStopped = false;
+    TransactionList batch = {};
+    batch.reserve(StorageImportBatchSize);
+
+    // Chunks are handed over in file order, the total is estimated from the
+    // records per byte until the file is read
+    const auto deliver = [&](const ConvertedChunk &converted) {
+        m_skippedRecords += converted.skipped;
+        records += converted.records;
+        bytes += converted.bytes;
+
+        const int total = size < 0 ? -1 : int(records * size / qMax<qint64>(1, bytes));
+        for (const auto transaction : converted.transactions) {
+            if (isStopped) {
+                delete transaction;
+                continue;
+            }
+
+            batch << transaction;
+            if (batch.size() >= StorageImportBatchSize) {
+                count += batch.size();
+                isStopped = !handler(batch, qMax(total, count));
+                batch.clear();
+            }
+        }
+    };
+
+    QByteArray remainder = {};
+    bool isFirst = true;
+    bool isValid = true;
+
+    while (!isStopped) {
+        if (token.isCancelled()) {
+            isStopped = true;
+            break;
+        }
+
+        QByteArray data = remainder + device->read(CsvChunkSize);
+        const bool isAtEnd = device->atEnd();
+        if (data.isEmpty()) {
+            break;
+        }
+        if (isAtEnd && !data.endsWith('\n')) {
+            data.append('\n');
+        }
+
+        Chunk chunk;
+        chunk.separators.reserve(data.size() / 8);
+        const int end = scan(data.constData(),
+                             data.size(),
+                             m_profile.delimiter,
+                             m_profile.quote,
+                             chunk.separators);
+
+        // A quote left open at the end of the file
+        if (isAtEnd && end < data.size()) {
+            setErrorMessage(QString("Unterminated quote in the last record"));
+            isValid = false;
+            break;
+        }
+
+        // A record longer than the chunk, read on
+        if (end == 0) {
+            remainder = data;
+            continue;
+        }
+
+        remainder = data.mid(end);
+        data.truncate(end);
+        chunk.data = data;
+        if (isFirst) {
+            chunk.skipRecords = m_profile.skipLines + (m_profile.hasHeader ? 1 : 0);
+            isFirst = false;
+        }
+
+        pending << QtConcurrent::run(&m_pool, [this, chunk]() { return convert(chunk); });
+        while (!pending.isEmpty()
+               && (pending.first().isFinished() || pending.size() >= maxPending)) {
+            deliver(pending.takeFirst().result());
+        }
+
+        if (isAtEnd) {
+            break;
+        }
+    }
+
+    if (!isValid) {
+        isStopped = true;
+    }
+    while (!pending.isEmpty()) {
+        deliver(pending.takeFirst().result());
+    }
+
+    if (!batch.isEmpty() && !isStopped) {
+        count += batch.size();
+        handler(batch, count);
+    } else {
+        qDeleteAll(batch);
+    }
+
+    return isValid ? count : -1;
+}
+
+int CsvParser::skippedRecords() const
+{
+    return m_skippedRecords;
+}
+
+int CsvParser::scan(const char *data,
+                    const int size,
+                    const char delimiter,
+                    const char quote,
+                    QVector<quint32> &separators)
+{
+    const int first = separators.size();
+    int end = 0;
+    int recordSeparators = first;
+
+    // All bits set while the previous block ended inside quotes
+    quint64 isQuoted = 0;
+    uchar padded[64];
+
+    for (int offset = 0; offset < size; offset += 64) {
+        const uchar *block = reinterpret_cast<const uchar *>(data + offset);
+        if (size - offset < 64) {
+            std::memset(padded, 0, sizeof(padded));
+            std::memcpy(padded, block, size - offset);
+            block = padded;
+        }
+
+        quint64 quotes = 0;
+        quint64 delimiters = 0;
+        quint64 lineFeeds = 0;
+        for (int i = 0; i < 64; ++i) {
+            quotes |= quint64(block[i] == uchar(quote)) << i;
+            delimiters |= quint64(block[i] == uchar(delimiter)) << i;
+            lineFeeds |= quint64(block[i] == '\n') << i;
+        }
+
+        // Prefix xor of the quotes: set from an opening quote up to the closing
+        // one, escaped quotes toggle twice and don't change anything
+        quint64 quoted = quotes;
+        quoted ^= quoted << 1;
+        quoted ^= quoted << 2;
+        quoted ^= quoted << 4;
+        quoted ^= quoted << 8;
+        quoted ^= quoted << 16;
+        quoted ^= quoted << 32;
+        quoted ^= isQuoted;
+        isQuoted = quint64(qint64(quoted) >> 63);
+
+        quint64 structural = (delimiters | lineFeeds) & ~quoted;
+        while (structural != 0) {
+            const int bit = qCountTrailingZeroBits(structural);
+            const quint32 position = quint32(offset + bit);
+            if ((lineFeeds >> bit) & 1) {
+                separators << (position | RecordEnd);
+                end = int(position) + 1;
+                recordSeparators = separators.size();
+            } else {
+                separators << position;
+            }
+            structural &= structural - 1;
+        }
+    }
+
+    // Delimiters of the incomplete record are scanned again with the next chunk
+    separators.resize(recordSeparators);
+
+    return end;
+}
+
+bool CsvParser::read(QIODevice *device, const EntryHandler &handler)
+{
+    m_skippedRecords = 0;
+
+    QTextCodec *codec = QTextCodec::codecForName(m_profile.encoding.toLatin1());
+    if (!m_profile.isValid() || codec == Q_NULLPTR) {
+        setErrorMessage(invalidProfileMessage(m_profile));
+        return false;
+    }
+
+    QByteArray data = device->readAll();
+    if (!data.isEmpty() && !data.endsWith('\n')) {
+        data.append('\n');
+    }
+
+    QVector<quint32> separators = {};
+    const int end = scan(data.constData(),
+                         data.size(),
+                         m_profile.delimiter,
+                         m_profile.quote,
+                         separators);
+    if (end < data.size()) {
+        setErrorMessage(QString("Unterminated quote in the last record"));
+        return false;
+    }
+
+    RecordReader reader(m_profile, codec);
+    m_skippedRecords = reader.read(data,
+                                   separators,
+                                   m_profile.skipLines + (m_profile.hasHeader ? 1 : 0),
+                                   handler);
+    return true;
+}
+
+CsvParser::ConvertedChunk CsvParser::convert(const Chunk &chunk) const
+{
+    ConvertedChunk converted;
+    converted.bytes = chunk.data.size();
+
+    RecordReader reader(m_profile, QTextCodec::codecForName(m_profile.encoding.toLatin1()));
+    converted.skipped = reader.read(chunk.data,
+                                    chunk.separators,
+                                    chunk.skipRecords,
+                                    [&converted](const StatementEntry &entry) {
+                                        converted.transactions << entry.toTransaction();
+                                        return true;
+                                    });
+    converted.records = converted.transactions.size() + converted.skipped;
+
+    return converted;
+}
@@ -0,0 +1,88 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_CSVPARSER_H
+#define OLBAFLINX_CSVPARSER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QThreadPool>
+#include <QtCore/QVector>
+
+#include "core/Statement/CsvProfile.h"
+#include "core/Statement/StatementParser.h"
+
+namespace olbaflinx::core::statement {
+
+/**
+ * CSV files laid out as described by a `CsvProfile`. The file is read in
+ * chunks ending at a record, a chunk is scanned for its delimiters on the
+ * calling thread and converted to transactions on a thread pool while the
+ * next chunks are scanned.
+ */
+class CsvParser : public StatementParser
+{
+public:
+    explicit CsvParser(const CsvProfile &profile);
+    ~CsvParser() override;
+
+    int parse(QIODevice *device,
+              const TransactionBatchHandler &handler,
+              const CancellationToken &token = CancellationToken()) override;
+
+    /**
+     * Rows without a valid date or value in the last parse, e.g. the summary
+     * lines some banks write after the bookings.
+     */
+    [[nodiscard]] int skippedRecords() const;
+
+    /**
+     * Set on the offset of a record end in the result of `scan`.
+     */
+    static constexpr quint32 RecordEnd = 0x80000000u;
+
+    /**
+     * Appends the offsets of the delimiters and line feeds outside of quotes
+     * to `separators`, line feeds flagged with `RecordEnd`. The data is
+     * classified 64 bytes at a time into bit masks, so the loops over the
+     * bytes have no branches and are vectorized by the compiler.
+     *
+     * Returns the number of bytes up to and including the last record end.
+     */
+    static int scan(const char *data,
+                    const int size,
+                    const char delimiter,
+                    const char quote,
+                    QVector<quint32> &separators);
+
+protected:
+    bool read(QIODevice *device, const EntryHandler &handler) override;
+
+private:
+    struct Chunk;
+    struct ConvertedChunk;
+
+    CsvProfile m_profile;
+    QThreadPool m_pool;
+    int m_skippedRecords;
+
+    ConvertedChunk convert(const Chunk &chunk) const;
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_CSVPARSER_H
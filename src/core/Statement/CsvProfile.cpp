@@ -0,0 +1,183 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtCore/QTextCodec>
+
+#include "core/Constant.h"
+#include "core/Statement/CsvWriter.h"
+#include "core/Storage/VaultStorage.h"
+
+#include "CsvProfile.h"
+
+using namespace olbaflinx::core::statement;
+using namespace olbaflinx::core::storage;
+
+namespace {
+
+// Keys of the columns in the stored profile, in the order of `CsvProfile::Field`
+const char *const FieldKeys[CsvProfile::FieldCount] = {"date",
+                                                       "valutaDate",
+                                                       "value",
+                                                       "debit",
+                                                       "indicator",
+                                                       "currency",
+                                                       "localIban",
+                                                       "remoteName",
+                                                       "remoteIban",
+                                                       "remoteBic",
+                                                       "purpose",
+                                                       "transactionText",
+                                                       "customerReference",
+                                                       "bankReference",
+                                                       "endToEndReference",
+                                                       "mandateId",
+                                                       "creditorSchemeId"};
+
+char toChar(const QVariant &value, const char defaultValue)
+{
+    const QString text = value.toString();
+    return text.size() == 1 && text.at(0).unicode() < 0x80 ? text.at(0).toLatin1() : defaultValue;
+}
+
+} // namespace
+
+int CsvProfile::column(const Field field) const
+{
+    return columns.value(field, -1);
+}
+
+void CsvProfile::setColumn(const Field field, const int column)
+{
+    if (columns.size() != FieldCount) {
+        columns.resize(FieldCount);
+    }
+    columns[field] = column;
+}
+
+bool CsvProfile::isValid() const
+{
+    if (column(DateField) < 0 || column(ValueField) < 0 || delimiter == quote) {
+        return false;
+    }
+
+    if (signConvention == DebitCreditColumns && column(DebitField) < 0) {
+        return false;
+    }
+
+    if (signConvention == DebitCreditIndicator && column(IndicatorField) < 0) {
+        return false;
+    }
+
+    return !dateFormats.isEmpty() && QTextCodec::codecForName(encoding.toLatin1()) != Q_NULLPTR;
+}
+
+QVariantMap CsvProfile::toVariant() const
+{
+    QVariantMap columnMap = {};
+    for (int field = 0; field < FieldCount; ++field) {
+        if (column((Field) field) >= 0) {
+            columnMap.insert(FieldKeys[field], column((Field) field));
+        }
+    }
+
+    QVariantMap variant = {};
+    variant.insert("name", name);
+    variant.insert("encoding", encoding);
+    variant.insert("delimiter", QString(QChar(delimiter)));
+    variant.insert("quote", QString(QChar(quote)));
+    variant.insert("skipLines", skipLines);
+    variant.insert("hasHeader", hasHeader);
+    variant.insert("dateFormats", dateFormats);
+    variant.insert("isDecimalComma", isDecimalComma);
+    variant.insert("signConvention", (int) signConvention);
+    variant.insert("debitIndicators", debitIndicators);
+    variant.insert("currency", currency);
+    variant.insert("columns", columnMap);
+
+    return variant;
+}
+
+CsvProfile CsvProfile::fromVariant(const QVariantMap &variant)
+{
+    CsvProfile profile;
+    profile.name = variant.value("name", profile.name).toString();
+    profile.encoding = variant.value("encoding", profile.encoding).toString();
+    profile.delimiter = toChar(variant.value("delimiter"), profile.delimiter);
+    profile.quote = toChar(variant.value("quote"), profile.quote);
+    profile.skipLines = variant.value("skipLines", profile.skipLines).toInt();
+    profile.hasHeader = variant.value("hasHeader", profile.hasHeader).toBool();
+    profile.dateFormats = variant.value("dateFormats", profile.dateFormats).toStringList();
+    profile.isDecimalComma = variant.value("isDecimalComma", profile.isDecimalComma).toBool();
+    profile.signConvention = (SignConvention) variant
+                                 .value("signConvention", (int) profile.signConvention)
+                                 .toInt();
+    profile.debitIndicators = variant.value("debitIndicators", profile.debitIndicators)
+                                  .toStringList();
+    profile.currency = variant.value("currency", profile.currency).toString();
+
+    const QVariantMap columnMap = variant.value("columns").toMap();
+    for (int field = 0; field < FieldCount; ++field) {
+        profile.setColumn((Field) field, columnMap.value(FieldKeys[field], -1).toInt());
+    }
+
+    return profile;
+}
+
+QStringList CsvProfile::profileNames()
+{
+    const auto storage = VaultStorage::instance();
+
+    // Removed profiles are left as invalid values
+    QStringList names = {CsvImExporterName};
+    const auto keys = storage->settingKeys(CsvProfileSettingsGroup);
+    for (const auto &key : keys) {
+        const auto profile = storage->setting(key, CsvProfileSettingsGroup);
+        const QString name = profile.toMap().value("name").toString();
+        if (profile.isValid() && !names.contains(name)) {
+            names << name;
+        }
+    }
+
+    return names;
+}
+
+CsvProfile CsvProfile::load(const QString &name)
+{
+    const auto variant = VaultStorage::instance()->setting(name.toUtf8().toHex(),
+                                                           CsvProfileSettingsGroup);
+    if (!variant.isValid()) {
+        return name == CsvImExporterName ? CsvWriter::profile() : CsvProfile();
+    }
+
+    return fromVariant(variant.toMap());
+}
+
+void CsvProfile::save(const CsvProfile &profile)
+{
+    // Profile names are free text, the key mustn't contain slashes
+    VaultStorage::instance()->storeSetting(profile.name.toUtf8().toHex(),
+                                           profile.toVariant(),
+                                           CsvProfileSettingsGroup);
+}
+
+void CsvProfile::remove(const QString &name)
+{
+    VaultStorage::instance()->storeSetting(name.toUtf8().toHex(),
+                                           QVariant(),
+                                           CsvProfileSettingsGroup);
+}
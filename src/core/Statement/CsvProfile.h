@@ -0,0 +1,107 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_CSVPROFILE_H
+#define OLBAFLINX_CSVPROFILE_H
+
+#include <QtCore/QStringList>
+#include <QtCore/QVariantMap>
+#include <QtCore/QVector>
+
+namespace olbaflinx::core::statement {
+
+/**
+ * Describes the layout of the CSV export of a bank: which column holds which
+ * field and how dates, amounts and text are written. Profiles are stored by
+ * name in the settings. The layout of the own CSV export is built in under
+ * `CsvImExporterName`, a saved profile of that name takes its place.
+ */
+struct CsvProfile
+{
+    enum Field {
+        DateField = 0,
+        ValutaDateField,
+        ValueField,
+        DebitField,
+        IndicatorField,
+        CurrencyField,
+        LocalIbanField,
+        RemoteNameField,
+        RemoteIbanField,
+        RemoteBicField,
+        PurposeField,
+        TransactionTextField,
+        CustomerReferenceField,
+        BankReferenceField,
+        EndToEndReferenceField,
+        MandateIdField,
+        CreditorSchemeIdField,
+        FieldCount
+    };
+
+    enum SignConvention {
+        // The value column carries the sign
+        SignedValue = 0,
+        // The value column carries the sign from the card holders view
+        InvertedValue,
+        // Credits in the value column, debits in the debit column
+        DebitCreditColumns,
+        // Unsigned value, the indicator column tells debits apart
+        DebitCreditIndicator
+    };
+
+    QString name = "";
+    QString encoding = "UTF-8";
+    char delimiter = ';';
+    char quote = '"';
+    // Lines before the header, e.g. the account summary some banks write first
+    int skipLines = 0;
+    bool hasHeader = true;
+    // Tried in order, the first one matching the date is taken
+    QStringList dateFormats = {"dd.MM.yyyy"};
+    bool isDecimalComma = true;
+    SignConvention signConvention = SignedValue;
+    QStringList debitIndicators = {"S", "D", "DBIT"};
+    // Currency of every row without a currency column
+    QString currency = "EUR";
+    // Zero based column of each field, -1 if the file doesn't have it
+    QVector<int> columns = QVector<int>(FieldCount, -1);
+
+    int column(const Field field) const;
+    void setColumn(const Field field, const int column);
+
+    /**
+     * The date and value columns (and the debit or indicator column the
+     * sign convention needs) are mapped and the text can be decoded.
+     */
+    [[nodiscard]] bool isValid() const;
+
+    [[nodiscard]] QVariantMap toVariant() const;
+    [[nodiscard]] static CsvProfile fromVariant(const QVariantMap &variant);
+
+    [[nodiscard]] static QStringList profileNames();
+    [[nodiscard]] static CsvProfile load(const QString &name);
+    static void save(const CsvProfile &profile);
+    static void remove(const QString &name);
+};
+
+} // namespace olbaflinx::core::statement
+
+Q_DECLARE_METATYPE(olbaflinx::core::statement::CsvProfile)
+
+#endif //OLBAFLINX_CSVPROFILE_H
@@ -0,0 +1,139 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "CsvWriter.h"
+
+using namespace olbaflinx::core::statement;
+
+namespace {
+const char Delimiter = ';';
+const char Quote = '"';
+} // namespace
+
+CsvWriter::CsvWriter()
+    : StatementWriter()
+    , m_localIban("")
+{ }
+
+CsvWriter::~CsvWriter() = default;
+
+bool CsvWriter::begin(QIODevice *device)
+{
+    if (!StatementWriter::begin(device)) {
+        return false;
+    }
+
+    writeRecord({"date",
+                 "valuta_date",
+                 "value",
+                 "currency",
+                 "local_iban",
+                 "remote_name",
+                 "remote_iban",
+                 "remote_bic",
+                 "purpose",
+                 "category",
+                 "transaction_text",
+                 "customer_reference",
+                 "bank_reference",
+                 "end_to_end_reference",
+                 "mandate_id",
+                 "creditor_scheme_id"});
+
+    return end();
+}
+
+void CsvWriter::beginAccount(const Account *account, const QDate &fromDate, const QDate &toDate)
+{
+    StatementWriter::beginAccount(account, fromDate, toDate);
+    m_localIban = account->iban();
+}
+
+void CsvWriter::write(const Transaction *transaction)
+{
+    const QString localIban = transaction->localIban();
+
+    writeRecord({transaction->date().toString(Qt::ISODate),
+                 transaction->valutaDate().toString(Qt::ISODate),
+                 QString::number(transaction->value(), 'f', 2),
+                 transaction->currency(),
+                 localIban.isEmpty() ? m_localIban : localIban,
+                 transaction->remoteName(),
+                 transaction->remoteIban(),
+                 transaction->remoteBic(),
+                 transaction->purpose(),
+                 transaction->category(),
+                 transaction->transactionText(),
+                 transaction->customerReference(),
+                 transaction->bankReference(),
+                 transaction->endToEndReference(),
+                 transaction->mandateId(),
+                 transaction->creditorSchemeId()});
+}
+
+CsvProfile CsvWriter::profile()
+{
+    CsvProfile profile;
+    profile.name = CsvImExporterName;
+    profile.encoding = "UTF-8";
+    profile.delimiter = Delimiter;
+    profile.quote = Quote;
+    profile.dateFormats = QStringList({"yyyy-MM-dd"});
+    profile.isDecimalComma = false;
+    profile.signConvention = CsvProfile::SignedValue;
+    profile.setColumn(CsvProfile::DateField, 0);
+    profile.setColumn(CsvProfile::ValutaDateField, 1);
+    profile.setColumn(CsvProfile::ValueField, 2);
+    profile.setColumn(CsvProfile::CurrencyField, 3);
+    profile.setColumn(CsvProfile::LocalIbanField, 4);
+    profile.setColumn(CsvProfile::RemoteNameField, 5);
+    profile.setColumn(CsvProfile::RemoteIbanField, 6);
+    profile.setColumn(CsvProfile::RemoteBicField, 7);
+    profile.setColumn(CsvProfile::PurposeField, 8);
+    profile.setColumn(CsvProfile::TransactionTextField, 10);
+    profile.setColumn(CsvProfile::CustomerReferenceField, 11);
+    profile.setColumn(CsvProfile::BankReferenceField, 12);
+    profile.setColumn(CsvProfile::EndToEndReferenceField, 13);
+    profile.setColumn(CsvProfile::MandateIdField, 14);
+    profile.setColumn(CsvProfile::CreditorSchemeIdField, 15);
+    return profile;
+}
+
+void CsvWriter::writeRecord(const QStringList &fields)
+{
+    const QChar delimiter = QLatin1Char(Delimiter);
+    const QString quote = QString(QLatin1Char(Quote));
+    const QString escapedQuote = quote + quote;
+
+    QString record = {};
+    for (int i = 0; i < fields.size(); ++i) {
+        if (i > 0) {
+            record.append(delimiter);
+        }
+
+        QString field = fields.at(i);
+        if (field.contains(delimiter) || field.contains(quote) || field.contains('\n')
+            || field.contains('\r')) {
+            field = quote + field.replace(quote, escapedQuote) + quote;
+        }
+        record.append(field);
+    }
+    record.append('\n');
+
+    writeData(record.toUtf8());
+}
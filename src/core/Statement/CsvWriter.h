@@ -0,0 +1,51 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_CSVWRITER_H
+#define OLBAFLINX_CSVWRITER_H
+
+#include "core/Statement/CsvProfile.h"
+#include "core/Statement/StatementWriter.h"
+
+namespace olbaflinx::core::statement {
+
+/**
+ * UTF-8 CSV with a header line, ISO dates and signed values with a dot. The
+ * layout is described by `profile()`, so the file can be imported again.
+ */
+class CsvWriter : public StatementWriter
+{
+public:
+    CsvWriter();
+    ~CsvWriter() override;
+
+    bool begin(QIODevice *device) override;
+    void beginAccount(const Account *account, const QDate &fromDate, const QDate &toDate) override;
+    void write(const Transaction *transaction) override;
+
+    [[nodiscard]] static CsvProfile profile();
+
+private:
+    QString m_localIban;
+
+    void writeRecord(const QStringList &fields);
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_CSVWRITER_H
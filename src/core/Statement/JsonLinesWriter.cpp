@@ -0,0 +1,74 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+
+#include "JsonLinesWriter.h"
+
+using namespace olbaflinx::core::statement;
+
+JsonLinesWriter::JsonLinesWriter()
+    : StatementWriter()
+    , m_accountId(0)
+    , m_localIban("")
+{ }
+
+JsonLinesWriter::~JsonLinesWriter() = default;
+
+void JsonLinesWriter::beginAccount(const Account *account,
+                                   const QDate &fromDate,
+                                   const QDate &toDate)
+{
+    StatementWriter::beginAccount(account, fromDate, toDate);
+    m_accountId = account->uniqueId();
+    m_localIban = account->iban();
+}
+
+void JsonLinesWriter::write(const Transaction *transaction)
+{
+    QJsonObject object;
+    const QString localIban = transaction->localIban();
+
+    const auto insert = [&object](const QString &key, const QString &value) {
+        if (!value.isEmpty()) {
+            object.insert(key, value);
+        }
+    };
+
+    object.insert("accountId", (qint64) m_accountId);
+    insert("date", transaction->date().toString(Qt::ISODate));
+    insert("valutaDate", transaction->valutaDate().toString(Qt::ISODate));
+    object.insert("value", transaction->value());
+    insert("currency", transaction->currency());
+    insert("localIban", localIban.isEmpty() ? m_localIban : localIban);
+    insert("remoteName", transaction->remoteName());
+    insert("remoteIban", transaction->remoteIban());
+    insert("remoteBic", transaction->remoteBic());
+    insert("purpose", transaction->purpose());
+    insert("category", transaction->category());
+    insert("transactionText", transaction->transactionText());
+    insert("customerReference", transaction->customerReference());
+    insert("bankReference", transaction->bankReference());
+    insert("endToEndReference", transaction->endToEndReference());
+    insert("mandateId", transaction->mandateId());
+    insert("creditorSchemeId", transaction->creditorSchemeId());
+    insert("hash", transaction->hash());
+
+    writeData(QJsonDocument(object).toJson(QJsonDocument::Compact).append('\n'));
+}
@@ -0,0 +1,46 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_JSONLINESWRITER_H
+#define OLBAFLINX_JSONLINESWRITER_H
+
+#include "core/Statement/StatementWriter.h"
+
+namespace olbaflinx::core::statement {
+
+/**
+ * One compact JSON object per transaction and line. Empty fields are left
+ * out, dates are ISO dates and the value is a signed number.
+ */
+class JsonLinesWriter : public StatementWriter
+{
+public:
+    JsonLinesWriter();
+    ~JsonLinesWriter() override;
+
+    void beginAccount(const Account *account, const QDate &fromDate, const QDate &toDate) override;
+    void write(const Transaction *transaction) override;
+
+private:
+    quint32 m_accountId;
+    QString m_localIban;
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_JSONLINESWRITER_H
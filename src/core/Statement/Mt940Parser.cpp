@@ -0,0 +1,277 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtCore/QRegularExpression>
+
+#include "Mt940Parser.h"
+
+using namespace olbaflinx::core::statement;
+
+Mt940Parser::Mt940Parser()
+    : StatementParser()
+{ }
+
+Mt940Parser::~Mt940Parser() = default;
+
+bool Mt940Parser::read(QIODevice *device, const EntryHandler &handler)
+{
+    static const QRegularExpression tagExpression("^:([0-9]{2}[A-Z]?):");
+    static const QRegularExpression ibanExpression("^[A-Z]{2}[0-9]{2}[A-Z0-9]{11,30}$");
+    static const QRegularExpression currencyExpression("[A-Z]{3}$");
+
+    QString tag = "";
+    QString value = "";
+    QString currency = "";
+    StatementEntry account;
+    StatementEntry entry;
+    bool hasEntry = false;
+    bool isStopped = false;
+
+    // An entry is complete with the next statement line or the end of its statement
+    const auto finishEntry = [&]() {
+        if (hasEntry && !isStopped) {
+            isStopped = !handler(entry);
+        }
+        hasEntry = false;
+    };
+
+    const auto finishField = [&]() -> bool {
+        if (tag == "20") {
+            finishEntry();
+            account = StatementEntry();
+            currency.clear();
+        } else if (tag == "25") {
+            const QString id = value.trimmed();
+            const int slash = id.indexOf('/');
+            if (slash > 0) {
+                account.localBankCode = id.left(slash);
+                account.localAccountNumber = id.mid(slash + 1).remove(currencyExpression);
+            } else if (ibanExpression.match(id).hasMatch()) {
+                account.localIban = id;
+            }
+        } else if (tag.startsWith("60")) {
+            // C220101EUR1234,56
+            currency = value.mid(7, 3);
+        } else if (tag == "61") {
+            finishEntry();
+            entry = account;
+            if (!parseStatementLine(value, currency, entry)) {
+                setErrorMessage(QString("Invalid statement line: %1").arg(value));
+                return false;
+            }
+            hasEntry = true;
+        } else if (tag == "86") {
+            if (hasEntry) {
+                parseDetails(value, entry);
+            }
+        } else if (tag.startsWith("62")) {
+            finishEntry();
+        }
+
+        tag.clear();
+        value.clear();
+        return true;
+    };
+
+    while (!device->atEnd() && !isStopped) {
+        QString line = QString::fromLatin1(device->readLine());
+        while (line.endsWith('\n') || line.endsWith('\r')) {
+            line.chop(1);
+        }
+
+        const auto match = tagExpression.match(line);
+        if (match.hasMatch()) {
+            if (!tag.isEmpty() && !finishField()) {
+                return false;
+            }
+            tag = match.captured(1);
+            value = line.mid(match.capturedLength());
+        } else if (line.trimmed() == "-" || line.startsWith("-}")) {
+            if (!tag.isEmpty() && !finishField()) {
+                return false;
+            }
+            finishEntry();
+        } else if (!tag.isEmpty()) {
+            // The details are wrapped at fixed columns, their fields carry the separators
+            value += (tag == "86" ? QString() : QString('\n')) + line;
+        }
+    }
+
+    if (!tag.isEmpty() && !finishField()) {
+        return false;
+    }
+    finishEntry();
+
+    return true;
+}
+
+bool Mt940Parser::parseStatementLine(const QString &line,
+                                     const QString &currency,
+                                     StatementEntry &entry)
+{
+    // Valuta date, booking date, mark, funds code, amount, type, references
+    static const QRegularExpression lineExpression(
+        "^(\\d{6})(\\d{4})?(R?[CD])([A-Z])?([0-9]+,[0-9]*)([NFS][A-Z0-9]{3})(.*?)(//(.*))?$");
+
+    const auto match = lineExpression.match(line.section('\n', 0, 0).trimmed());
+    if (!match.hasMatch()) {
+        return false;
+    }
+
+    entry.valutaDate = parseDate(match.captured(1));
+    if (!entry.valutaDate.isValid()) {
+        return false;
+    }
+
+    // The booking date has no year, it is close to the valuta date
+    entry.date = entry.valutaDate;
+    if (!match.captured(2).isEmpty()) {
+        const int month = match.captured(2).left(2).toInt();
+        int year = entry.valutaDate.year();
+        if (month < entry.valutaDate.month() - 6) {
+            ++year;
+        } else if (month > entry.valutaDate.month() + 6) {
+            --year;
+        }
+        entry.date = parseDate(match.captured(2), year);
+    }
+
+    QString amount = match.captured(5).replace(',', '.');
+    if (amount.endsWith('.')) {
+        amount.chop(1);
+    }
+
+    // A reversal of a credit is a debit and the other way round
+    const QString mark = match.captured(3);
+    const bool isDebit = (mark == "D" || mark == "RC");
+    entry.value = isDebit ? QString("-").append(amount) : amount;
+    entry.currency = currency;
+    entry.transactionKey = match.captured(6).mid(1);
+
+    const QString customerReference = match.captured(7).trimmed();
+    if (customerReference != "NONREF") {
+        entry.customerReference = customerReference;
+    }
+    entry.bankReference = match.captured(9).trimmed();
+
+    return true;
+}
+
+void Mt940Parser::parseDetails(const QString &details, StatementEntry &entry)
+{
+    static const QRegularExpression structuredExpression("^(\\d{3})([^0-9A-Za-z ])");
+    static const QRegularExpression ibanExpression("^[A-Z]{2}[0-9]{2}[A-Z0-9]{11,30}$");
+
+    const auto match = structuredExpression.match(details);
+    if (!match.hasMatch()) {
+        entry.purpose = details.trimmed();
+        return;
+    }
+
+    entry.transactionCode = match.captured(1).toInt();
+
+    QStringList purposeLines = {};
+    QString remoteName = "";
+    QString bankCode = "";
+    QString accountNumber = "";
+
+    const QChar separator = match.captured(2).at(0);
+    const auto fields = details.mid(3).split(separator, Qt::SkipEmptyParts);
+    for (const auto &field : fields) {
+        bool isKey = false;
+        const int key = field.left(2).toInt(&isKey);
+        if (!isKey || field.size() < 2) {
+            continue;
+        }
+
+        const QString text = field.mid(2);
+        if (key == 0) {
+            entry.transactionText = text.trimmed();
+        } else if (key == 10) {
+            entry.primanota = text.trimmed();
+        } else if ((key >= 20 && key <= 29) || (key >= 60 && key <= 63)) {
+            purposeLines << text;
+        } else if (key == 30) {
+            bankCode = text.trimmed();
+        } else if (key == 31) {
+            accountNumber = text.trimmed();
+        } else if (key == 32 || key == 33) {
+            remoteName.append(text);
+        }
+    }
+
+    entry.remoteName = remoteName.trimmed();
+
+    // SEPA bookings carry IBAN and BIC instead of account number and bank code
+    if (ibanExpression.match(accountNumber).hasMatch()) {
+        entry.remoteIban = accountNumber;
+        entry.remoteBic = bankCode;
+    } else {
+        entry.remoteAccountNumber = accountNumber;
+        entry.remoteBankCode = bankCode;
+    }
+
+    parseSepaPurpose(purposeLines, entry);
+}
+
+void Mt940Parser::parseSepaPurpose(const QStringList &lines, StatementEntry &entry)
+{
+    static const QRegularExpression keywordExpression(
+        "(EREF|KREF|MREF|CRED|DEBT|SVWZ|ABWA|ABWE|COAM|OAMT|IBAN|BIC)\\+");
+
+    // SEPA keywords split their values at the line ends, the lines are joined without gaps
+    const QString purpose = lines.join(QString());
+    auto matches = keywordExpression.globalMatch(purpose);
+    if (!matches.hasNext() || matches.peekNext().capturedStart() != 0) {
+        entry.purpose = lines.join('\n').trimmed();
+        return;
+    }
+
+    while (matches.hasNext()) {
+        const auto match = matches.next();
+        const int end = matches.hasNext() ? matches.peekNext().capturedStart() : purpose.size();
+        const QString keyword = match.captured(1);
+        const QString text = purpose.mid(match.capturedEnd(), end - match.capturedEnd()).trimmed();
+
+        if (keyword == "EREF") {
+            if (text != "NOTPROVIDED") {
+                entry.endToEndReference = text;
+            }
+        } else if (keyword == "KREF") {
+            entry.customerReference = text;
+        } else if (keyword == "MREF") {
+            entry.mandateId = text;
+        } else if (keyword == "CRED") {
+            entry.creditorSchemeId = text;
+        } else if (keyword == "SVWZ") {
+            entry.purpose = text;
+        }
+    }
+}
+
+QDate Mt940Parser::parseDate(const QString &date, const int year)
+{
+    // YYMMDD or MMDD with the year given
+    if (year < 0) {
+        const int shortYear = date.left(2).toInt();
+        return QDate(shortYear < 80 ? 2000 + shortYear : 1900 + shortYear,
+                     date.mid(2, 2).toInt(),
+                     date.mid(4, 2).toInt());
+    }
+    return QDate(year, date.left(2).toInt(), date.mid(2, 2).toInt());
+}
@@ -0,0 +1,63 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_MT940PARSER_H
+#define OLBAFLINX_MT940PARSER_H
+
+#include <QtCore/QStringList>
+
+#include "core/Statement/StatementParser.h"
+
+namespace olbaflinx::core::statement {
+
+/**
+ * SWIFT MT940 statements (.sta) line by line. The `:86:` details are read in
+ * the structured german format (`?20` ... `?63`) including the SEPA keywords
+ * of the purpose, anything else becomes the purpose as it is.
+ */
+class Mt940Parser : public StatementParser
+{
+public:
+    Mt940Parser();
+    ~Mt940Parser() override;
+
+    /**
+     * Fills date, valuta date, value, transaction key and references of the
+     * entry from the value of a `:61:` field.
+     */
+    static bool parseStatementLine(const QString &line,
+                                   const QString &currency,
+                                   StatementEntry &entry);
+
+    /**
+     * Fills the details of the entry from the value of a `:86:` field, the
+     * continuation lines already joined.
+     */
+    static void parseDetails(const QString &details, StatementEntry &entry);
+
+protected:
+    bool read(QIODevice *device, const EntryHandler &handler) override;
+
+private:
+    static void parseSepaPurpose(const QStringList &lines, StatementEntry &entry);
+    static QDate parseDate(const QString &date, const int year = -1);
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_MT940PARSER_H
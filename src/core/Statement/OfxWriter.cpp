@@ -0,0 +1,171 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtCore/QDateTime>
+
+#include "OfxWriter.h"
+
+using namespace olbaflinx::core::statement;
+
+namespace {
+
+const QString OfxDateFormat = "yyyyMMdd";
+const QString OfxDateTimeFormat = "yyyyMMddhhmmss";
+
+// OFX limits the payee to 32 characters
+const int OfxNameLength = 32;
+
+} // namespace
+
+OfxWriter::OfxWriter()
+    : StatementWriter()
+    , m_xml()
+    , m_account(Q_NULLPTR)
+    , m_statementCount(0)
+{ }
+
+OfxWriter::~OfxWriter() = default;
+
+bool OfxWriter::begin(QIODevice *device)
+{
+    if (!StatementWriter::begin(device)) {
+        return false;
+    }
+
+    m_statementCount = 0;
+    m_xml.reset(new QXmlStreamWriter(device));
+    m_xml->setAutoFormatting(true);
+
+    m_xml->writeStartDocument("1.0", false);
+    m_xml->writeProcessingInstruction("OFX",
+                                      "OFXHEADER=\"200\" VERSION=\"211\" SECURITY=\"NONE\" "
+                                      "OLDFILEUID=\"NONE\" NEWFILEUID=\"NONE\"");
+    m_xml->writeStartElement("OFX");
+
+    m_xml->writeStartElement("SIGNONMSGSRSV1");
+    m_xml->writeStartElement("SONRS");
+    writeStatus();
+    m_xml->writeTextElement("DTSERVER",
+                            QDateTime::currentDateTime().toString(OfxDateTimeFormat));
+    m_xml->writeTextElement("LANGUAGE", "GER");
+    m_xml->writeEndElement();
+    m_xml->writeEndElement();
+
+    m_xml->writeStartElement("BANKMSGSRSV1");
+
+    return !m_xml->hasError();
+}
+
+void OfxWriter::beginAccount(const Account *account, const QDate &fromDate, const QDate &toDate)
+{
+    StatementWriter::beginAccount(account, fromDate, toDate);
+    m_account = account;
+
+    m_xml->writeStartElement("STMTTRNRS");
+    m_xml->writeTextElement("TRNUID", QString::number(++m_statementCount));
+    writeStatus();
+
+    m_xml->writeStartElement("STMTRS");
+    m_xml->writeTextElement("CURDEF", account->currency().isEmpty() ? "EUR" : account->currency());
+
+    m_xml->writeStartElement("BANKACCTFROM");
+    const bool hasIban = !account->iban().isEmpty();
+    m_xml->writeTextElement("BANKID", hasIban ? account->bic() : account->bankCode());
+    m_xml->writeTextElement("ACCTID", hasIban ? account->iban() : account->accountNumber());
+    m_xml->writeTextElement("ACCTTYPE", "CHECKING");
+    m_xml->writeEndElement();
+
+    m_xml->writeStartElement("BANKTRANLIST");
+    m_xml->writeTextElement("DTSTART", fromDate.toString(OfxDateFormat));
+    m_xml->writeTextElement("DTEND", toDate.toString(OfxDateFormat));
+}
+
+void OfxWriter::write(const Transaction *transaction)
+{
+    const qreal value = transaction->value();
+    const QDate valutaDate = transaction->valutaDate();
+    const QDate date = transaction->date();
+
+    m_xml->writeStartElement("STMTTRN");
+    m_xml->writeTextElement("TRNTYPE", value < 0 ? "DEBIT" : "CREDIT");
+    const QDate postedDate = date.isValid() ? date : valutaDate;
+    m_xml->writeTextElement("DTPOSTED", postedDate.toString(OfxDateFormat));
+    if (valutaDate.isValid()) {
+        m_xml->writeTextElement("DTAVAIL", valutaDate.toString(OfxDateFormat));
+    }
+    m_xml->writeTextElement("TRNAMT", QString::number(value, 'f', 2));
+
+    // The vault hash identifies the transaction across exports
+    QString hash = transaction->hash();
+    if (hash.isEmpty()) {
+        hash = transaction->calculateTransactionHash();
+    }
+    m_xml->writeTextElement("FITID", hash);
+
+    if (!transaction->remoteName().isEmpty()) {
+        m_xml->writeTextElement("NAME", transaction->remoteName().left(OfxNameLength));
+    }
+    if (!transaction->purpose().isEmpty()) {
+        m_xml->writeTextElement("MEMO", transaction->purpose().simplified());
+    }
+    m_xml->writeEndElement();
+
+    if (m_xml->hasError()) {
+        setErrorMessage(device()->errorString());
+    }
+}
+
+void OfxWriter::endAccount()
+{
+    // BANKTRANLIST
+    m_xml->writeEndElement();
+
+    m_xml->writeStartElement("LEDGERBAL");
+    m_xml->writeTextElement("BALAMT", QString::number(m_account->balance(), 'f', 2));
+    m_xml->writeTextElement("DTASOF", QDateTime::currentDateTime().toString(OfxDateTimeFormat));
+    m_xml->writeEndElement();
+
+    // STMTRS, STMTTRNRS
+    m_xml->writeEndElement();
+    m_xml->writeEndElement();
+
+    m_account = Q_NULLPTR;
+    StatementWriter::endAccount();
+}
+
+bool OfxWriter::end()
+{
+    // BANKMSGSRSV1, OFX
+    m_xml->writeEndElement();
+    m_xml->writeEndElement();
+    m_xml->writeEndDocument();
+
+    if (m_xml->hasError()) {
+        setErrorMessage(device()->errorString());
+    }
+
+    return StatementWriter::end();
+}
+
+void OfxWriter::writeStatus()
+{
+    m_xml->writeStartElement("STATUS");
+    m_xml->writeTextElement("CODE", "0");
+    m_xml->writeTextElement("SEVERITY", "INFO");
+    m_xml->writeEndElement();
+}
@@ -0,0 +1,56 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_OFXWRITER_H
+#define OLBAFLINX_OFXWRITER_H
+
+#include <QtCore/QScopedPointer>
+#include <QtCore/QXmlStreamWriter>
+
+#include "core/Statement/StatementWriter.h"
+
+namespace olbaflinx::core::statement {
+
+/**
+ * OFX 2.1.1 (XML) bank statement response with one statement per account.
+ * The statement period has to be known up front, it is taken from the export
+ * filter or from the first and last date of the account.
+ */
+class OfxWriter : public StatementWriter
+{
+public:
+    OfxWriter();
+    ~OfxWriter() override;
+
+    bool begin(QIODevice *device) override;
+    void beginAccount(const Account *account, const QDate &fromDate, const QDate &toDate) override;
+    void write(const Transaction *transaction) override;
+    void endAccount() override;
+    bool end() override;
+
+private:
+    QScopedPointer<QXmlStreamWriter> m_xml;
+    const Account *m_account;
+    int m_statementCount;
+
+    void writeStatus();
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_OFXWRITER_H
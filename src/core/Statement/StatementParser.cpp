@@ -0,0 +1,210 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include <QtCore/QFile>
+#include <QtCore/QRegularExpression>
+
+#include "core/BankingHandle.h"
+#include "core/Statement/Camt053Parser.h"
+#include "core/Statement/Mt940Parser.h"
+#include "core/Utils.h"
+
+#include "StatementParser.h"
+
+using namespace olbaflinx::core::statement;
+
+Transaction *StatementEntry::toTransaction() const
+{
+    TransactionHandle transaction(AB_Transaction_new());
+    const auto abTransaction = transaction.get();
+
+    const auto setText = [abTransaction](void (*setter)(AB_TRANSACTION *, const char *),
+                                         const QString &text) {
+        if (!text.isEmpty()) {
+            setter(abTransaction, text.toUtf8().constData());
+        }
+    };
+    const auto setDate = [abTransaction](void (*setter)(AB_TRANSACTION *, const GWEN_DATE *),
+                                         const QDate &date) {
+        if (date.isValid()) {
+            const GwenDateHandle gwenDate(Utils::qDateToGwenDate(date));
+            setter(abTransaction, gwenDate.get());
+        }
+    };
+
+    AB_Transaction_SetType(abTransaction, AB_Transaction_TypeStatement);
+    setDate(AB_Transaction_SetDate, date);
+    setDate(AB_Transaction_SetValutaDate, valutaDate);
+
+    const ValueHandle abValue(AB_Value_fromString(value.toLatin1().constData()));
+    if (abValue) {
+        if (!currency.isEmpty()) {
+            AB_Value_SetCurrency(abValue.get(), currency.toLatin1().constData());
+        }
+        AB_Transaction_SetValue(abTransaction, abValue.get());
+    }
+
+    setText(AB_Transaction_SetLocalIban, localIban);
+    setText(AB_Transaction_SetLocalBic, localBic);
+    setText(AB_Transaction_SetLocalBankCode, localBankCode);
+    setText(AB_Transaction_SetLocalAccountNumber, localAccountNumber);
+    setText(AB_Transaction_SetRemoteName, remoteName);
+    setText(AB_Transaction_SetRemoteIban, remoteIban);
+    setText(AB_Transaction_SetRemoteBic, remoteBic);
+    setText(AB_Transaction_SetRemoteBankCode, remoteBankCode);
+    setText(AB_Transaction_SetRemoteAccountNumber, remoteAccountNumber);
+    setText(AB_Transaction_SetPurpose, purpose);
+    setText(AB_Transaction_SetTransactionText, transactionText);
+    setText(AB_Transaction_SetTransactionKey, transactionKey);
+    setText(AB_Transaction_SetPrimanota, primanota);
+    setText(AB_Transaction_SetCustomerReference, customerReference);
+    setText(AB_Transaction_SetBankReference, bankReference);
+    setText(AB_Transaction_SetEndToEndReference, endToEndReference);
+    setText(AB_Transaction_SetMandateId, mandateId);
+    setText(AB_Transaction_SetCreditorSchemeId, creditorSchemeId);
+
+    if (transactionCode > 0) {
+        AB_Transaction_SetTransactionCode(abTransaction, transactionCode);
+    }
+
+    return Transaction::adopt(transaction.release());
+}
+
+StatementParser::StatementParser()
+    : m_errorMessage("")
+{ }
+
+StatementParser::~StatementParser() = default;
+
+int StatementParser::parse(QIODevice *device,
+                           const TransactionBatchHandler &handler,
+                           const CancellationToken &token)
+{
+    m_errorMessage.clear();
+
+    // A file is checked as a whole before the first batch is handed over, so
+    // a malformed entry late in the file doesn't leave the batches before it
+    // stored. Only a sequential device can't be read twice.
+    if (!device->isSequential()) {
+        const qint64 start = device->pos();
+        const bool isValid = read(device, [&token](const StatementEntry &) {
+            return !token.isCancelled();
+        });
+        if (!isValid) {
+            return -1;
+        }
+        if (token.isCancelled() || !device->seek(start)) {
+            return 0;
+        }
+    }
+
+    int count = 0;
+    bool isStopped = false;
+    TransactionList batch = {};
+    batch.reserve(StorageImportBatchSize);
+
+    const bool isValid = read(device, [&](const StatementEntry &entry) -> bool {
+        if (token.isCancelled()) {
+            isStopped = true;
+            return false;
+        }
+
+        batch << entry.toTransaction();
+        if (batch.size() < StorageImportBatchSize) {
+            return true;
+        }
+
+        count += batch.size();
+        isStopped = !handler(batch, -1);
+        batch.clear();
+        return !isStopped;
+    });
+
+    if (!isValid) {
+        qDeleteAll(batch);
+        return -1;
+    }
+
+    if (!batch.isEmpty() && !isStopped) {
+        count += batch.size();
+        handler(batch, -1);
+    } else {
+        qDeleteAll(batch);
+    }
+
+    return count;
+}
+
+int StatementParser::parseFile(const QString &fileName,
+                               const TransactionBatchHandler &handler,
+                               const CancellationToken &token)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        setErrorMessage(file.errorString());
+        return -1;
+    }
+
+    return parse(&file, handler, token);
+}
+
+QString StatementParser::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+StatementParser::Format StatementParser::detect(QIODevice *device)
+{
+    static const QRegularExpression mt940Tag("^:(20|25|28C|60F|61):",
+                                             QRegularExpression::MultilineOption);
+
+    const QString head = QString::fromLatin1(device->peek(4096));
+    if (head.contains("camt.053")) {
+        return Camt053Format;
+    }
+    if (mt940Tag.match(head).hasMatch()) {
+        return Mt940Format;
+    }
+    return UnknownFormat;
+}
+
+StatementParser::Format StatementParser::detect(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return UnknownFormat;
+    }
+    return detect(&file);
+}
+
+StatementParser *StatementParser::create(const Format format)
+{
+    switch (format) {
+    case Mt940Format:
+        return new Mt940Parser();
+    case Camt053Format:
+        return new Camt053Parser();
+    default:
+        return Q_NULLPTR;
+    }
+}
+
+void StatementParser::setErrorMessage(const QString &message)
+{
+    m_errorMessage = message;
+}
@@ -0,0 +1,130 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_STATEMENTPARSER_H
+#define OLBAFLINX_STATEMENTPARSER_H
+
+#include <QtCore/QDate>
+#include <QtCore/QIODevice>
+#include <QtCore/QString>
+
+#include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+
+namespace olbaflinx::core::statement {
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+
+/**
+ * One booking of a statement file. Empty fields are not set on the
+ * transaction, the same as the aqbanking importers leave them unset.
+ */
+struct StatementEntry
+{
+    QDate date = {};
+    QDate valutaDate = {};
+    // Signed decimal with a dot, e.g. -12.30
+    QString value = "";
+    QString currency = "";
+    QString localIban = "";
+    QString localBic = "";
+    QString localBankCode = "";
+    QString localAccountNumber = "";
+    QString remoteName = "";
+    QString remoteIban = "";
+    QString remoteBic = "";
+    QString remoteBankCode = "";
+    QString remoteAccountNumber = "";
+    QString purpose = "";
+    QString transactionText = "";
+    QString transactionKey = "";
+    int transactionCode = 0;
+    QString primanota = "";
+    QString customerReference = "";
+    QString bankReference = "";
+    QString endToEndReference = "";
+    QString mandateId = "";
+    QString creditorSchemeId = "";
+
+    [[nodiscard]] Transaction *toTransaction() const;
+};
+
+/**
+ * Native parser of a statement format, reads the file as a stream and emits
+ * the transactions without an aqbanking importer in between.
+ */
+class StatementParser
+{
+public:
+    enum Format {
+        UnknownFormat = 0,
+        Mt940Format,
+        Camt053Format
+    };
+
+    virtual ~StatementParser();
+
+    /**
+     * Hands the transactions to `handler` in batches of `StorageImportBatchSize`.
+     * Returns the number of transactions handed over or -1 if the data isn't
+     * valid, `errorMessage` tells why. Unless the device is sequential it is
+     * validated first and no batch is handed over for invalid data. Parsers
+     * converting on several threads override it.
+     */
+    virtual int parse(QIODevice *device,
+                      const TransactionBatchHandler &handler,
+                      const CancellationToken &token = CancellationToken());
+    int parseFile(const QString &fileName,
+                  const TransactionBatchHandler &handler,
+                  const CancellationToken &token = CancellationToken());
+
+    [[nodiscard]] QString errorMessage() const;
+
+    /**
+     * Looks at the start of the data only, the device isn't moved.
+     */
+    [[nodiscard]] static Format detect(QIODevice *device);
+    [[nodiscard]] static Format detect(const QString &fileName);
+
+    /**
+     * The caller owns the parser, Q_NULLPTR for an unknown format.
+     */
+    [[nodiscard]] static StatementParser *create(const Format format);
+
+protected:
+    typedef std::function<bool(const StatementEntry &entry)> EntryHandler;
+
+    StatementParser();
+
+    /**
+     * Reads all entries of the device, stops early once `handler` returns
+     * false. Returns false if the data isn't valid.
+     */
+    virtual bool read(QIODevice *device, const EntryHandler &handler) = 0;
+    void setErrorMessage(const QString &message);
+
+private:
+    QString m_errorMessage;
+
+    Q_DISABLE_COPY(StatementParser)
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_STATEMENTPARSER_H
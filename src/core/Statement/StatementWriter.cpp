@@ -0,0 +1,123 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "core/Statement/CsvWriter.h"
+#include "core/Statement/JsonLinesWriter.h"
+#include "core/Statement/OfxWriter.h"
+
+#include "StatementWriter.h"
+
+using namespace olbaflinx::core::statement;
+
+StatementWriter::StatementWriter()
+    : m_device(Q_NULLPTR)
+    , m_errorMessage("")
+{ }
+
+StatementWriter::~StatementWriter() = default;
+
+bool StatementWriter::begin(QIODevice *device)
+{
+    m_device = device;
+    m_errorMessage.clear();
+
+    if (m_device == Q_NULLPTR || !m_device->isWritable()) {
+        setErrorMessage(QString("The device is not writable"));
+        return false;
+    }
+
+    return true;
+}
+
+void StatementWriter::beginAccount(const Account *account,
+                                   const QDate &fromDate,
+                                   const QDate &toDate)
+{
+    Q_UNUSED(account)
+    Q_UNUSED(fromDate)
+    Q_UNUSED(toDate)
+}
+
+void StatementWriter::endAccount() { }
+
+bool StatementWriter::end()
+{
+    return m_errorMessage.isEmpty();
+}
+
+QString StatementWriter::errorMessage() const
+{
+    return m_errorMessage;
+}
+
+StatementWriter::Format StatementWriter::format(const QString &exporterName)
+{
+    if (exporterName == CsvImExporterName) {
+        return CsvFormat;
+    }
+    if (exporterName == JsonLinesExporterName) {
+        return JsonLinesFormat;
+    }
+    if (exporterName == OfxExporterName) {
+        return OfxFormat;
+    }
+    return UnknownFormat;
+}
+
+QStringList StatementWriter::exporterNames()
+{
+    return QStringList({CsvImExporterName, JsonLinesExporterName, OfxExporterName});
+}
+
+StatementWriter *StatementWriter::create(const Format format)
+{
+    switch (format) {
+    case CsvFormat:
+        return new CsvWriter();
+    case JsonLinesFormat:
+        return new JsonLinesWriter();
+    case OfxFormat:
+        return new OfxWriter();
+    default:
+        return Q_NULLPTR;
+    }
+}
+
+QIODevice *StatementWriter::device() const
+{
+    return m_device;
+}
+
+bool StatementWriter::writeData(const QByteArray &data)
+{
+    if (!m_errorMessage.isEmpty()) {
+        return false;
+    }
+
+    if (m_device->write(data) != data.size()) {
+        setErrorMessage(m_device->errorString());
+        return false;
+    }
+
+    return true;
+}
+
+void StatementWriter::setErrorMessage(const QString &message)
+{
+    m_errorMessage = message;
+}
@@ -0,0 +1,94 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_STATEMENTWRITER_H
+#define OLBAFLINX_STATEMENTWRITER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDate>
+#include <QtCore/QIODevice>
+#include <QtCore/QStringList>
+
+#include "core/Container.h"
+
+namespace olbaflinx::core::statement {
+
+using namespace olbaflinx::core;
+
+/**
+ * Native writer of an export format. The transactions are written one by one
+ * as they are read from the vault, grouped by account, nothing is collected
+ * in between.
+ */
+class StatementWriter
+{
+public:
+    enum Format {
+        UnknownFormat = 0,
+        CsvFormat,
+        JsonLinesFormat,
+        OfxFormat
+    };
+
+    virtual ~StatementWriter();
+
+    virtual bool begin(QIODevice *device);
+    virtual void beginAccount(const Account *account, const QDate &fromDate, const QDate &toDate);
+    virtual void write(const Transaction *transaction) = 0;
+    virtual void endAccount();
+
+    /**
+     * Returns false if not everything could be written to the device.
+     */
+    virtual bool end();
+
+    [[nodiscard]] QString errorMessage() const;
+
+    /**
+     * The native format of an exporter name, `UnknownFormat` for the
+     * aqbanking exporters.
+     */
+    [[nodiscard]] static Format format(const QString &exporterName);
+    [[nodiscard]] static QStringList exporterNames();
+
+    /**
+     * The caller owns the writer, Q_NULLPTR for an unknown format.
+     */
+    [[nodiscard]] static StatementWriter *create(const Format format);
+
+protected:
+    StatementWriter();
+
+    QIODevice *device() const;
+
+    /**
+     * Writes to the device, after the first failure nothing is written anymore.
+     */
+    bool writeData(const QByteArray &data);
+    void setErrorMessage(const QString &message);
+
+private:
+    QIODevice *m_device;
+    QString m_errorMessage;
+
+    Q_DISABLE_COPY(StatementWriter)
+};
+
+} // namespace olbaflinx::core::statement
+
+#endif //OLBAFLINX_STATEMENTWRITER_H
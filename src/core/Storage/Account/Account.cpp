@@ -29,17 +29,11 @@ Account::Account(const AB_ACCOUNT_SPEC *accountSpec, double balance)
     , m_balance(balance)
 {}
 
-Account::~Account()
-{
-    if (abAccountSpec != nullptr) {
-        AB_AccountSpec_free(abAccountSpec);
-    }
-    abAccountSpec = nullptr;
-}
+Account::~Account() = default;
 
 qint32 Account::type() const
 {
-    return AB_AccountSpec_GetType(abAccountSpec);
+    return AB_AccountSpec_GetType(abAccountSpec.get());
 }
 
 QString Account::typeString() const
@@ -88,72 +82,72 @@ QString Account::typeString() const
 
 quint32 Account::uniqueId() const
 {
-    return AB_AccountSpec_GetUniqueId(abAccountSpec);
+    return AB_AccountSpec_GetUniqueId(abAccountSpec.get());
 }
 
 QString Account::backendName() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetBackendName(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetBackendName(abAccountSpec.get()));
 }
 
 QString Account::ownerName() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetOwnerName(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetOwnerName(abAccountSpec.get()));
 }
 
 QString Account::accountName() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetAccountName(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetAccountName(abAccountSpec.get()));
 }
 
 QString Account::currency() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetCurrency(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetCurrency(abAccountSpec.get()));
 }
 
 QString Account::memo() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetMemo(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetMemo(abAccountSpec.get()));
 }
 
 QString Account::iban() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetIban(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetIban(abAccountSpec.get()));
 }
 
 QString Account::bic() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetBic(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetBic(abAccountSpec.get()));
 }
 
 QString Account::country() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetCountry(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetCountry(abAccountSpec.get()));
 }
 
 QString Account::bankCode() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetBankCode(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetBankCode(abAccountSpec.get()));
 }
 
 QString Account::bankName() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetBankName(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetBankName(abAccountSpec.get()));
 }
 
 QString Account::branchId() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetBranchId(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetBranchId(abAccountSpec.get()));
 }
 
 QString Account::accountNumber() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetAccountNumber(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetAccountNumber(abAccountSpec.get()));
 }
 
 QString Account::subAccountNumber() const
 {
-    return QString::fromUtf8(AB_AccountSpec_GetSubAccountNumber(abAccountSpec));
+    return QString::fromUtf8(AB_AccountSpec_GetSubAccountNumber(abAccountSpec.get()));
 }
 
 double Account::balance() const
@@ -163,12 +157,12 @@ double Account::balance() const
 
 TransactionLimitsList *Account::transactionLimitsList() const
 {
-    return AB_AccountSpec_GetTransactionLimitsList(abAccountSpec);
+    return AB_AccountSpec_GetTransactionLimitsList(abAccountSpec.get());
 }
 
 TransactionLimits *Account::transactionLimitsForCommand(const AB_TRANSACTION_COMMAND &cmd) const
 {
-    return AB_AccountSpec_GetTransactionLimitsForCommand(abAccountSpec, cmd);
+    return AB_AccountSpec_GetTransactionLimitsForCommand(abAccountSpec.get(), cmd);
 }
 
 bool Account::isValid() const
@@ -230,7 +224,8 @@ QMap<QString, QVariant> Account::queryToMap(const QSqlQuery &query)
 
 Account *Account::create(const QMap<QString, QVariant> &row)
 {
-    auto accountSpec = AB_AccountSpec_new();
+    AccountSpecHandle handle(AB_AccountSpec_new());
+    const auto accountSpec = handle.get();
 
     const QString backendName = row["backendName"].toString();
     const QString ownerName = row["ownerName"].toString();
@@ -263,9 +258,5 @@ Account *Account::create(const QMap<QString, QVariant> &row)
     AB_AccountSpec_SetAccountNumber(accountSpec, accountNumber.toLocal8Bit().constData());
     AB_AccountSpec_SetSubAccountNumber(accountSpec, subAccountNumber.toLocal8Bit().constData());
 
-    const auto account = new Account(accountSpec, balance);
-
-    AB_AccountSpec_free(accountSpec);
-
-    return account;
+    return new Account(accountSpec, balance);
 }
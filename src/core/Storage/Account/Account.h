@@ -27,6 +27,8 @@
 #include <aqbanking/types/account_spec.h>
 #include <aqbanking/types/transactionlimits.h>
 
+#include "core/BankingHandle.h"
+
 namespace olbaflinx::core::storage::account {
 
 typedef AB_TRANSACTION_LIMITS TransactionLimits;
@@ -66,7 +68,7 @@ public:
     [[nodiscard]] static Account *create(const QMap<QString, QVariant> &row);
 
 private:
-    AB_ACCOUNT_SPEC *abAccountSpec;
+    AccountSpecHandle abAccountSpec;
     double m_balance;
 };
 
@@ -31,29 +31,30 @@ AccountBalance::AccountBalance(const AB_BALANCE *abBalance)
     : m_balance(AB_Balance_dup(abBalance))
 {}
 
-AccountBalance::~AccountBalance()
-{
-    AB_Balance_free(m_balance);
-}
+AccountBalance::AccountBalance(AB_BALANCE *abBalance, AdoptTag)
+    : m_balance(abBalance)
+{}
+
+AccountBalance::~AccountBalance() = default;
 
 QString AccountBalance::type() const
 {
-    return QString::fromUtf8(AB_Balance_Type_toString(AB_Balance_GetType(m_balance)));
+    return QString::fromUtf8(AB_Balance_Type_toString(AB_Balance_GetType(m_balance.get())));
 }
 
 QDate AccountBalance::date() const
 {
-    return Utils::gwenDateToQDate(AB_Balance_GetDate(m_balance));
+    return Utils::gwenDateToQDate(AB_Balance_GetDate(m_balance.get()));
 }
 
 QString AccountBalance::currency() const
 {
-    return QString::fromUtf8(AB_Value_GetCurrency(AB_Balance_GetValue(m_balance)));
+    return QString::fromUtf8(AB_Value_GetCurrency(AB_Balance_GetValue(m_balance.get())));
 }
 
 double AccountBalance::balance() const
 {
-    return AB_Value_GetValueAsDouble(AB_Balance_GetValue(m_balance));
+    return AB_Value_GetValueAsDouble(AB_Balance_GetValue(m_balance.get()));
 }
 
 QSqlQuery AccountBalance::createInsertQuery(const quint32 &accountId, QSqlQuery &query) const
@@ -61,7 +62,7 @@ QSqlQuery AccountBalance::createInsertQuery(const quint32 &accountId, QSqlQuery
     query.prepare(StorageSqlAccountBalanceInsertQuery);
     query.bindValue(":account_id", accountId);
     query.bindValue(":date", date());
-    query.bindValue(":value", date());
+    query.bindValue(":value", balance());
     query.bindValue(":type", type());
     query.bindValue(":currency", currency());
 
@@ -83,23 +84,25 @@ QMap<QString, QVariant> AccountBalance::queryToMap(const QSqlQuery &query)
 
 AccountBalance *AccountBalance::create(const QMap<QString, QVariant> &row)
 {
-    auto balance = AB_Balance_new();
+    BalanceHandle handle(AB_Balance_new());
+    const auto balance = handle.get();
 
-    auto value = AB_Value_new();
-    AB_Value_SetValueFromDouble(value, row["value"].toDouble());
-    AB_Value_SetCurrency(value, row["currency"].toString().toLocal8Bit().constData());
-    AB_Balance_SetValue(balance, AB_Value_dup(value));
-    AB_Value_free(value);
-    value = Q_NULLPTR;
+    // The setters copy value and date
+    ValueHandle value(AB_Value_new());
+    AB_Value_SetValueFromDouble(value.get(), row["value"].toDouble());
+    AB_Value_SetCurrency(value.get(), row["currency"].toString().toLocal8Bit().constData());
+    AB_Balance_SetValue(balance, value.get());
 
-    AB_Balance_SetDate(balance, Utils::qDateToGwenDate(row["value"].toDate()));
+    const GwenDateHandle date(Utils::qDateToGwenDate(row["value"].toDate()));
+    AB_Balance_SetDate(balance, date.get());
 
     const auto type = AB_Balance_Type_fromString(row["type"].toString().toLatin1().constData());
     AB_Balance_SetType(balance, type);
 
-    auto accBalance = new AccountBalance(balance);
-
-    AB_Balance_free(balance);
+    return adopt(handle.release());
+}
 
-    return accBalance;
+AccountBalance *AccountBalance::adopt(AB_BALANCE *abBalance)
+{
+    return new AccountBalance(abBalance, AdoptTag());
 }
@@ -27,6 +27,8 @@
 
 #include <aqbanking/types/balance.h>
 
+#include "core/BankingHandle.h"
+
 namespace olbaflinx::core::storage::account {
 
 class AccountBalance
@@ -44,8 +46,18 @@ public:
     [[nodiscard]] static QMap<QString, QVariant> queryToMap(const QSqlQuery &query);
     [[nodiscard]] static AccountBalance *create(const QMap<QString, QVariant> &row);
 
+    /**
+     * Takes the ownership of the aqbanking balance instead of copying it, it
+     * must not be part of a list anymore.
+     */
+    [[nodiscard]] static AccountBalance *adopt(AB_BALANCE *abBalance);
+
 private:
-    AB_BALANCE *m_balance;
+    struct AdoptTag
+    {};
+    AccountBalance(AB_BALANCE *abBalance, AdoptTag);
+
+    BalanceHandle m_balance;
 };
 
 } // namespace olbaflinx::core::storage::account
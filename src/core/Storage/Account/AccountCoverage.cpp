@@ -0,0 +1,121 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include "AccountCoverage.h"
+
+using namespace olbaflinx::core::storage::account;
+
+AccountCoverage::AccountCoverage(const DateIntervals &intervals)
+    : m_intervals({})
+{
+    for (const auto &interval : intervals) {
+        add(interval);
+    }
+}
+
+void AccountCoverage::add(const DateInterval &interval)
+{
+    if (!interval.isValid()) {
+        return;
+    }
+
+    DateInterval merged = interval;
+    DateIntervals intervals = {};
+    intervals.reserve(m_intervals.size() + 1);
+
+    for (const auto &current : qAsConst(m_intervals)) {
+        if (current.to.addDays(1) < merged.from || merged.to.addDays(1) < current.from) {
+            intervals.append(current);
+        } else {
+            merged.from = qMin(merged.from, current.from);
+            merged.to = qMax(merged.to, current.to);
+        }
+    }
+
+    const auto position = std::lower_bound(intervals.begin(),
+                                           intervals.end(),
+                                           merged,
+                                           [](const DateInterval &a, const DateInterval &b) {
+                                               return a.from < b.from;
+                                           });
+    intervals.insert(position, merged);
+
+    m_intervals = intervals;
+}
+
+DateIntervals AccountCoverage::missing(const QDate &from, const QDate &to) const
+{
+    if (!from.isValid() || !to.isValid() || from > to) {
+        return {};
+    }
+
+    DateIntervals missing = {};
+    QDate cursor = from;
+
+    for (const auto &interval : m_intervals) {
+        if (interval.to < cursor) {
+            continue;
+        }
+
+        if (interval.from > to) {
+            break;
+        }
+
+        if (interval.from > cursor) {
+            missing.append({cursor, interval.from.addDays(-1)});
+        }
+
+        cursor = interval.to.addDays(1);
+        if (cursor > to) {
+            return missing;
+        }
+    }
+
+    missing.append({cursor, to});
+    return missing;
+}
+
+bool AccountCoverage::contains(const QDate &date) const
+{
+    for (const auto &interval : m_intervals) {
+        if (date < interval.from) {
+            return false;
+        }
+
+        if (date <= interval.to) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool AccountCoverage::isEmpty() const
+{
+    return m_intervals.isEmpty();
+}
+
+QDate AccountCoverage::firstDate() const
+{
+    return m_intervals.isEmpty() ? QDate() : m_intervals.first().from;
+}
+
+DateIntervals AccountCoverage::intervals() const
+{
+    return m_intervals;
+}
@@ -0,0 +1,76 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_ACCOUNTCOVERAGE_H
+#define OLBAFLINX_ACCOUNTCOVERAGE_H
+
+#include <QtCore/QDate>
+#include <QtCore/QHash>
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
+
+namespace olbaflinx::core::storage::account {
+
+/**
+ * Days from `from` to `to`, both inclusive.
+ */
+struct DateInterval
+{
+    QDate from = QDate();
+    QDate to = QDate();
+
+    [[nodiscard]] bool isValid() const
+    {
+        return from.isValid() && to.isValid() && from <= to;
+    }
+    [[nodiscard]] bool operator==(const DateInterval &other) const
+    {
+        return from == other.from && to == other.to;
+    }
+};
+typedef QVector<DateInterval> DateIntervals;
+typedef QHash<quint32, DateIntervals> AccountDateIntervals;
+
+/**
+ * The date ranges fetched successfully for an account, kept as sorted and
+ * disjoint intervals. Overlapping and adjacent intervals are merged, so a
+ * sync only has to ask for what `missing` returns.
+ */
+class AccountCoverage
+{
+public:
+    explicit AccountCoverage(const DateIntervals &intervals = {});
+
+    void add(const DateInterval &interval);
+    [[nodiscard]] DateIntervals missing(const QDate &from, const QDate &to) const;
+    [[nodiscard]] bool contains(const QDate &date) const;
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] QDate firstDate() const;
+    [[nodiscard]] DateIntervals intervals() const;
+
+private:
+    DateIntervals m_intervals;
+};
+
+} // namespace olbaflinx::core::storage::account
+
+Q_DECLARE_METATYPE(olbaflinx::core::storage::account::DateInterval)
+Q_DECLARE_METATYPE(olbaflinx::core::storage::account::DateIntervals)
+Q_DECLARE_METATYPE(olbaflinx::core::storage::account::AccountCoverage)
+
+#endif //OLBAFLINX_ACCOUNTCOVERAGE_H
@@ -0,0 +1,211 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QQueue>
+
+#include "CategoryMatcher.h"
+
+using namespace olbaflinx::core::storage::category;
+
+#define CategoryMatcherSeparator QChar(0x1F)
+
+CategoryMatcher::CategoryMatcher(const CategoryRuleList &rules)
+    : m_rules({})
+    , m_nodes({})
+    , m_patterns({})
+    , m_rangeOnlyRules({})
+{
+    compile(rules);
+}
+
+CategoryMatcher::~CategoryMatcher() = default;
+
+void CategoryMatcher::compile(const CategoryRuleList &rules)
+{
+    m_rules = rules;
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_patterns.clear();
+    m_rangeOnlyRules.clear();
+
+    const int ruleSize = m_rules.size();
+    for (int index = 0; index < ruleSize; ++index) {
+        const auto &rule = m_rules.at(index);
+        if (rule.category.isEmpty()) {
+            continue;
+        }
+
+        const QString text = normalizeText(rule.pattern);
+        if (text.isEmpty()) {
+            m_rangeOnlyRules.append(index);
+            continue;
+        }
+
+        const CategoryRuleFields textFields = rule.fields & FieldText;
+        if (textFields != FieldNone) {
+            addPattern(text, {index, textFields});
+        }
+
+        // IBANs are compared without any whitespace
+        if (rule.fields.testFlag(FieldIban)) {
+            addPattern(QString(text).remove(' '), {index, FieldIban});
+        }
+    }
+
+    buildFailureLinks();
+}
+
+bool CategoryMatcher::isEmpty() const
+{
+    return m_patterns.isEmpty() && m_rangeOnlyRules.isEmpty();
+}
+
+int CategoryMatcher::ruleCount() const
+{
+    return m_rules.size();
+}
+
+const CategoryRule *CategoryMatcher::match(const QString &payee,
+                                           const QString &purpose,
+                                           const QString &iban,
+                                           const double value) const
+{
+    int best = -1;
+
+    for (const int index : m_rangeOnlyRules) {
+        if (m_rules.at(index).isInRange(value) && isBetter(index, best)) {
+            best = index;
+        }
+    }
+
+    if (!m_patterns.isEmpty()) {
+        const QString normalizedPayee = normalizeText(payee);
+        const QString normalizedPurpose = normalizeText(purpose);
+        const QString normalizedIban = normalizeText(iban).remove(' ');
+
+        const int payeeEnd = normalizedPayee.length();
+        const int purposeEnd = payeeEnd + 1 + normalizedPurpose.length();
+
+        const QString text = normalizedPayee + CategoryMatcherSeparator + normalizedPurpose
+                             + CategoryMatcherSeparator + normalizedIban;
+
+        int state = 0;
+        const int textSize = text.size();
+        for (int position = 0; position < textSize; ++position) {
+            const ushort c = text.at(position).unicode();
+
+            while (state != 0 && !m_nodes.at(state).next.contains(c)) {
+                state = m_nodes.at(state).fail;
+            }
+            state = m_nodes.at(state).next.value(c, 0);
+
+            const auto &outputs = m_nodes.at(state).outputs;
+            if (outputs.isEmpty()) {
+                continue;
+            }
+
+            const CategoryRuleField field = position < payeeEnd     ? FieldPayee
+                                            : position < purposeEnd ? FieldPurpose
+                                                                    : FieldIban;
+
+            for (const int patternIndex : outputs) {
+                const auto &pattern = m_patterns.at(patternIndex);
+                if (!pattern.fields.testFlag(field)) {
+                    continue;
+                }
+
+                if (m_rules.at(pattern.rule).isInRange(value) && isBetter(pattern.rule, best)) {
+                    best = pattern.rule;
+                }
+            }
+        }
+    }
+
+    return best < 0 ? Q_NULLPTR : &m_rules.at(best);
+}
+
+void CategoryMatcher::addPattern(const QString &pattern, const Pattern &data)
+{
+    int state = 0;
+    for (const QChar &c : pattern) {
+        const ushort u = c.unicode();
+        const int next = m_nodes.at(state).next.value(u, 0);
+        if (next != 0) {
+            state = next;
+            continue;
+        }
+
+        m_nodes.append(Node());
+        const int created = m_nodes.size() - 1;
+        m_nodes[state].next.insert(u, created);
+        state = created;
+    }
+
+    m_patterns.append(data);
+    m_nodes[state].outputs.append(m_patterns.size() - 1);
+}
+
+void CategoryMatcher::buildFailureLinks()
+{
+    QQueue<int> queue = {};
+    queue.enqueue(0);
+
+    while (!queue.isEmpty()) {
+        const int current = queue.dequeue();
+        const auto transitions = m_nodes.at(current).next;
+
+        for (auto it = transitions.constBegin(); it != transitions.constEnd(); ++it) {
+            const ushort c = it.key();
+            const int child = it.value();
+
+            int fail = m_nodes.at(current).fail;
+            while (fail != 0 && !m_nodes.at(fail).next.contains(c)) {
+                fail = m_nodes.at(fail).fail;
+            }
+
+            const int target = m_nodes.at(fail).next.value(c, 0);
+            m_nodes[child].fail = (target == child) ? 0 : target;
+            m_nodes[child].outputs.append(m_nodes.at(m_nodes.at(child).fail).outputs);
+
+            queue.enqueue(child);
+        }
+    }
+}
+
+bool CategoryMatcher::isBetter(int candidate, int current) const
+{
+    if (current < 0) {
+        return true;
+    }
+
+    const auto &candidateRule = m_rules.at(candidate);
+    const auto &currentRule = m_rules.at(current);
+    if (candidateRule.priority != currentRule.priority) {
+        return candidateRule.priority > currentRule.priority;
+    }
+
+    if (candidateRule.id != currentRule.id) {
+        return candidateRule.id < currentRule.id;
+    }
+
+    return candidate < current;
+}
+
+QString CategoryMatcher::normalizeText(const QString &text)
+{
+    return text.simplified().toLower().remove(CategoryMatcherSeparator);
+}
@@ -0,0 +1,84 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_CATEGORYMATCHER_H
+#define OLBAFLINX_CATEGORYMATCHER_H
+
+#include <QtCore/QHash>
+#include <QtCore/QVector>
+
+#include "core/Storage/Category/CategoryRule.h"
+
+namespace olbaflinx::core::storage::category {
+
+/**
+ * Compiles all patterns of a rule set into a single Aho-Corasick automaton.
+ *
+ * Payee, purpose and IBAN of a transaction are joined with a separator which
+ * can't be part of a pattern, so one pass over the joined text finds every
+ * pattern of every field at once. The field of a hit is derived from its end
+ * position.
+ */
+class CategoryMatcher
+{
+public:
+    explicit CategoryMatcher(const CategoryRuleList &rules = {});
+    ~CategoryMatcher();
+
+    void compile(const CategoryRuleList &rules);
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] int ruleCount() const;
+
+    /**
+     * Returns the winning rule for the given transaction data or `Q_NULLPTR`
+     * if no rule matches. The pointer stays valid until the next `compile`.
+     */
+    [[nodiscard]] const CategoryRule *match(const QString &payee,
+                                            const QString &purpose,
+                                            const QString &iban,
+                                            const double value) const;
+
+private:
+    struct Node
+    {
+        QHash<ushort, int> next = {};
+        int fail = 0;
+        // Indexes into m_patterns, including the outputs of the fail chain
+        QVector<int> outputs = {};
+    };
+
+    struct Pattern
+    {
+        int rule = 0;
+        CategoryRuleFields fields = FieldNone;
+    };
+
+    CategoryRuleList m_rules;
+    QVector<Node> m_nodes;
+    QVector<Pattern> m_patterns;
+    QVector<int> m_rangeOnlyRules;
+
+    void addPattern(const QString &pattern, const Pattern &data);
+    void buildFailureLinks();
+    [[nodiscard]] bool isBetter(int candidate, int current) const;
+
+    static QString normalizeText(const QString &text);
+};
+
+} // namespace olbaflinx::core::storage::category
+
+#endif //OLBAFLINX_CATEGORYMATCHER_H
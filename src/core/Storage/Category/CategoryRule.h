@@ -0,0 +1,73 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_CATEGORYRULE_H
+#define OLBAFLINX_CATEGORYRULE_H
+
+#include <QtCore/QFlags>
+#include <QtCore/QMetaType>
+#include <QtCore/QString>
+#include <QtCore/QVector>
+
+#include <limits>
+
+namespace olbaflinx::core::storage::category {
+
+enum CategoryRuleField {
+    FieldNone = 0x0,
+    FieldPayee = 0x1,
+    FieldPurpose = 0x2,
+    FieldIban = 0x4,
+    FieldText = FieldPayee | FieldPurpose
+};
+Q_DECLARE_FLAGS(CategoryRuleFields, CategoryRuleField)
+Q_DECLARE_OPERATORS_FOR_FLAGS(CategoryRuleFields)
+
+/**
+ * A user rule: `pattern` is searched case insensitive in the given fields of a
+ * transaction, the value of the transaction has to be within the amount range.
+ * Rules without pattern only check the amount range. If several rules match the
+ * one with the highest priority (then the lowest id) wins.
+ */
+struct CategoryRule
+{
+    quint32 id = 0;
+    QString category = "";
+    CategoryRuleFields fields = FieldText;
+    QString pattern = "";
+    double minValue = std::numeric_limits<double>::lowest();
+    double maxValue = std::numeric_limits<double>::max();
+    int priority = 0;
+
+    [[nodiscard]] bool hasMinValue() const
+    {
+        return minValue > std::numeric_limits<double>::lowest();
+    }
+    [[nodiscard]] bool hasMaxValue() const { return maxValue < std::numeric_limits<double>::max(); }
+    [[nodiscard]] bool isInRange(const double value) const
+    {
+        return value >= minValue && value <= maxValue;
+    }
+};
+typedef QVector<CategoryRule> CategoryRuleList;
+
+} // namespace olbaflinx::core::storage::category
+
+Q_DECLARE_METATYPE(olbaflinx::core::storage::category::CategoryRule)
+Q_DECLARE_METATYPE(olbaflinx::core::storage::category::CategoryRuleList)
+
+#endif //OLBAFLINX_CATEGORYRULE_H
@@ -0,0 +1,265 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QMutexLocker>
+#include <QtCore/QThread>
+#include <QtSql/QSqlQuery>
+
+#include "StorageConnection.h"
+#include "StorageExecutor.h"
+
+using namespace olbaflinx::core::storage::connection;
+
+StorageExecutor::StorageExecutor(QObject *parent)
+    : QObject(parent)
+    , m_thread(Q_NULLPTR)
+    , m_connection(Q_NULLPTR)
+    , m_fileName("")
+    , m_isOpen(false)
+    , m_isStopping(false)
+    , m_maintenance({})
+    , m_maintenanceInterval(0)
+    , m_metrics()
+    , m_totalLatency(0)
+    , m_totalRunTime(0)
+{
+    qRegisterMetaType<StorageExecutorMetrics>();
+
+    m_thread = QThread::create([this]() { process(); });
+    m_thread->setObjectName("StorageExecutor");
+    m_thread->start();
+}
+
+StorageExecutor::~StorageExecutor()
+{
+    close();
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_isStopping = true;
+        m_condition.wakeAll();
+    }
+
+    m_thread->wait();
+    delete m_thread;
+}
+
+bool StorageExecutor::open(const QString &fileName)
+{
+    return execute(Interactive, [this, fileName]() -> bool {
+        closeConnection();
+
+        m_connection = new StorageConnection(fileName);
+        const bool isOpen = m_connection->isOpen();
+
+        QMutexLocker locker(&m_mutex);
+        m_fileName = fileName;
+        m_isOpen = isOpen;
+        return isOpen;
+    });
+}
+
+void StorageExecutor::close()
+{
+    // Work queued before still runs against the connection
+    execute(Background, [this]() { closeConnection(); });
+}
+
+bool StorageExecutor::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_isOpen;
+}
+
+QString StorageExecutor::fileName() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_fileName;
+}
+
+StorageConnection *StorageExecutor::connection() const
+{
+    return m_connection;
+}
+
+bool StorageExecutor::isExecutorThread() const
+{
+    return QThread::currentThread() == m_thread;
+}
+
+StorageExecutorMetrics StorageExecutor::metrics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    StorageExecutorMetrics metrics = m_metrics;
+    metrics.queueDepth = queueDepth();
+    metrics.interactiveQueueDepth = m_queues[Interactive].size();
+    metrics.backgroundQueueDepth = m_queues[Background].size();
+    if (metrics.executedJobs > 0) {
+        metrics.averageLatency = qreal(m_totalLatency) / metrics.executedJobs;
+        metrics.averageRunTime = qreal(m_totalRunTime) / metrics.executedJobs;
+    }
+
+    return metrics;
+}
+
+void StorageExecutor::setMaintenance(const std::function<void()> &maintenance, const int interval)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maintenance = maintenance;
+    m_maintenanceInterval = interval;
+    m_sinceMaintenance.start();
+}
+
+void StorageExecutor::push(const Priority priority, Job job)
+{
+    QMutexLocker locker(&m_mutex);
+
+    job.queued.start();
+    m_queues[priority].enqueue(job);
+    m_condition.wakeOne();
+}
+
+QQueue<StorageExecutor::Job> *StorageExecutor::nextQueue()
+{
+    for (auto &queue : m_queues) {
+        if (!queue.isEmpty()) {
+            return &queue;
+        }
+    }
+
+    return Q_NULLPTR;
+}
+
+int StorageExecutor::queueDepth() const
+{
+    int depth = 0;
+    for (const auto &queue : m_queues) {
+        depth += queue.size();
+    }
+
+    return depth;
+}
+
+void StorageExecutor::process()
+{
+    forever {
+        QVector<Job> jobs = {};
+
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_isStopping && queueDepth() == 0) {
+                m_condition.wait(&m_mutex);
+            }
+
+            QQueue<Job> *queue = nextQueue();
+            if (queue == Q_NULLPTR) {
+                return;
+            }
+
+            jobs << queue->dequeue();
+            while (jobs.first().isWrite && jobs.size() < StorageGroupCommitSize) {
+                queue = nextQueue();
+                if (queue == Q_NULLPTR || !queue->head().isWrite) {
+                    break;
+                }
+                jobs << queue->dequeue();
+            }
+        }
+
+        const bool isTransaction = jobs.first().isWrite && m_connection != Q_NULLPTR;
+        const bool isGroupCommit = isTransaction && jobs.size() > 1;
+        if (isTransaction) {
+            m_connection->begindTransaction();
+        }
+
+        qint64 latency = 0;
+        qint64 maximumLatency = 0;
+        QElapsedTimer runTime;
+        runTime.start();
+
+        for (auto &job : jobs) {
+            const qint64 jobLatency = job.queued.elapsed();
+            latency += jobLatency;
+            maximumLatency = qMax(maximumLatency, jobLatency);
+
+            if (!isTransaction) {
+                job.run();
+                continue;
+            }
+
+            // A failed write is undone without the others of the transaction
+            QSqlQuery query(m_connection->database());
+            query.exec(StorageSqlWriteSavepointQuery);
+            if (!job.run()) {
+                query.exec(StorageSqlWriteRollbackQuery);
+            }
+            query.exec(StorageSqlWriteReleaseQuery);
+        }
+
+        if (isTransaction) {
+            m_connection->commitTransaction();
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_metrics.executedJobs += jobs.size();
+            m_metrics.maximumLatency = qMax(m_metrics.maximumLatency, maximumLatency);
+            m_totalLatency += latency;
+            m_totalRunTime += runTime.elapsed();
+            if (isGroupCommit) {
+                ++m_metrics.groupCommits;
+                m_metrics.coalescedWrites += jobs.size();
+            }
+        }
+
+        // Callers see the result only when it is committed
+        for (auto &job : jobs) {
+            job.finish();
+        }
+
+        std::function<void()> maintenance = {};
+        {
+            QMutexLocker locker(&m_mutex);
+            const bool isDue = queueDepth() == 0
+                               || m_sinceMaintenance.hasExpired(m_maintenanceInterval);
+            if (m_maintenance && isDue) {
+                maintenance = m_maintenance;
+                m_sinceMaintenance.restart();
+            }
+        }
+
+        if (maintenance) {
+            maintenance();
+        }
+    }
+}
+
+void StorageExecutor::closeConnection()
+{
+    if (m_connection != Q_NULLPTR) {
+        if (m_connection->isOpen()) {
+            m_connection->close();
+        }
+        delete m_connection;
+        m_connection = Q_NULLPTR;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_fileName = "";
+    m_isOpen = false;
+}
@@ -0,0 +1,214 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_STORAGEEXECUTOR_H
+#define OLBAFLINX_STORAGEEXECUTOR_H
+
+#include <functional>
+#include <type_traits>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureInterface>
+#include <QtCore/QMetaType>
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QQueue>
+#include <QtCore/QWaitCondition>
+
+#include "core/Constant.h"
+
+class QThread;
+
+namespace olbaflinx::core::storage::connection {
+
+class StorageConnection;
+
+struct StorageExecutorMetrics
+{
+    int queueDepth = 0;
+    int interactiveQueueDepth = 0;
+    int backgroundQueueDepth = 0;
+    qint64 executedJobs = 0;
+    qint64 groupCommits = 0;
+    // Small writes committed together with others
+    qint64 coalescedWrites = 0;
+    // Milliseconds from queuing a job until it starts
+    qreal averageLatency = 0.0;
+    qint64 maximumLatency = 0;
+    // Milliseconds a job runs
+    qreal averageRunTime = 0.0;
+};
+
+/**
+ * Owns the write connection of a vault on one long living thread and executes
+ * all jobs against it one after another. Interactive jobs are taken before
+ * normal ones and those before background work, jobs of the same priority in
+ * the order they were queued.
+ *
+ * Small writes (`write`) run in a transaction, those waiting right behind each
+ * other are committed in the same one. Their futures finish after the commit.
+ */
+class StorageExecutor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Priority {
+        Interactive = 0,
+        Normal = 1,
+        Background = 2
+    };
+    Q_ENUM(Priority)
+
+    explicit StorageExecutor(QObject *parent = Q_NULLPTR);
+    ~StorageExecutor() override;
+
+    bool open(const QString &fileName);
+    void close();
+    [[nodiscard]] bool isOpen() const;
+    [[nodiscard]] QString fileName() const;
+
+    /**
+     * Must only be used inside a job, the connection belongs to the thread of
+     * the executor.
+     */
+    [[nodiscard]] StorageConnection *connection() const;
+    [[nodiscard]] bool isExecutorThread() const;
+
+    [[nodiscard]] StorageExecutorMetrics metrics() const;
+
+    /**
+     * Runs on the executor thread after jobs as soon as the queue is empty,
+     * while jobs keep coming at least every `interval` milliseconds.
+     */
+    void setMaintenance(const std::function<void()> &maintenance, const int interval);
+
+    template<typename Function>
+    auto run(const Priority priority, Function function) -> QFuture<decltype(function())>
+    {
+        return enqueue(priority, false, function);
+    }
+
+    /**
+     * The job must not start a transaction of its own. A job returning false
+     * is rolled back, without the writes committed together with it.
+     */
+    template<typename Function>
+    auto write(Function function) -> QFuture<decltype(function())>
+    {
+        return enqueue(Normal, true, function);
+    }
+
+    /**
+     * Waits for the result of the job, called from a job it runs directly.
+     */
+    template<typename Function>
+    auto execute(const Priority priority, Function function) -> decltype(function())
+    {
+        if (isExecutorThread()) {
+            return function();
+        }
+        return result(run(priority, function));
+    }
+
+    template<typename Function>
+    auto executeWrite(Function function) -> decltype(function())
+    {
+        if (isExecutorThread()) {
+            return function();
+        }
+        return result(write(function));
+    }
+
+private:
+    struct Job
+    {
+        // False if the writes of the job have to be rolled back
+        std::function<bool()> run = {};
+        std::function<void()> finish = {};
+        QElapsedTimer queued = {};
+        bool isWrite = false;
+    };
+
+    QThread *m_thread;
+    QQueue<Job> m_queues[Background + 1];
+    StorageConnection *m_connection;
+    QString m_fileName;
+    bool m_isOpen;
+    bool m_isStopping;
+    std::function<void()> m_maintenance;
+    int m_maintenanceInterval;
+    QElapsedTimer m_sinceMaintenance;
+    StorageExecutorMetrics m_metrics;
+    qint64 m_totalLatency;
+    qint64 m_totalRunTime;
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+
+    template<typename Function>
+    auto enqueue(const Priority priority, const bool isWrite, Function function)
+        -> QFuture<decltype(function())>
+    {
+        using Result = decltype(function());
+
+        QFutureInterface<Result> futureInterface;
+        futureInterface.reportStarted();
+
+        Job job;
+        job.isWrite = isWrite;
+        job.run = [futureInterface, function]() mutable -> bool {
+            if constexpr (std::is_void_v<Result>) {
+                function();
+                return true;
+            } else {
+                const Result result = function();
+                futureInterface.reportResult(result);
+                if constexpr (std::is_same_v<Result, bool>) {
+                    return result;
+                } else {
+                    return true;
+                }
+            }
+        };
+        job.finish = [futureInterface]() mutable { futureInterface.reportFinished(); };
+        push(priority, job);
+
+        return futureInterface.future();
+    }
+
+    template<typename Result>
+    static Result result(QFuture<Result> future)
+    {
+        future.waitForFinished();
+        if constexpr (!std::is_void_v<Result>) {
+            return future.result();
+        }
+    }
+
+    void push(const Priority priority, Job job);
+    [[nodiscard]] QQueue<Job> *nextQueue();
+    [[nodiscard]] int queueDepth() const;
+    void process();
+    void closeConnection();
+};
+
+} // namespace olbaflinx::core::storage::connection
+
+Q_DECLARE_METATYPE(olbaflinx::core::storage::connection::StorageExecutorMetrics)
+
+#endif //OLBAFLINX_STORAGEEXECUTOR_H
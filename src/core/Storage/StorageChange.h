@@ -0,0 +1,55 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_STORAGECHANGE_H
+#define OLBAFLINX_STORAGECHANGE_H
+
+#include <QtCore/QMetaType>
+#include <QtCore/QVector>
+
+namespace olbaflinx::core::storage {
+
+enum StorageChangeSubject { SubjectAccount = 0, SubjectTransaction };
+
+/**
+ * What a committed write of `VaultStorage` changed in one account.
+ *
+ * For `SubjectAccount` the ids are unique ids of accounts, otherwise ids of
+ * transactions of `accountId`. `generation` counts the changes per account,
+ * a view that saw the previous generation can apply the change on its own
+ * instead of reloading.
+ */
+struct StorageChange
+{
+    StorageChangeSubject subject = SubjectTransaction;
+    quint32 accountId = 0;
+    QVector<qint64> inserted = {};
+    QVector<qint64> updated = {};
+    QVector<qint64> deleted = {};
+    quint64 generation = 0;
+
+    [[nodiscard]] bool isEmpty() const
+    {
+        return inserted.isEmpty() && updated.isEmpty() && deleted.isEmpty();
+    }
+};
+
+} // namespace olbaflinx::core::storage
+
+Q_DECLARE_METATYPE(olbaflinx::core::storage::StorageChange)
+
+#endif //OLBAFLINX_STORAGECHANGE_H
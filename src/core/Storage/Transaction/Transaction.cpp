@@ -30,164 +30,165 @@ Transaction::Transaction(const AB_TRANSACTION *transaction)
     : abTransaction(AB_Transaction_dup(transaction))
 { }
 
-Transaction::~Transaction()
-{
-    AB_Transaction_free(abTransaction);
-}
+Transaction::Transaction(AB_TRANSACTION *transaction, AdoptTag)
+    : abTransaction(transaction)
+{ }
+
+Transaction::~Transaction() = default;
 
 TransactionType Transaction::type() const
 {
-    return AB_Transaction_GetType(abTransaction);
+    return AB_Transaction_GetType(abTransaction.get());
 }
 
 TransactionSubType Transaction::subType() const
 {
-    return AB_Transaction_GetSubType(abTransaction);
+    return AB_Transaction_GetSubType(abTransaction.get());
 }
 
 TransactionCommand Transaction::command() const
 {
-    return AB_Transaction_GetCommand(abTransaction);
+    return AB_Transaction_GetCommand(abTransaction.get());
 }
 
 TransactionStatus Transaction::status() const
 {
-    return AB_Transaction_GetStatus(abTransaction);
+    return AB_Transaction_GetStatus(abTransaction.get());
 }
 
 quint32 Transaction::uniqueAccountId() const
 {
-    return AB_Transaction_GetUniqueAccountId(abTransaction);
+    return AB_Transaction_GetUniqueAccountId(abTransaction.get());
 }
 
 quint32 Transaction::uniqueId() const
 {
-    return AB_Transaction_GetUniqueId(abTransaction);
+    return AB_Transaction_GetUniqueId(abTransaction.get());
 }
 
 quint32 Transaction::refUniqueId() const
 {
-    return AB_Transaction_GetRefUniqueId(abTransaction);
+    return AB_Transaction_GetRefUniqueId(abTransaction.get());
 }
 
 quint32 Transaction::idForApplication() const
 {
-    return AB_Transaction_GetIdForApplication(abTransaction);
+    return AB_Transaction_GetIdForApplication(abTransaction.get());
 }
 
 QString Transaction::stringIdForApplication() const
 {
-    return QString::fromUtf8(AB_Transaction_GetStringIdForApplication(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetStringIdForApplication(abTransaction.get()));
 }
 
 quint32 Transaction::sessionId() const
 {
-    return AB_Transaction_GetSessionId(abTransaction);
+    return AB_Transaction_GetSessionId(abTransaction.get());
 }
 
 quint32 Transaction::groupId() const
 {
-    return AB_Transaction_GetGroupId(abTransaction);
+    return AB_Transaction_GetGroupId(abTransaction.get());
 }
 
 QString Transaction::fiId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetFiId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetFiId(abTransaction.get()));
 }
 
 QString Transaction::localIban() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalIban(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalIban(abTransaction.get()));
 }
 
 QString Transaction::localBic() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalBic(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalBic(abTransaction.get()));
 }
 
 QString Transaction::localCountry() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalCountry(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalCountry(abTransaction.get()));
 }
 
 QString Transaction::localBankCode() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalBankCode(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalBankCode(abTransaction.get()));
 }
 
 QString Transaction::localBranchId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalBranchId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalBranchId(abTransaction.get()));
 }
 
 QString Transaction::localAccountNumber() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalAccountNumber(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalAccountNumber(abTransaction.get()));
 }
 
 QString Transaction::localSuffix() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalSuffix(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalSuffix(abTransaction.get()));
 }
 
 QString Transaction::localName() const
 {
-    return QString::fromUtf8(AB_Transaction_GetLocalName(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetLocalName(abTransaction.get()));
 }
 
 QString Transaction::remoteCountry() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteCountry(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteCountry(abTransaction.get()));
 }
 
 QString Transaction::remoteBankCode() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteBankCode(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteBankCode(abTransaction.get()));
 }
 
 QString Transaction::remoteBranchId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteBranchId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteBranchId(abTransaction.get()));
 }
 
 QString Transaction::remoteAccountNumber() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteAccountNumber(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteAccountNumber(abTransaction.get()));
 }
 
 QString Transaction::remoteSuffix() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteSuffix(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteSuffix(abTransaction.get()));
 }
 
 QString Transaction::remoteIban() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteIban(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteIban(abTransaction.get()));
 }
 
 QString Transaction::remoteBic() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteBic(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteBic(abTransaction.get()));
 }
 
 QString Transaction::remoteName() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteName(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteName(abTransaction.get()));
 }
 
 QDate Transaction::date() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetDate(abTransaction.get()));
 }
 
 QDate Transaction::valutaDate() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetValutaDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetValutaDate(abTransaction.get()));
 }
 
 qreal Transaction::value() const
 {
-    const auto value = AB_Transaction_GetValue(abTransaction);
+    const auto value = AB_Transaction_GetValue(abTransaction.get());
     if (value == nullptr) {
         return 0.0;
     }
@@ -197,12 +198,12 @@ qreal Transaction::value() const
 
 QString Transaction::currency() const
 {
-    return QString::fromUtf8(AB_Value_GetCurrency(AB_Transaction_GetValue(abTransaction)));
+    return QString::fromUtf8(AB_Value_GetCurrency(AB_Transaction_GetValue(abTransaction.get())));
 }
 
 qreal Transaction::fees() const
 {
-    const auto fees = AB_Transaction_GetFees(abTransaction);
+    const auto fees = AB_Transaction_GetFees(abTransaction.get());
     if (fees == nullptr) {
         return 0.0;
     }
@@ -212,172 +213,172 @@ qreal Transaction::fees() const
 
 int Transaction::transactionCode() const
 {
-    return AB_Transaction_GetTransactionCode(abTransaction);
+    return AB_Transaction_GetTransactionCode(abTransaction.get());
 }
 
 QString Transaction::transactionText() const
 {
-    return QString::fromUtf8(AB_Transaction_GetTransactionText(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetTransactionText(abTransaction.get()));
 }
 
 QString Transaction::transactionKey() const
 {
-    return QString::fromUtf8(AB_Transaction_GetTransactionKey(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetTransactionKey(abTransaction.get()));
 }
 
 int Transaction::textKey() const
 {
-    return AB_Transaction_GetTextKey(abTransaction);
+    return AB_Transaction_GetTextKey(abTransaction.get());
 }
 
 QString Transaction::primanota() const
 {
-    return QString::fromUtf8(AB_Transaction_GetPrimanota(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetPrimanota(abTransaction.get()));
 }
 
 QString Transaction::purpose() const
 {
-    return QString::fromUtf8(AB_Transaction_GetPurpose(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetPurpose(abTransaction.get()));
 }
 
 QString Transaction::category() const
 {
-    return QString::fromUtf8(AB_Transaction_GetCategory(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetCategory(abTransaction.get()));
 }
 
 QString Transaction::customerReference() const
 {
-    return QString::fromUtf8(AB_Transaction_GetCustomerReference(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetCustomerReference(abTransaction.get()));
 }
 
 QString Transaction::bankReference() const
 {
-    return QString::fromUtf8(AB_Transaction_GetBankReference(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetBankReference(abTransaction.get()));
 }
 
 QString Transaction::endToEndReference() const
 {
-    return QString::fromUtf8(AB_Transaction_GetEndToEndReference(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetEndToEndReference(abTransaction.get()));
 }
 
 QString Transaction::creditorSchemeId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetCreditorSchemeId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetCreditorSchemeId(abTransaction.get()));
 }
 
 QString Transaction::originatorId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetOriginatorId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetOriginatorId(abTransaction.get()));
 }
 
 QString Transaction::mandateId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetMandateId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetMandateId(abTransaction.get()));
 }
 
 QDate Transaction::mandateDate() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetMandateDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetMandateDate(abTransaction.get()));
 }
 
 QString Transaction::mandateDebitorName() const
 {
-    return QString::fromUtf8(AB_Transaction_GetMandateDebitorName(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetMandateDebitorName(abTransaction.get()));
 }
 
 QString Transaction::originalCreditorSchemeId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetOriginalCreditorSchemeId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetOriginalCreditorSchemeId(abTransaction.get()));
 }
 
 QString Transaction::originalMandateId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetOriginalMandateId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetOriginalMandateId(abTransaction.get()));
 }
 
 QString Transaction::originalCreditorName() const
 {
-    return QString::fromUtf8(AB_Transaction_GetOriginalCreditorName(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetOriginalCreditorName(abTransaction.get()));
 }
 
 TransactionSequence Transaction::sequence() const
 {
-    return AB_Transaction_GetSequence(abTransaction);
+    return AB_Transaction_GetSequence(abTransaction.get());
 }
 
 TransactionCharge Transaction::charge() const
 {
-    return AB_Transaction_GetCharge(abTransaction);
+    return AB_Transaction_GetCharge(abTransaction.get());
 }
 
 QString Transaction::remoteAddrStreet() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteAddrStreet(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteAddrStreet(abTransaction.get()));
 }
 
 QString Transaction::remoteAddrZipcode() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteAddrZipcode(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteAddrZipcode(abTransaction.get()));
 }
 
 QString Transaction::remoteAddrCity() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteAddrCity(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteAddrCity(abTransaction.get()));
 }
 
 QString Transaction::remoteAddrPhone() const
 {
-    return QString::fromUtf8(AB_Transaction_GetRemoteAddrPhone(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetRemoteAddrPhone(abTransaction.get()));
 }
 
 TransactionPeriod Transaction::period() const
 {
-    return AB_Transaction_GetPeriod(abTransaction);
+    return AB_Transaction_GetPeriod(abTransaction.get());
 }
 
 quint32 Transaction::cycle() const
 {
-    return AB_Transaction_GetCycle(abTransaction);
+    return AB_Transaction_GetCycle(abTransaction.get());
 }
 
 quint32 Transaction::executionDay() const
 {
-    return AB_Transaction_GetExecutionDay(abTransaction);
+    return AB_Transaction_GetExecutionDay(abTransaction.get());
 }
 
 QDate Transaction::firstDate() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetFirstDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetFirstDate(abTransaction.get()));
 }
 
 QDate Transaction::lastDate() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetLastDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetLastDate(abTransaction.get()));
 }
 
 QDate Transaction::nextDate() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetNextDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetNextDate(abTransaction.get()));
 }
 
 QString Transaction::unitId() const
 {
-    return QString::fromUtf8(AB_Transaction_GetUnitId(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetUnitId(abTransaction.get()));
 }
 
 QString Transaction::unitIdNameSpace() const
 {
-    return QString::fromUtf8(AB_Transaction_GetUnitIdNameSpace(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetUnitIdNameSpace(abTransaction.get()));
 }
 
 QString Transaction::tickerSymbol() const
 {
-    return QString::fromUtf8(AB_Transaction_GetTickerSymbol(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetTickerSymbol(abTransaction.get()));
 }
 
 qreal Transaction::units() const
 {
-    const auto units = AB_Transaction_GetUnits(abTransaction);
+    const auto units = AB_Transaction_GetUnits(abTransaction.get());
     if (units == nullptr) {
         return 0.0;
     }
@@ -387,7 +388,7 @@ qreal Transaction::units() const
 
 qreal Transaction::unitPriceValue() const
 {
-    const auto unitPriceValue = AB_Transaction_GetUnitPriceValue(abTransaction);
+    const auto unitPriceValue = AB_Transaction_GetUnitPriceValue(abTransaction.get());
     if (unitPriceValue == nullptr) {
         return 0.0;
     }
@@ -397,12 +398,12 @@ qreal Transaction::unitPriceValue() const
 
 QDate Transaction::unitPriceDate() const
 {
-    return Utils::gwenDateToQDate(AB_Transaction_GetUnitPriceDate(abTransaction));
+    return Utils::gwenDateToQDate(AB_Transaction_GetUnitPriceDate(abTransaction.get()));
 }
 
 qreal Transaction::commissionValue() const
 {
-    const auto commissionValue = AB_Transaction_GetCommissionValue(abTransaction);
+    const auto commissionValue = AB_Transaction_GetCommissionValue(abTransaction.get());
     if (commissionValue == nullptr) {
         return 0.0;
     }
@@ -412,12 +413,12 @@ qreal Transaction::commissionValue() const
 
 QString Transaction::memo() const
 {
-    return QString::fromUtf8(AB_Transaction_GetMemo(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetMemo(abTransaction.get()));
 }
 
 QString Transaction::hash() const
 {
-    return QString::fromUtf8(AB_Transaction_GetHash(abTransaction));
+    return QString::fromUtf8(AB_Transaction_GetHash(abTransaction.get()));
 }
 
 QString Transaction::toString() const
@@ -436,6 +437,10 @@ QString Transaction::calculateTransactionHash() const
         return hash();
     }
 
+    if (!m_fingerprint.isEmpty()) {
+        return m_fingerprint;
+    }
+
     QByteArray buffer;
     QDataStream out(&buffer, QIODevice::WriteOnly);
     out.setVersion(QDataStream::Qt_5_15);
@@ -445,7 +450,18 @@ QString Transaction::calculateTransactionHash() const
 
     buffer.clear();
 
-    return QString("%1").arg(QString(hash.toHex()));
+    m_fingerprint = QString("%1").arg(QString(hash.toHex()));
+    return m_fingerprint;
+}
+
+void Transaction::fingerprint() const
+{
+    calculateTransactionHash();
+}
+
+AB_TRANSACTION *Transaction::dup() const
+{
+    return AB_Transaction_dup(abTransaction.get());
 }
 
 QSqlQuery Transaction::createInsertQuery(const quint32 &accountId, QSqlQuery &query) const
@@ -611,7 +627,13 @@ QMap<QString, QVariant> Transaction::queryToMap(const QSqlQuery &query)
 
 Transaction *Transaction::create(const QMap<QString, QVariant> &row)
 {
-    auto abTransaction = AB_Transaction_new();
+    TransactionHandle transaction(AB_Transaction_new());
+    const auto abTransaction = transaction.get();
+
+    // The setters copy dates and values, the handles free the temporaries
+    const auto date = [&row](const char *key) {
+        return GwenDateHandle(Utils::qDateToGwenDate(row[key].toDate()));
+    };
 
     AB_Transaction_SetType(abTransaction, (TransactionType) row["type"].toInt());
     AB_Transaction_SetSubType(abTransaction, (TransactionSubType) row["subType"].toInt());
@@ -657,21 +679,17 @@ Transaction *Transaction::create(const QMap<QString, QVariant> &row)
                                 row["remoteBic"].toString().toLocal8Bit().constData());
     AB_Transaction_SetRemoteName(abTransaction,
                                  row["remoteName"].toString().toLocal8Bit().constData());
-    AB_Transaction_SetDate(abTransaction, Utils::qDateToGwenDate(row["date"].toDate()));
-    AB_Transaction_SetValutaDate(abTransaction, Utils::qDateToGwenDate(row["valutaDate"].toDate()));
-
-    auto value = AB_Value_new();
-    AB_Value_SetValueFromDouble(value, row["value"].toDouble());
-    AB_Value_SetCurrency(value, row["currency"].toString().toLocal8Bit().constData());
-    AB_Transaction_SetValue(abTransaction, AB_Value_dup(value));
-    AB_Value_free(value);
-    value = nullptr;
-
-    value = AB_Value_new();
-    AB_Value_SetValueFromDouble(value, row["fees"].toDouble());
-    AB_Transaction_SetFees(abTransaction, AB_Value_dup(value));
-    AB_Value_free(value);
-    value = nullptr;
+    AB_Transaction_SetDate(abTransaction, date("date").get());
+    AB_Transaction_SetValutaDate(abTransaction, date("valutaDate").get());
+
+    ValueHandle value(AB_Value_new());
+    AB_Value_SetValueFromDouble(value.get(), row["value"].toDouble());
+    AB_Value_SetCurrency(value.get(), row["currency"].toString().toLocal8Bit().constData());
+    AB_Transaction_SetValue(abTransaction, value.get());
+
+    value.reset(AB_Value_new());
+    AB_Value_SetValueFromDouble(value.get(), row["fees"].toDouble());
+    AB_Transaction_SetFees(abTransaction, value.get());
 
     AB_Transaction_SetTransactionCode(abTransaction, row["transactionCode"].toInt());
     AB_Transaction_SetTransactionText(abTransaction,
@@ -695,8 +713,7 @@ Transaction *Transaction::create(const QMap<QString, QVariant> &row)
                                    row["originatorId"].toString().toLocal8Bit().constData());
     AB_Transaction_SetMandateId(abTransaction,
                                 row["mandateId"].toString().toLocal8Bit().constData());
-    AB_Transaction_SetMandateDate(abTransaction,
-                                  Utils::qDateToGwenDate(row["mandateDate"].toDate()));
+    AB_Transaction_SetMandateDate(abTransaction, date("mandateDate").get());
     AB_Transaction_SetMandateDebitorName(
         abTransaction, row["mandateDebitorName"].toString().toLocal8Bit().constData());
     AB_Transaction_SetOriginalCreditorSchemeId(
@@ -718,45 +735,38 @@ Transaction *Transaction::create(const QMap<QString, QVariant> &row)
     AB_Transaction_SetPeriod(abTransaction, (TransactionPeriod) row["period"].toInt());
     AB_Transaction_SetCycle(abTransaction, row["cycle"].toUInt());
     AB_Transaction_SetExecutionDay(abTransaction, row["executionDay"].toUInt());
-    AB_Transaction_SetFirstDate(abTransaction, Utils::qDateToGwenDate(row["firstDate"].toDate()));
-    AB_Transaction_SetLastDate(abTransaction, Utils::qDateToGwenDate(row["lastDate"].toDate()));
-    AB_Transaction_SetNextDate(abTransaction, Utils::qDateToGwenDate(row["nextDate"].toDate()));
+    AB_Transaction_SetFirstDate(abTransaction, date("firstDate").get());
+    AB_Transaction_SetLastDate(abTransaction, date("lastDate").get());
+    AB_Transaction_SetNextDate(abTransaction, date("nextDate").get());
     AB_Transaction_SetUnitId(abTransaction, row["unitId"].toString().toLocal8Bit().constData());
     AB_Transaction_SetUnitIdNameSpace(abTransaction,
                                       row["unitIdNameSpace"].toString().toLocal8Bit().constData());
     AB_Transaction_SetTickerSymbol(abTransaction,
                                    row["tickerSymbol"].toString().toLocal8Bit().constData());
 
-    value = AB_Value_new();
-    AB_Value_SetValueFromDouble(value, row["units"].toDouble());
-    AB_Transaction_SetUnits(abTransaction, AB_Value_dup(value));
-    AB_Value_free(value);
-    value = nullptr;
+    value.reset(AB_Value_new());
+    AB_Value_SetValueFromDouble(value.get(), row["units"].toDouble());
+    AB_Transaction_SetUnits(abTransaction, value.get());
 
-    value = AB_Value_new();
-    AB_Value_SetValueFromDouble(value, row["unitPriceValue"].toDouble());
-    AB_Transaction_SetUnitPriceValue(abTransaction, AB_Value_dup(value));
-    AB_Value_free(value);
-    value = nullptr;
+    value.reset(AB_Value_new());
+    AB_Value_SetValueFromDouble(value.get(), row["unitPriceValue"].toDouble());
+    AB_Transaction_SetUnitPriceValue(abTransaction, value.get());
 
-    AB_Transaction_SetUnitPriceDate(abTransaction,
-                                    Utils::qDateToGwenDate(row["unitPriceDate"].toDate()));
+    AB_Transaction_SetUnitPriceDate(abTransaction, date("unitPriceDate").get());
 
-    value = AB_Value_new();
-    AB_Value_SetValueFromDouble(value, row["commissionValue"].toDouble());
-    AB_Transaction_SetCommissionValue(abTransaction, AB_Value_dup(value));
-    AB_Value_free(value);
-    value = nullptr;
+    value.reset(AB_Value_new());
+    AB_Value_SetValueFromDouble(value.get(), row["commissionValue"].toDouble());
+    AB_Transaction_SetCommissionValue(abTransaction, value.get());
 
     AB_Transaction_SetMemo(abTransaction, row["memo"].toString().toLocal8Bit().constData());
     AB_Transaction_SetHash(abTransaction, row["hash"].toString().toLocal8Bit().constData());
 
-    const auto transaction = new Transaction(abTransaction);
-
-    AB_Transaction_free(abTransaction);
-    abTransaction = nullptr;
+    return adopt(transaction.release());
+}
 
-    return transaction;
+Transaction *Transaction::adopt(AB_TRANSACTION *transaction)
+{
+    return new Transaction(transaction, AdoptTag());
 }
 QMap<QString, QVariant> Transaction::toInternalMap() const
 {
@@ -26,6 +26,8 @@
 #include <aqbanking/types/transaction.h>
 #include <aqbanking/types/transactionlimits.h>
 
+#include "core/BankingHandle.h"
+
 namespace olbaflinx::core::storage::transaction {
 
 typedef AB_TRANSACTION_TYPE TransactionType;
@@ -119,12 +121,35 @@ public:
     [[nodiscard]] bool isStandingOrder() const;
     [[nodiscard]] QString calculateTransactionHash() const;
 
+    /**
+     * Calculates the hash ahead of storing the transaction, it's kept in the
+     * wrapper and the aqbanking transaction stays untouched.
+     */
+    void fingerprint() const;
+
+    /**
+     * A copy of the aqbanking transaction owned by the caller, e.g. to hand it
+     * to an exporter context.
+     */
+    [[nodiscard]] AB_TRANSACTION *dup() const;
+
     [[nodiscard]] QSqlQuery createInsertQuery(const quint32 &accountId, QSqlQuery &query) const;
     [[nodiscard]] static QMap<QString, QVariant> queryToMap(const QSqlQuery &query);
     [[nodiscard]] static Transaction *create(const QMap<QString, QVariant> &row);
 
+    /**
+     * Takes the ownership of the aqbanking transaction instead of copying it,
+     * it must not be part of a list anymore.
+     */
+    [[nodiscard]] static Transaction *adopt(AB_TRANSACTION *transaction);
+
 private:
-    AB_TRANSACTION *abTransaction;
+    struct AdoptTag
+    {};
+    Transaction(AB_TRANSACTION *transaction, AdoptTag);
+
+    TransactionHandle abTransaction;
+    mutable QString m_fingerprint;
 
     QMap<QString, QVariant> toInternalMap() const;
 };
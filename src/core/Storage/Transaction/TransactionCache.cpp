@@ -0,0 +1,189 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtCore/QCache>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+
+#include "TransactionCache.h"
+
+using namespace olbaflinx::core::storage::transaction;
+
+class TransactionCache::Private
+{
+public:
+    explicit Private(const qint64 memoryBudget)
+        : m_pages(costOf(memoryBudget))
+        , m_memoryBudget(memoryBudget)
+        , m_generation(0)
+    { }
+
+    /**
+     * Everything that changes the rows of a page is part of the key, the
+     * account comes first so it can be invalidated on its own.
+     */
+    static QString cacheKey(const TransactionQuery &transactionQuery, const QLocale &locale)
+    {
+        QStringList types = {};
+        for (const auto type : transactionQuery.types) {
+            types << QString::number((int) type);
+        }
+
+        return QString("%1|%2|%3|%4|%5|%6|%7|%8|%9")
+            .arg(accountPrefix(transactionQuery.accountId),
+                 transactionQuery.fromDate.toString(Qt::ISODate),
+                 transactionQuery.toDate.toString(Qt::ISODate),
+                 QString("%1%2/%3")
+                     .arg(transactionQuery.excludeTypes ? "!" : "",
+                          types.join(','),
+                          transactionQuery.categories.join('\x1f')),
+                 QString("%1%2")
+                     .arg((int) transactionQuery.sortKey)
+                     .arg((int) transactionQuery.sortOrder),
+                 QString("%1+%2").arg(transactionQuery.offset).arg(transactionQuery.limit),
+                 QString("%1:%2:%3")
+                     .arg(transactionQuery.keyset)
+                     .arg(transactionQuery.keysetValue.toString())
+                     .arg(transactionQuery.keysetId),
+                 locale.name())
+            .arg(locale.currencySymbol(QLocale::CurrencyIsoCode));
+    }
+
+    static QString accountPrefix(const quint32 accountId) { return QString::number(accountId); }
+
+    void removeAccount(const quint32 accountId)
+    {
+        const QString prefix = accountPrefix(accountId) + '|';
+        const auto keys = m_pages.keys();
+        for (const auto &key : keys) {
+            if (key.startsWith(prefix)) {
+                m_pages.remove(key);
+            }
+        }
+    }
+
+    // QCache counts in int, the budget is tracked in KiB
+    static int costOf(const qint64 bytes)
+    {
+        return (int) qMin<qint64>((bytes + 1023) / 1024, INT_MAX);
+    }
+
+    QCache<QString, TransactionRowList> m_pages;
+    qint64 m_memoryBudget;
+    quint64 m_generation;
+    mutable QMutex m_mutex;
+};
+
+TransactionCache::TransactionCache(const qint64 memoryBudget)
+    : d_ptr(new Private(memoryBudget))
+{ }
+
+TransactionCache::~TransactionCache()
+{
+    d_ptr.reset();
+}
+
+bool TransactionCache::find(const TransactionQuery &transactionQuery,
+                            const QLocale &locale,
+                            TransactionRowList &rows) const
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+
+    // object() moves the page to the front of the LRU list
+    const auto page = d_ptr->m_pages.object(Private::cacheKey(transactionQuery, locale));
+    if (page == Q_NULLPTR) {
+        return false;
+    }
+
+    rows = *page;
+    return true;
+}
+
+void TransactionCache::insert(const TransactionQuery &transactionQuery,
+                              const QLocale &locale,
+                              const TransactionRowList &rows,
+                              const quint64 generation)
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    if (generation != d_ptr->m_generation) {
+        return;
+    }
+
+    const QString key = Private::cacheKey(transactionQuery, locale);
+    const int cost = qMax(1, Private::costOf(estimateMemoryUsage(rows)));
+    d_ptr->m_pages.insert(key, new TransactionRowList(rows), cost);
+}
+
+quint64 TransactionCache::generation() const
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    return d_ptr->m_generation;
+}
+
+void TransactionCache::invalidate(const quint32 accountId)
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    ++d_ptr->m_generation;
+
+    d_ptr->removeAccount(accountId);
+
+    // Pages over all accounts contain rows of this one as well
+    if (accountId != 0) {
+        d_ptr->removeAccount(0);
+    }
+}
+
+void TransactionCache::clear()
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    ++d_ptr->m_generation;
+    d_ptr->m_pages.clear();
+}
+
+void TransactionCache::setMemoryBudget(const qint64 memoryBudget)
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    d_ptr->m_memoryBudget = memoryBudget;
+    d_ptr->m_pages.setMaxCost(Private::costOf(memoryBudget));
+}
+
+qint64 TransactionCache::memoryBudget() const
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    return d_ptr->m_memoryBudget;
+}
+
+qint64 TransactionCache::memoryUsage() const
+{
+    QMutexLocker locker(&d_ptr->m_mutex);
+    return qint64(d_ptr->m_pages.totalCost()) * 1024;
+}
+
+qint64 TransactionCache::estimateMemoryUsage(const TransactionRowList &rows)
+{
+    qint64 bytes = sizeof(TransactionRowList) + rows.capacity() * sizeof(TransactionRow);
+    for (const auto &row : rows) {
+        bytes += (row.currency.capacity() + row.remoteName.capacity() + row.purpose.capacity()
+                  + row.category.capacity() + row.displayDate.capacity()
+                  + row.displayValue.capacity())
+                 * sizeof(QChar);
+        if (row.sortValue.type() == QVariant::String) {
+            bytes += row.sortValue.toString().capacity() * sizeof(QChar);
+        }
+    }
+    return bytes;
+}
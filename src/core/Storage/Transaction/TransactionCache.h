@@ -0,0 +1,76 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_TRANSACTIONCACHE_H
+#define OLBAFLINX_TRANSACTIONCACHE_H
+
+#include <QtCore/QLocale>
+#include <QtCore/QScopedPointer>
+
+#include "core/Constant.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
+#include "core/Storage/Transaction/TransactionRow.h"
+
+namespace olbaflinx::core::storage::transaction {
+
+/**
+ * Decoded transaction pages of the vault, keyed by account and query. All
+ * views asking for the same page share one copy of the rows (implicitly
+ * shared), the least recently used pages are evicted once the estimated
+ * memory exceeds the budget.
+ *
+ * The cache is thread safe, pages are inserted by the reader thread.
+ */
+class TransactionCache
+{
+public:
+    explicit TransactionCache(const qint64 memoryBudget = TransactionCacheMemoryBudget);
+    ~TransactionCache();
+
+    bool find(const TransactionQuery &transactionQuery,
+              const QLocale &locale,
+              TransactionRowList &rows) const;
+
+    /**
+     * `generation` is the value of `generation()` before the rows were read,
+     * pages read before an invalidation are dropped.
+     */
+    void insert(const TransactionQuery &transactionQuery,
+                const QLocale &locale,
+                const TransactionRowList &rows,
+                const quint64 generation);
+    [[nodiscard]] quint64 generation() const;
+
+    void invalidate(const quint32 accountId);
+    void clear();
+
+    void setMemoryBudget(const qint64 memoryBudget);
+    [[nodiscard]] qint64 memoryBudget() const;
+    [[nodiscard]] qint64 memoryUsage() const;
+
+    static qint64 estimateMemoryUsage(const TransactionRowList &rows);
+
+private:
+    class Private;
+    QScopedPointer<Private> d_ptr;
+
+    Q_DISABLE_COPY(TransactionCache)
+};
+
+} // namespace olbaflinx::core::storage::transaction
+
+#endif //OLBAFLINX_TRANSACTIONCACHE_H
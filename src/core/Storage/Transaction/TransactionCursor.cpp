@@ -0,0 +1,68 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#include "core/Storage/VaultStorage.h"
+
+#include "TransactionCursor.h"
+
+using namespace olbaflinx::core::storage;
+using namespace olbaflinx::core::storage::transaction;
+
+TransactionCursor::TransactionCursor(const TransactionQuery &transactionQuery, const int pageSize)
+    : m_query(transactionQuery)
+    , m_nextPage()
+    , m_atEnd(false)
+{
+    m_query.limit = pageSize;
+    m_query.offset = 0;
+    m_query.keyset = KeysetNone;
+    m_nextPage = VaultStorage::instance()->transactionPage(m_query);
+}
+
+TransactionCursor::~TransactionCursor()
+{
+    // The page read ahead is never handed out
+    if (!m_atEnd) {
+        qDeleteAll(m_nextPage.result().transactions);
+    }
+}
+
+TransactionList TransactionCursor::next()
+{
+    if (m_atEnd) {
+        return {};
+    }
+
+    const TransactionPage page = m_nextPage.result();
+    if (page.transactions.size() < m_query.limit) {
+        m_atEnd = true;
+        return page.transactions;
+    }
+
+    m_query.keyset = KeysetAfter;
+    m_query.keysetValue = page.lastSortValue;
+    m_query.keysetId = page.lastId;
+    m_nextPage = VaultStorage::instance()->transactionPage(m_query);
+
+    return page.transactions;
+}
+
+bool TransactionCursor::atEnd() const
+{
+    return m_atEnd;
+}
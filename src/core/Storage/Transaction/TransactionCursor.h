@@ -0,0 +1,60 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+
+#ifndef OLBAFLINX_TRANSACTIONCURSOR_H
+#define OLBAFLINX_TRANSACTIONCURSOR_H
+
+#include <QtCore/QFuture>
+
+#include "core/Constant.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
+
+namespace olbaflinx::core::storage::transaction {
+
+/**
+ * Walks all transactions matching a query with keyset paging. The next page
+ * is read on a reader thread of the vault while the caller works on the
+ * current one, so no more than two pages are in memory however large the
+ * vault is. Every page is a short read of its own, a long export doesn't
+ * keep a statement open on the vault.
+ */
+class TransactionCursor
+{
+public:
+    explicit TransactionCursor(const TransactionQuery &transactionQuery,
+                               const int pageSize = StatementExportPageSize);
+    ~TransactionCursor();
+
+    /**
+     * The next page in the sort order of the query, owned by the caller.
+     * Empty once all transactions were read.
+     */
+    TransactionList next();
+    [[nodiscard]] bool atEnd() const;
+
+private:
+    TransactionQuery m_query;
+    QFuture<TransactionPage> m_nextPage;
+    bool m_atEnd;
+
+    Q_DISABLE_COPY(TransactionCursor)
+};
+
+} // namespace olbaflinx::core::storage::transaction
+
+#endif //OLBAFLINX_TRANSACTIONCURSOR_H
@@ -0,0 +1,117 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_TRANSACTIONQUERY_H
+#define OLBAFLINX_TRANSACTIONQUERY_H
+
+#include <QtCore/QDate>
+#include <QtCore/QMetaType>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+
+#include "core/Container.h"
+#include "core/Storage/Transaction/Transaction.h"
+
+namespace olbaflinx::core::storage::transaction {
+
+enum TransactionSortKey {
+    SortByValutaDate = 0,
+    SortByDate,
+    SortByRemoteName,
+    SortByPurpose,
+    SortByCategory,
+    SortByValue,
+    SortById
+};
+
+enum TransactionKeyset { KeysetNone = 0, KeysetAfter, KeysetBefore };
+
+/**
+ * Filter, sort order and page of a transaction lookup. `VaultStorage` turns it
+ * into a single SQL statement, invalid dates and empty type or category lists
+ * don't restrict the result.
+ *
+ * A page is addressed either by `offset` or, cheaper for deep pages, by the
+ * sort value and id of the row right before (`KeysetAfter`) or right after
+ * (`KeysetBefore`) it.
+ */
+struct TransactionQuery
+{
+    quint32 accountId = 0;
+    QDate fromDate = {};
+    QDate toDate = {};
+    QVector<TransactionType> types = {};
+    bool excludeTypes = false;
+    QStringList categories = {};
+    TransactionSortKey sortKey = SortByValutaDate;
+    Qt::SortOrder sortOrder = Qt::DescendingOrder;
+    qint32 limit = 50;
+    qint32 offset = 0;
+    TransactionKeyset keyset = KeysetNone;
+    QVariant keysetValue = {};
+    qint64 keysetId = 0;
+
+    static TransactionQuery statements(const quint32 accountId)
+    {
+        TransactionQuery query;
+        query.accountId = accountId;
+        query.types = {AB_Transaction_TypeStandingOrder};
+        query.excludeTypes = true;
+        return query;
+    }
+
+    static TransactionQuery standingOrders(const quint32 accountId)
+    {
+        TransactionQuery query;
+        query.accountId = accountId;
+        query.types = {AB_Transaction_TypeStandingOrder};
+        return query;
+    }
+};
+
+/**
+ * Lower-cased search text (payee, purpose, category, date and value) per
+ * transaction id, in the order of the query. A chunk also has the sort value
+ * and id of its last row to continue with `KeysetAfter`.
+ */
+struct TransactionSearchIndex
+{
+    QVector<qint64> ids = {};
+    QStringList texts = {};
+    QVariant lastSortValue = {};
+    qint64 lastId = 0;
+};
+
+/**
+ * Complete transactions of one page, owned by the caller, and the sort value
+ * and id of its last row to continue with `KeysetAfter`.
+ */
+struct TransactionPage
+{
+    TransactionList transactions = {};
+    QVariant lastSortValue = {};
+    qint64 lastId = 0;
+};
+
+} // namespace olbaflinx::core::storage::transaction
+
+Q_DECLARE_METATYPE(olbaflinx::core::storage::transaction::TransactionQuery)
+Q_DECLARE_METATYPE(olbaflinx::core::storage::transaction::TransactionSearchIndex)
+Q_DECLARE_METATYPE(olbaflinx::core::storage::transaction::TransactionPage)
+
+#endif //OLBAFLINX_TRANSACTIONQUERY_H
@@ -0,0 +1,49 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "TransactionRow.h"
+
+using namespace olbaflinx::core::storage::transaction;
+
+TransactionRow TransactionRow::create(const QSqlQuery &query,
+                                      const QLocale &locale,
+                                      const bool hasSortValue)
+{
+    TransactionRow row;
+    row.id = query.value(0).toLongLong();
+    row.valutaDate = query.value(1).toDate();
+    row.remoteName = query.value(2).toString();
+    row.purpose = query.value(3).toString();
+    row.category = query.value(4).toString();
+    row.value = query.value(5).toDouble();
+    row.currency = query.value(6).toString();
+    if (hasSortValue) {
+        row.sortValue = query.value(7);
+    }
+
+    row.displayDate = locale.toString(row.valutaDate, QLocale::ShortFormat);
+
+    // The symbol of the locale is only correct for its own currency
+    const bool isLocaleCurrency = row.currency.isEmpty()
+                                  || row.currency == locale.currencySymbol(QLocale::CurrencyIsoCode);
+    row.displayValue = locale.toCurrencyString(row.value,
+                                               isLocaleCurrency
+                                                   ? locale.currencySymbol(QLocale::CurrencySymbol)
+                                                   : row.currency);
+
+    return row;
+}
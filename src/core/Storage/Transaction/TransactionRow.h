@@ -0,0 +1,68 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_TRANSACTIONROW_H
+#define OLBAFLINX_TRANSACTIONROW_H
+
+#include <QtCore/QDate>
+#include <QtCore/QLocale>
+#include <QtCore/QMetaType>
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+#include <QtCore/QVector>
+#include <QtSql/QSqlQuery>
+
+namespace olbaflinx::core::storage::transaction {
+
+/**
+ * The columns of a transaction shown in views, read straight from the vault
+ * and formatted once when the page is loaded.
+ */
+struct TransactionRow
+{
+    qint64 id = 0;
+    QDate valutaDate = {};
+    double value = 0.0;
+    QString currency = "";
+    QString remoteName = "";
+    QString purpose = "";
+    QString category = "";
+
+    QString displayDate = "";
+    QString displayValue = "";
+
+    // Value of the sort expression, the key for keyset paging
+    QVariant sortValue = {};
+
+    [[nodiscard]] bool isNegative() const { return value < 0; }
+
+    /**
+     * Expects the columns of `StorageSqlTransactionRowColumns`, optionally
+     * followed by the sort expression.
+     */
+    static TransactionRow create(const QSqlQuery &query,
+                                 const QLocale &locale = QLocale(),
+                                 const bool hasSortValue = false);
+};
+typedef QVector<TransactionRow> TransactionRowList;
+
+} // namespace olbaflinx::core::storage::transaction
+
+Q_DECLARE_METATYPE(olbaflinx::core::storage::transaction::TransactionRow)
+Q_DECLARE_METATYPE(olbaflinx::core::storage::transaction::TransactionRowList)
+
+#endif //OLBAFLINX_TRANSACTIONROW_H
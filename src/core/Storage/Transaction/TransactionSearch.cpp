@@ -0,0 +1,283 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QRegularExpression>
+
+#include "core/Storage/VaultStorage.h"
+
+#include "TransactionSearch.h"
+
+using namespace olbaflinx::core::storage::transaction;
+
+TransactionSearch::TransactionSearch(QObject *parent)
+    : QObject(parent)
+    , m_transactionQuery()
+    , m_search()
+    , m_generation(0)
+    , m_hasQuery(false)
+    , m_searchText("")
+    , m_isRegularExpression(false)
+    , m_lastSearchText("")
+    , m_lastMatches()
+    , m_lastSearchComplete(false)
+    , m_isSearching(false)
+{
+    qRegisterMetaType<QVector<qint64>>("QVector<qint64>");
+    qRegisterMetaType<TransactionSearchIndex>("TransactionSearchIndex");
+
+    connect(VaultStorage::instance(),
+            &VaultStorage::storageChanged,
+            this,
+            &TransactionSearch::storageChanged);
+}
+
+TransactionSearch::~TransactionSearch()
+{
+    m_generation.fetchAndAddOrdered(1);
+    waitForWorkers();
+}
+
+void TransactionSearch::setTransactionQuery(const TransactionQuery &transactionQuery)
+{
+    clear();
+
+    m_transactionQuery = transactionQuery;
+    m_hasQuery = true;
+}
+
+void TransactionSearch::clear()
+{
+    cancel();
+    waitForWorkers();
+
+    m_hasQuery = false;
+    m_searchText.clear();
+    m_lastMatches = TransactionSearchIndex();
+}
+
+bool TransactionSearch::isSearching() const
+{
+    return m_isSearching;
+}
+
+int TransactionSearch::generation() const
+{
+    return m_generation.loadAcquire();
+}
+
+void TransactionSearch::search(const QString &searchText, const bool isRegularExpression)
+{
+    const int generation = m_generation.fetchAndAddOrdered(1) + 1;
+
+    m_searchText = searchText;
+    m_isRegularExpression = isRegularExpression;
+
+    if (searchText.isEmpty()) {
+        m_lastSearchText.clear();
+        m_lastSearchComplete = false;
+        m_isSearching = false;
+        Q_EMIT searchCleared();
+        return;
+    }
+
+    if (!m_hasQuery) {
+        Q_EMIT searchStarted(searchText);
+        Q_EMIT searchFinished(0);
+        return;
+    }
+
+    const QString needle = searchText.toLower();
+    const bool isNarrowing = !isRegularExpression && m_lastSearchComplete
+                             && !m_lastSearchText.isEmpty() && needle.contains(m_lastSearchText);
+    const TransactionSearchIndex candidates = isNarrowing ? m_lastMatches
+                                                          : TransactionSearchIndex();
+
+    m_lastSearchText = isRegularExpression ? QString() : needle;
+    m_lastSearchComplete = false;
+    m_isSearching = true;
+
+    Q_EMIT searchStarted(searchText);
+
+    const TransactionQuery transactionQuery = m_transactionQuery;
+    m_search = QtConcurrent::run([this,
+                                  generation,
+                                  needle,
+                                  searchText,
+                                  isRegularExpression,
+                                  isNarrowing,
+                                  candidates,
+                                  transactionQuery]() -> void {
+        QRegularExpression expression = {};
+        if (isRegularExpression) {
+            expression = QRegularExpression(searchText, QRegularExpression::CaseInsensitiveOption);
+            if (!expression.isValid()) {
+                expression = QRegularExpression(QRegularExpression::escape(searchText),
+                                                QRegularExpression::CaseInsensitiveOption);
+            }
+            expression.optimize();
+        }
+
+        // The texts of the matches are kept for a narrowing search while
+        // there are only a few of them
+        TransactionSearchIndex matches = {};
+        bool isNarrowable = true;
+        int resultCount = 0;
+
+        QVector<qint64> batch = {};
+        batch.reserve(SearchResultBatchSize);
+
+        const auto scan = [&](const TransactionSearchIndex &haystack) -> bool {
+            for (int i = 0; i < haystack.ids.size(); ++i) {
+                if (i % SearchCancelCheckInterval == 0
+                    && m_generation.loadAcquire() != generation) {
+                    return false;
+                }
+
+                const QString &text = haystack.texts.at(i);
+                const bool matched = isRegularExpression ? expression.match(text).hasMatch()
+                                                         : text.contains(needle);
+                if (!matched) {
+                    continue;
+                }
+
+                ++resultCount;
+                if (isNarrowable && resultCount > SearchNarrowingLimit) {
+                    matches = TransactionSearchIndex();
+                    isNarrowable = false;
+                } else if (isNarrowable) {
+                    matches.ids << haystack.ids.at(i);
+                    matches.texts << text;
+                }
+
+                batch << haystack.ids.at(i);
+                if (batch.size() >= SearchResultBatchSize) {
+                    QMetaObject::invokeMethod(this,
+                                              "batchFound",
+                                              Qt::QueuedConnection,
+                                              Q_ARG(int, generation),
+                                              Q_ARG(QVector<qint64>, batch));
+                    batch.clear();
+                }
+            }
+            return true;
+        };
+
+        if (isNarrowing) {
+            if (!scan(candidates)) {
+                return;
+            }
+        } else {
+            // Chunks are read with keyset paging in the order of the query
+            TransactionQuery chunkQuery = transactionQuery;
+            chunkQuery.limit = SearchIndexChunkSize;
+            chunkQuery.offset = 0;
+            chunkQuery.keyset = KeysetNone;
+
+            forever {
+                const TransactionSearchIndex chunk
+                    = VaultStorage::instance()->transactionSearchIndex(chunkQuery).result();
+                if (m_generation.loadAcquire() != generation || !scan(chunk)) {
+                    return;
+                }
+
+                if (chunk.ids.size() < chunkQuery.limit) {
+                    break;
+                }
+
+                chunkQuery.keyset = KeysetAfter;
+                chunkQuery.keysetValue = chunk.lastSortValue;
+                chunkQuery.keysetId = chunk.lastId;
+            }
+        }
+
+        if (!batch.isEmpty()) {
+            QMetaObject::invokeMethod(this,
+                                      "batchFound",
+                                      Qt::QueuedConnection,
+                                      Q_ARG(int, generation),
+                                      Q_ARG(QVector<qint64>, batch));
+        }
+
+        QMetaObject::invokeMethod(this,
+                                  "searchCompleted",
+                                  Qt::QueuedConnection,
+                                  Q_ARG(int, generation),
+                                  Q_ARG(int, resultCount),
+                                  Q_ARG(bool, isNarrowable),
+                                  Q_ARG(TransactionSearchIndex, matches));
+    });
+}
+
+void TransactionSearch::cancel()
+{
+    m_generation.fetchAndAddOrdered(1);
+    m_lastSearchText.clear();
+    m_lastSearchComplete = false;
+    m_isSearching = false;
+}
+
+void TransactionSearch::batchFound(const int generation, const QVector<qint64> &ids)
+{
+    if (generation != m_generation.loadAcquire()) {
+        return;
+    }
+
+    Q_EMIT resultsAvailable(ids);
+}
+
+void TransactionSearch::searchCompleted(const int generation,
+                                        const int resultCount,
+                                        const bool isNarrowable,
+                                        const TransactionSearchIndex &matches)
+{
+    if (generation != m_generation.loadAcquire()) {
+        return;
+    }
+
+    m_lastMatches = matches;
+    m_lastSearchComplete = isNarrowable && !m_lastSearchText.isEmpty();
+    m_isSearching = false;
+
+    Q_EMIT searchFinished(resultCount);
+}
+
+void TransactionSearch::storageChanged(const StorageChange &change)
+{
+    if (change.subject != SubjectTransaction || !m_hasQuery) {
+        return;
+    }
+
+    if (m_transactionQuery.accountId != 0 && change.accountId != m_transactionQuery.accountId) {
+        return;
+    }
+
+    // The matches of the last search may miss the changed rows
+    m_lastMatches = TransactionSearchIndex();
+    m_lastSearchComplete = false;
+
+    if (!m_searchText.isEmpty()) {
+        search(m_searchText, m_isRegularExpression);
+    }
+}
+
+void TransactionSearch::waitForWorkers()
+{
+    // The chunks are read on the storage reader threads and hold no
+    // references, only a running scan has to be waited for.
+    m_search.waitForFinished();
+}
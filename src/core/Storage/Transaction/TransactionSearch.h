@@ -0,0 +1,98 @@
+/**
+* Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+*
+* This program is free software: you can redistribute it and/or modify
+* it under the terms of the GNU General Public License as published by
+* the Free Software Foundation, either version 3 of the License, or
+* (at your option) any later version.
+*
+* This program is distributed in the hope that it will be useful,
+* but WITHOUT ANY WARRANTY; without even the implied warranty of
+* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+* GNU General Public License for more details.
+*
+* You should have received a copy of the GNU General Public License
+* along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef OLBAFLINX_TRANSACTIONSEARCH_H
+#define OLBAFLINX_TRANSACTIONSEARCH_H
+
+#include <QtCore/QAtomicInt>
+#include <QtCore/QFuture>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QVector>
+
+#include "core/Container.h"
+#include "core/Storage/StorageChange.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
+
+namespace olbaflinx::core::storage::transaction {
+
+/**
+ * Searches the transactions matching a query on a worker thread.
+ *
+ * Every call of `search` supersedes the running one: the worker checks the
+ * search generation while scanning and stops as soon as it's outdated. Results
+ * are delivered in batches through `resultsAvailable`. The texts are read in
+ * chunks of `SearchIndexChunkSize` rows, so memory stays flat however many
+ * transactions the account has.
+ *
+ * If a new plain text search only narrows the last completed one (the new text
+ * contains the old text), only the previous matches are scanned again, as long
+ * as there were at most `SearchNarrowingLimit` of them. A change of the
+ * searched account runs the active search again.
+ */
+class TransactionSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit TransactionSearch(QObject *parent = Q_NULLPTR);
+    ~TransactionSearch() override;
+
+    void setTransactionQuery(const TransactionQuery &transactionQuery);
+    void clear();
+
+    [[nodiscard]] bool isSearching() const;
+    [[nodiscard]] int generation() const;
+
+Q_SIGNALS:
+    void searchStarted(const QString &searchText);
+    void resultsAvailable(const QVector<qint64> &ids);
+    void searchFinished(const int resultCount);
+    void searchCleared();
+
+public Q_SLOTS:
+    void search(const QString &searchText, const bool isRegularExpression = false);
+    void cancel();
+
+private Q_SLOTS:
+    void batchFound(const int generation, const QVector<qint64> &ids);
+    void searchCompleted(const int generation,
+                         const int resultCount,
+                         const bool isNarrowable,
+                         const TransactionSearchIndex &matches);
+    void storageChanged(const StorageChange &change);
+
+private:
+    TransactionQuery m_transactionQuery;
+    QFuture<void> m_search;
+    QAtomicInt m_generation;
+    bool m_hasQuery;
+
+    QString m_searchText;
+    bool m_isRegularExpression;
+
+    QString m_lastSearchText;
+    TransactionSearchIndex m_lastMatches;
+    bool m_lastSearchComplete;
+    bool m_isSearching;
+
+    void waitForWorkers();
+};
+
+} // namespace olbaflinx::core::storage::transaction
+
+#endif //OLBAFLINX_TRANSACTIONSEARCH_H
@@ -14,7 +14,11 @@
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
+#include <algorithm>
+
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QVariant>
+#include <QtGui/QColor>
 #include <QtGui/QFont>
 
 #include "core/Storage/VaultStorage.h"
@@ -26,17 +30,29 @@ using namespace olbaflinx::core::storage::transaction;
 
 TransactionViewModel::TransactionViewModel(QObject *parent, bool isStandingOrderModel)
     : QAbstractTableModel(parent)
-    , m_transactions({})
-    , m_accountId(0)
-    , m_transactionCount(0)
+    , m_transactionQuery()
+    , m_searchResults({})
+    , m_rowCount(0)
+    , m_generation(0)
     , m_isStandingOrderModel(isStandingOrderModel)
-{ }
+    , m_isShowingSearchResults(false)
+    , m_pages({})
+    , m_pageUsage({})
+    , m_pendingPages({})
+    , m_pageBoundaries({})
+    , m_lastPage(0)
+{
+    connect(VaultStorage::instance(),
+            &VaultStorage::storageChanged,
+            this,
+            &TransactionViewModel::applyStorageChange);
+}
 
 TransactionViewModel::~TransactionViewModel() = default;
 
 int TransactionViewModel::rowCount(const QModelIndex &parent) const
 {
-    return parent.isValid() ? 0 : m_transactionCount;
+    return parent.isValid() ? 0 : m_rowCount;
 }
 
 int TransactionViewModel::columnCount(const QModelIndex &parent) const
@@ -50,14 +66,18 @@ QVariant TransactionViewModel::data(const QModelIndex &index, int role) const
         return {};
     }
 
-    const auto transaction = m_transactions.at(index.row());
+    const auto transaction = transactionAt(index.row());
+    if (transaction == Q_NULLPTR) {
+        return {};
+    }
+
     if (role == Qt::ForegroundRole) {
+        static const QVariant negativeColor = QColor(Qt::red);
+        static const QVariant positiveColor = QColor(Qt::black);
+
         switch (index.column()) {
         case Columns::ColumnValue:
-            if (transaction->value() < 0) {
-                return QColor(Qt::red);
-            }
-            return QColor(Qt::black);
+            return transaction->isNegative() ? negativeColor : positiveColor;
         default:
             break;
         }
@@ -71,15 +91,15 @@ QVariant TransactionViewModel::data(const QModelIndex &index, int role) const
     } else if (role == Qt::DisplayRole) {
         switch (index.column()) {
         case Columns::ColumnValutaDate:
-            return transaction->valutaDate().toString("dd.MM.yyyy");
+            return transaction->displayDate;
         case Columns::ColumnRemoteName:
-            return transaction->remoteName();
+            return transaction->remoteName;
         case Columns::ColumnPurpose:
-            return transaction->purpose();
+            return transaction->purpose;
         case Columns::ColumnValue:
-            return QString::asprintf("%.2f", transaction->value());
+            return transaction->displayValue;
         case Columns::ColumnCategory:
-            return transaction->category();
+            return transaction->category;
         default:
             break;
         }
@@ -116,47 +136,342 @@ QVariant TransactionViewModel::headerData(int section, Qt::Orientation orientati
     return {};
 }
 
-bool TransactionViewModel::canFetchMore(const QModelIndex &parent) const
+const TransactionRow *TransactionViewModel::transactionRow(const QModelIndex &index) const
 {
-    if (parent.isValid()) {
-        return false;
+    return index.isValid() ? transactionAt(index.row()) : Q_NULLPTR;
+}
+
+void TransactionViewModel::sort(int column, Qt::SortOrder order)
+{
+    TransactionSortKey sortKey;
+    switch (column) {
+    case Columns::ColumnValutaDate:
+        sortKey = SortByValutaDate;
+        break;
+    case Columns::ColumnRemoteName:
+        sortKey = SortByRemoteName;
+        break;
+    case Columns::ColumnPurpose:
+        sortKey = SortByPurpose;
+        break;
+    case Columns::ColumnCategory:
+        sortKey = SortByCategory;
+        break;
+    case Columns::ColumnValue:
+        sortKey = SortByValue;
+        break;
+    default:
+        return;
+    }
+
+    if (m_transactionQuery.sortKey == sortKey && m_transactionQuery.sortOrder == order) {
+        return;
     }
 
-    return (m_transactionCount < m_transactions.size());
+    m_transactionQuery.sortKey = sortKey;
+    m_transactionQuery.sortOrder = order;
+
+    // Search results keep the order they were found in, the new order
+    // applies when the search is left.
+    if (m_isShowingSearchResults) {
+        return;
+    }
+
+    Q_EMIT layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+    resetPages();
+    Q_EMIT layoutChanged({}, QAbstractItemModel::VerticalSortHint);
 }
 
-void TransactionViewModel::fetchMore(const QModelIndex &parent)
+void TransactionViewModel::setTransactionQuery(const TransactionQuery &transactionQuery)
 {
-    if (parent.isValid()) {
+    beginResetModel();
+    resetPages();
+    m_transactionQuery = transactionQuery;
+    m_searchResults.clear();
+    m_isShowingSearchResults = false;
+    m_rowCount = qMax(0, VaultStorage::instance()->transactionCount(m_transactionQuery));
+    endResetModel();
+}
+
+TransactionQuery TransactionViewModel::transactionQuery() const
+{
+    return m_transactionQuery;
+}
+
+void TransactionViewModel::clear()
+{
+    beginResetModel();
+    resetPages();
+    m_transactionQuery = TransactionQuery();
+    m_searchResults.clear();
+    m_isShowingSearchResults = false;
+    m_rowCount = 0;
+    endResetModel();
+}
+
+void TransactionViewModel::beginSearchResults()
+{
+    beginResetModel();
+    resetPages();
+    m_searchResults.clear();
+    m_isShowingSearchResults = true;
+    m_rowCount = 0;
+    endResetModel();
+}
+
+void TransactionViewModel::appendSearchResults(const QVector<qint64> &ids)
+{
+    if (!m_isShowingSearchResults || ids.isEmpty()) {
         return;
     }
 
-    int remainder = m_transactions.size() - m_transactionCount;
-    int itemsToFetch = qMin(100, remainder);
+    // The last page was loaded with less rows than it will have now
+    const int lastPage = m_rowCount / TransactionPageSize;
+    if (m_pages.remove(lastPage) > 0) {
+        m_pageUsage.removeAll(lastPage);
+    }
 
-    beginInsertRows(QModelIndex(), m_transactionCount, m_transactionCount + itemsToFetch - 1);
-    m_transactionCount += itemsToFetch;
-    m_transactions << VaultStorage::instance()->transactions(m_accountId, 100, m_transactionCount);
+    beginInsertRows(QModelIndex(), m_rowCount, m_rowCount + ids.size() - 1);
+    m_searchResults << ids;
+    m_rowCount = m_searchResults.size();
     endInsertRows();
 }
 
-void TransactionViewModel::setTransactions(const quint32 accountId,
-                                           const TransactionList &transactions)
+void TransactionViewModel::endSearchResults()
 {
-    m_accountId = accountId;
-    beginInsertRows(QModelIndex(), 0, transactions.size());
-    m_transactionCount = 0;
-    m_transactions = transactions;
-    endInsertRows();
+    if (!m_isShowingSearchResults) {
+        return;
+    }
+
+    setTransactionQuery(m_transactionQuery);
 }
 
-void TransactionViewModel::clear()
+bool TransactionViewModel::isShowingSearchResults() const
 {
-    if (!m_transactions.isEmpty()) {
-        beginRemoveRows(QModelIndex(), 0, m_transactions.size());
-        qDeleteAll(m_transactions);
-        m_transactions.clear();
-        m_transactionCount = 0;
-        endRemoveRows();
+    return m_isShowingSearchResults;
+}
+
+void TransactionViewModel::applyStorageChange(const StorageChange &change)
+{
+    if (change.subject != SubjectTransaction) {
+        return;
+    }
+
+    if (m_transactionQuery.accountId == 0 || change.accountId != m_transactionQuery.accountId) {
+        return;
+    }
+
+    // TransactionSearch runs the search again for new rows, changed ones
+    // are repainted until its results arrive
+    if (m_isShowingSearchResults) {
+        if (m_rowCount > 0 && (!change.updated.isEmpty() || !change.deleted.isEmpty())) {
+            resetPages();
+            Q_EMIT dataChanged(index(0, 0), index(m_rowCount - 1, ColumnCount - 1));
+        }
+        return;
+    }
+
+    if (!change.deleted.isEmpty()) {
+        setTransactionQuery(m_transactionQuery);
+        return;
     }
+
+    if (!change.inserted.isEmpty()) {
+        const auto positions = VaultStorage::instance()->transactionPositions(m_transactionQuery,
+                                                                              change.inserted);
+
+        // Positions are in the final order, so inserting them ascending
+        // keeps every earlier row where it is. Consecutive rows go at once.
+        if (!positions.isEmpty()) {
+            resetPages();
+        }
+
+        int first = 0;
+        while (first < positions.size()) {
+            int last = first;
+            while (last + 1 < positions.size()
+                   && positions.at(last + 1) == positions.at(last) + 1) {
+                ++last;
+            }
+
+            beginInsertRows(QModelIndex(), positions.at(first), positions.at(last));
+            m_rowCount += last - first + 1;
+            endInsertRows();
+
+            first = last + 1;
+        }
+    }
+
+    if (!change.updated.isEmpty()) {
+        if (m_transactionQuery.sortKey == SortByCategory) {
+            // Categories were changed, rows may move
+            Q_EMIT layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+            resetPages();
+            Q_EMIT layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+            return;
+        }
+
+        const QSet<qint64> updated(change.updated.constBegin(), change.updated.constEnd());
+        const auto pages = m_pages.keys();
+        for (const auto page : pages) {
+            const auto &rows = m_pages[page];
+            const bool isAffected = std::any_of(rows.constBegin(),
+                                                rows.constEnd(),
+                                                [&updated](const TransactionRow &row) {
+                                                    return updated.contains(row.id);
+                                                });
+            if (!isAffected) {
+                continue;
+            }
+
+            m_pages.remove(page);
+            m_pageUsage.removeAll(page);
+            m_pageBoundaries.remove(page);
+
+            const int firstRow = page * TransactionPageSize;
+            Q_EMIT dataChanged(index(firstRow, 0),
+                               index(firstRow + expectedPageSize(page) - 1, ColumnCount - 1));
+        }
+    }
+}
+
+const TransactionRow *TransactionViewModel::transactionAt(const int row) const
+{
+    if (row < 0 || row >= m_rowCount) {
+        return Q_NULLPTR;
+    }
+
+    const int page = row / TransactionPageSize;
+
+    if (page != m_lastPage) {
+        const int direction = page > m_lastPage ? 1 : -1;
+        for (int ahead = 1; ahead <= TransactionPrefetchPages; ++ahead) {
+            requestPage(page + direction * ahead);
+        }
+        m_lastPage = page;
+    }
+
+    const auto cached = m_pages.constFind(page);
+    if (cached == m_pages.constEnd()) {
+        requestPage(page);
+        return Q_NULLPTR;
+    }
+
+    if (m_pageUsage.first() != page) {
+        m_pageUsage.removeOne(page);
+        m_pageUsage.prepend(page);
+    }
+
+    const int offset = row - page * TransactionPageSize;
+    return offset < cached->size() ? &cached->at(offset) : Q_NULLPTR;
+}
+
+int TransactionViewModel::pageCount() const
+{
+    return (m_rowCount + TransactionPageSize - 1) / TransactionPageSize;
+}
+
+int TransactionViewModel::expectedPageSize(const int page) const
+{
+    return qMin(TransactionPageSize, m_rowCount - page * TransactionPageSize);
+}
+
+void TransactionViewModel::requestPage(const int page) const
+{
+    if (page < 0 || page >= pageCount()) {
+        return;
+    }
+
+    if (m_pages.contains(page) || m_pendingPages.contains(page)) {
+        return;
+    }
+
+    QFuture<TransactionRowList> future;
+    if (m_isShowingSearchResults) {
+        future = VaultStorage::instance()->transactionRowsById(
+            m_searchResults.mid(page * TransactionPageSize, TransactionPageSize));
+    } else {
+        TransactionQuery transactionQuery = m_transactionQuery;
+        transactionQuery.limit = expectedPageSize(page);
+        transactionQuery.offset = page * TransactionPageSize;
+
+        const auto previous = m_pageBoundaries.constFind(page - 1);
+        const auto next = m_pageBoundaries.constFind(page + 1);
+        if (previous != m_pageBoundaries.constEnd()) {
+            transactionQuery.keyset = KeysetAfter;
+            transactionQuery.keysetValue = previous->lastValue;
+            transactionQuery.keysetId = previous->lastId;
+        } else if (next != m_pageBoundaries.constEnd()) {
+            transactionQuery.keyset = KeysetBefore;
+            transactionQuery.keysetValue = next->firstValue;
+            transactionQuery.keysetId = next->firstId;
+        }
+
+        future = VaultStorage::instance()->transactionRows(transactionQuery);
+    }
+
+    m_pendingPages.insert(page);
+
+    const auto model = const_cast<TransactionViewModel *>(this);
+    const int generation = m_generation;
+    const int requested = expectedPageSize(page);
+    auto watcher = new QFutureWatcher<TransactionRowList>(model);
+    connect(watcher, &QFutureWatcher<TransactionRowList>::finished, model, [=]() {
+        model->pageLoaded(generation, page, requested, watcher->result());
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+}
+
+void TransactionViewModel::pageLoaded(const int generation,
+                                      const int page,
+                                      const int requested,
+                                      const TransactionRowList &rows)
+{
+    if (generation != m_generation) {
+        return;
+    }
+
+    m_pendingPages.remove(page);
+
+    // Rows were appended while loading, the page is requested again on demand
+    if (requested < expectedPageSize(page)) {
+        const int first = page * TransactionPageSize;
+        Q_EMIT dataChanged(index(first, 0),
+                           index(first + expectedPageSize(page) - 1, ColumnCount - 1));
+        return;
+    }
+
+    m_pages.insert(page, rows);
+    m_pageUsage.prepend(page);
+
+    if (!m_isShowingSearchResults && !rows.isEmpty()) {
+        PageBoundary boundary;
+        boundary.firstValue = rows.first().sortValue;
+        boundary.firstId = rows.first().id;
+        boundary.lastValue = rows.last().sortValue;
+        boundary.lastId = rows.last().id;
+        m_pageBoundaries.insert(page, boundary);
+    }
+
+    // Boundaries go with their pages, the map never outgrows the cache
+    while (m_pages.size() > TransactionPageCacheSize) {
+        const int evicted = m_pageUsage.takeLast();
+        m_pages.remove(evicted);
+        m_pageBoundaries.remove(evicted);
+    }
+
+    const int first = page * TransactionPageSize;
+    Q_EMIT dataChanged(index(first, 0), index(first + requested - 1, ColumnCount - 1));
+}
+
+void TransactionViewModel::resetPages()
+{
+    ++m_generation;
+
+    m_pages.clear();
+    m_pageUsage.clear();
+    m_pendingPages.clear();
+    m_pageBoundaries.clear();
+    m_lastPage = 0;
 }
@@ -19,11 +19,37 @@
 #define OLBAFLINX_TRANSACTIONVIEWMODEL_H
 
 #include <QtCore/QAbstractTableModel>
+#include <QtCore/QHash>
+#include <QtCore/QList>
+#include <QtCore/QSet>
 
 #include "core/Container.h"
+#include "core/Storage/StorageChange.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
+#include "core/Storage/Transaction/TransactionRow.h"
 
 namespace olbaflinx::core::storage::transaction {
 
+/**
+ * Virtual table of the transactions matching a query.
+ *
+ * The row count comes from a count query, the rows themselves are loaded in
+ * pages of `TransactionPageSize` on the reader thread when the view asks for
+ * them. Only the `TransactionPageCacheSize` least recently used pages are kept
+ * and the pages in scroll direction are prefetched, so memory stays constant
+ * regardless of the number of transactions.
+ *
+ * Dates and values of a page are formatted on the reader thread while the
+ * page is loaded, `data()` only looks them up.
+ *
+ * Sorting is done by the database. The first and last key of every loaded
+ * page are remembered, so neighbouring pages are addressed by keyset instead
+ * of an offset which SQLite would have to skip row by row.
+ *
+ * Changes published by `VaultStorage` are applied in place: inserted rows are
+ * inserted at their sort position, updated rows repaint their pages and only
+ * deletions reset the model.
+ */
 class TransactionViewModel : public QAbstractTableModel
 {
     Q_OBJECT
@@ -45,19 +71,60 @@ public:
     int columnCount(const QModelIndex &parent) const override;
     QVariant data(const QModelIndex &index, int role) const override;
     QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+    void sort(int column, Qt::SortOrder order) override;
 
-    void setTransactions(const quint32 accountId, const TransactionList &transactions);
+    /**
+     * The cached row for `index` or `Q_NULLPTR` while its page is loading.
+     */
+    [[nodiscard]] const TransactionRow *transactionRow(const QModelIndex &index) const;
+
+    void setTransactionQuery(const TransactionQuery &transactionQuery);
+    [[nodiscard]] TransactionQuery transactionQuery() const;
     void clear();
 
-protected:
-    bool canFetchMore(const QModelIndex &parent) const override;
-    void fetchMore(const QModelIndex &parent) override;
+    /**
+     * While a search is active only its results are shown. The ids are added
+     * in batches as the search delivers them, the rows are paged the same way.
+     */
+    void beginSearchResults();
+    void appendSearchResults(const QVector<qint64> &ids);
+    void endSearchResults();
+    [[nodiscard]] bool isShowingSearchResults() const;
+
+public Q_SLOTS:
+    void applyStorageChange(const StorageChange &change);
 
 private:
-    TransactionList m_transactions;
-    quint32 m_accountId;
-    int m_transactionCount;
+    struct PageBoundary
+    {
+        QVariant firstValue = {};
+        qint64 firstId = 0;
+        QVariant lastValue = {};
+        qint64 lastId = 0;
+    };
+
+    TransactionQuery m_transactionQuery;
+    QVector<qint64> m_searchResults;
+    int m_rowCount;
+    int m_generation;
     bool m_isStandingOrderModel;
+    bool m_isShowingSearchResults;
+
+    mutable QHash<int, TransactionRowList> m_pages;
+    mutable QList<int> m_pageUsage;
+    mutable QSet<int> m_pendingPages;
+    mutable QHash<int, PageBoundary> m_pageBoundaries;
+    mutable int m_lastPage;
+
+    [[nodiscard]] const TransactionRow *transactionAt(const int row) const;
+    [[nodiscard]] int pageCount() const;
+    [[nodiscard]] int expectedPageSize(const int page) const;
+    void requestPage(const int page) const;
+    void pageLoaded(const int generation,
+                    const int page,
+                    const int requested,
+                    const TransactionRowList &rows);
+    void resetPages();
 };
 
 } // namespace olbaflinx::core::storage::transaction
@@ -15,23 +15,42 @@
 * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <atomic>
+
 #include <QtConcurrent/QtConcurrent>
 #include <QtCore/QCryptographicHash>
 #include <QtCore/QFile>
 #include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QSemaphore>
+#include <QtCore/QSet>
 #include <QtCore/QSettings>
+#include <QtCore/QSharedPointer>
 #include <QtCore/QTextStream>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
 #include <QtSql/QSqlError>
 #include <QtSql/QSqlField>
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlRecord>
 
+#include "core/BankData/IbanValidator.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
 #include "core/SingleApplication/SingleApplication.h"
+#include "core/Storage/Category/CategoryMatcher.h"
 #include "core/Storage/Connection/StorageConnection.h"
+#include "core/Storage/Connection/StorageExecutor.h"
+#include "core/Storage/Transaction/TransactionCache.h"
 #include "VaultStorage.h"
 
 using namespace olbaflinx::core;
+using namespace olbaflinx::core::bankdata;
+using namespace olbaflinx::core::progress;
 using namespace olbaflinx::core::storage;
+using namespace olbaflinx::core::storage::category;
 using namespace olbaflinx::core::storage::connection;
 
 class VaultStorage::Private
@@ -39,90 +58,239 @@ class VaultStorage::Private
 public:
     explicit Private()
         : m_settings(Q_NULLPTR)
-        , m_connection(Q_NULLPTR)
+        , m_readerConnections({})
+        , m_categoryMatcher()
+        , m_categoryMatcherGeneration(0)
+        , m_transactionCache()
+        , m_generations({})
         , m_filePath("")
         , m_key("")
-    { }
+        , m_isValid(false)
+    {
+        // Long living reader threads, so their connections can be reused
+        m_readerPool.setMaxThreadCount(StorageReaderCount);
+        m_readerPool.setExpiryTimeout(-1);
+
+        // The writer never checkpoints on commit, it's done when it is idle
+        m_executor.setMaintenance([this]() { checkpoint("PASSIVE"); }, StorageCheckpointInterval);
+    }
 
     ~Private()
     {
         m_settings->sync();
         delete m_settings;
 
-        m_connection->close();
-        delete m_connection;
+        closeReader();
+        m_readerPool.waitForDone();
+
+        m_executor.close();
     }
 
-    void initialize(const bool initializeSchema = false)
+    void initialize(const bool initializeSchema, const CancellationToken &token)
     {
-        if (m_connection != Q_NULLPTR) {
-            const auto currentDatabaseName = m_connection->database().databaseName();
+        const auto currentDatabaseName = m_executor.fileName();
+        if (!currentDatabaseName.isEmpty()) {
             if (currentDatabaseName.toLower() != m_filePath.toLower()) {
-                if (m_connection->isOpen()) {
-                    m_connection->close();
-                }
-                delete m_connection;
-                m_connection = Q_NULLPTR;
+                m_executor.close();
+                invalidateCategoryMatcher();
+                closeReader();
+                m_transactionCache.clear();
+                m_generations.clear();
             } else {
                 if (initializeSchema) {
-                    setupTables();
+                    setupTables(token);
                 }
                 return;
             }
         }
 
-        m_connection = new StorageConnection(m_filePath);
-        if (!m_connection->isOpen()) {
+        m_isValid = false;
+        if (!m_executor.open(m_filePath)) {
             return;
         }
 
+        // Readers keep their snapshot while the writer appends to the WAL
+        m_executor.execute(StorageExecutor::Interactive, [this]() {
+            QSqlQuery query = databaseQuery();
+            query.exec("PRAGMA journal_mode = WAL;");
+            query.exec("PRAGMA synchronous = NORMAL;");
+            query.exec("PRAGMA wal_autocheckpoint = 0;");
+        });
+
+        const auto budget = settings()->value(TransactionCacheSettingKey,
+                                              TransactionCacheMemoryBudget);
+        m_transactionCache.setMemoryBudget(budget.toLongLong());
+
         if (initializeSchema) {
-            setupTables();
+            setupTables(token);
         }
     }
 
     bool isStorageValid()
     {
-        if (!m_connection->isOpen()) {
+        if (!m_executor.isOpen()) {
             return false;
         }
 
-        if (m_key.isEmpty()) {
+        if (key().isEmpty()) {
             return false;
         }
 
-        QSqlQuery dbQuery = databaseQuery();
-        bool counted = dbQuery.exec("SELECT COUNT(id) AS ID_COUNT FROM migrations;");
-        if (!counted) {
-            return false;
+        // Checked once per key, so readers don't wait for the writer
+        if (m_isValid) {
+            return true;
         }
 
-        while (counted && dbQuery.next()) {
-            const int count = dbQuery.value("ID_COUNT").toInt();
-            counted &= (count >= 0);
+        m_isValid = m_executor.execute(StorageExecutor::Interactive, [this]() -> bool {
+            QSqlQuery dbQuery = databaseQuery();
+            bool counted = dbQuery.exec("SELECT COUNT(id) AS ID_COUNT FROM migrations;");
+            if (!counted) {
+                return false;
+            }
+
+            while (counted && dbQuery.next()) {
+                const int count = dbQuery.value("ID_COUNT").toInt();
+                counted &= (count >= 0);
+            }
+
+            return counted;
+        });
+
+        return m_isValid;
+    }
+
+    void close(const CancellationToken &token)
+    {
+        // Without readers the WAL can be written back and truncated completely
+        closeReader();
+
+        if (m_executor.isOpen()) {
+            m_executor.execute(StorageExecutor::Background, [this, token]() {
+                compact(token);
+                checkpoint("TRUNCATE");
+            });
         }
+        m_executor.close();
+        m_isValid = false;
 
-        return counted;
+        invalidateCategoryMatcher();
+        m_transactionCache.clear();
+        m_generations.clear();
     }
 
-    void close()
+    /**
+     * Vaults use incremental auto vacuum, the free pages are released in small
+     * steps and a cancellation stops between them. Vaults created before are
+     * converted once by a full VACUUM.
+     */
+    void compact(const CancellationToken &token)
     {
-        if (m_connection) {
-            if (m_connection->isOpen()) {
-                QSqlQuery query = databaseQuery();
+        QSqlQuery query = databaseQuery();
+        query.exec("PRAGMA auto_vacuum;");
+        const bool isIncremental = query.first() && query.value(0).toInt() == 2;
+        if (!isIncremental) {
+            if (!token.isCancelled()) {
+                query.exec("PRAGMA auto_vacuum = INCREMENTAL;");
                 query.exec("VACUUM;");
-                m_connection->close();
             }
+            return;
+        }
+
+        while (!token.isCancelled()) {
+            query.exec("PRAGMA freelist_count;");
+            if (!query.first() || query.value(0).toInt() == 0) {
+                break;
+            }
+
+            // Every step of the statement releases one page
+            query.exec(QString("PRAGMA incremental_vacuum(%1);").arg(StorageVacuumPageStep));
+            while (query.next()) { }
+        }
+    }
+
+    /**
+     * PASSIVE never waits for readers or the writer and copies what it can,
+     * TRUNCATE on close needs all readers to be closed.
+     */
+    void checkpoint(const QString &mode)
+    {
+        if (databaseConnection() == Q_NULLPTR || !databaseConnection()->isOpen()) {
+            return;
+        }
+
+        QSqlQuery query = databaseQuery();
+        query.exec(QString("PRAGMA wal_checkpoint(%1);").arg(mode));
+    }
+
+    QThreadPool *readerPool() { return &m_readerPool; }
+
+    /**
+     * Must only be called on a reader thread, the connection belongs to it.
+     * Readers never write and see the last commit of the writer when their
+     * statement or transaction starts.
+     */
+    StorageConnection *readerConnection()
+    {
+        QMutexLocker locker(&m_readerMutex);
+
+        auto connection = m_readerConnections.value(QThread::currentThread(), Q_NULLPTR);
+        if (connection == Q_NULLPTR) {
+            connection = new StorageConnection(m_filePath);
+            m_readerConnections.insert(QThread::currentThread(), connection);
 
-            delete m_connection;
-            m_connection = Q_NULLPTR;
+            QSqlQuery dbQuery(connection->database());
+            dbQuery.exec(QString("PRAGMA key='%1';").arg(escapeKey(key())));
+            dbQuery.exec("PRAGMA query_only = ON;");
         }
+
+        return connection;
     }
 
+    QSqlQuery readerQuery()
+    {
+        QSqlQuery dbQuery(readerConnection()->database());
+        dbQuery.exec(QString("PRAGMA key='%1';").arg(escapeKey(key())));
+        return dbQuery;
+    }
+
+    /**
+     * Every reader thread closes its own connection. The jobs wait for each
+     * other, so each of them runs on another thread of the pool.
+     */
+    void closeReader()
+    {
+        const int count = m_readerPool.maxThreadCount();
+        QSemaphore running;
+
+        QVector<QFuture<void>> futures = {};
+        for (int i = 0; i < count; ++i) {
+            futures << QtConcurrent::run(&m_readerPool, [this, &running, count]() {
+                running.release();
+                running.acquire(count);
+                running.release(count);
+
+                QMutexLocker locker(&m_readerMutex);
+                const auto connection = m_readerConnections.take(QThread::currentThread());
+                if (connection != Q_NULLPTR) {
+                    connection->close();
+                    delete connection;
+                }
+            });
+        }
+
+        for (auto &future : futures) {
+            future.waitForFinished();
+        }
+    }
+
+    /**
+     * Must only be called inside a job of the executor, the write connection
+     * belongs to its thread.
+     */
     QSqlQuery databaseQuery()
     {
-        QSqlQuery dbQuery(m_connection->database());
-        dbQuery.exec(QString("PRAGMA key='%1';").arg(escapeKey(m_key)));
+        QSqlQuery dbQuery(databaseConnection()->database());
+        dbQuery.exec(QString("PRAGMA key='%1';").arg(escapeKey(key())));
         return dbQuery;
     }
 
@@ -162,9 +330,439 @@ public:
     }
 
     void setFilePath(const QString &path) { m_filePath = path; }
-    void setKey(const QString &key) { m_key = key; }
+    void setKey(const QString &key)
+    {
+        QMutexLocker locker(&m_keyMutex);
+        m_key = key;
+        m_isValid = false;
+    }
+
+    QString key() const
+    {
+        QMutexLocker locker(&m_keyMutex);
+        return m_key;
+    }
+
+    StorageConnection *databaseConnection() { return m_executor.connection(); }
+    StorageExecutor *executor() { return &m_executor; }
+    TransactionCache *transactionCache() { return &m_transactionCache; }
+
+    quint64 generation(const quint32 accountId) const { return m_generations.value(accountId); }
+    quint64 nextGeneration(const quint32 accountId) { return ++m_generations[accountId]; }
+
+    /**
+     * Queues one executor job per batch and a last one which checks the remote
+     * accounts, its future has the number of new transactions or -1 if not all
+     * batches were stored. The reporter is optional and has to live until the
+     * future is finished.
+     */
+    QFuture<int> queueTransactions(const quint32 &accountId,
+                                    const TransactionList &transactions,
+                                    const CancellationToken &token,
+                                    const QSharedPointer<StorageChange> &change,
+                                    ProgressReporter *reporter = Q_NULLPTR,
+                                    const int insertTask = -1,
+                                    const int enrichTask = -1)
+    {
+        const auto matcher = categoryMatcher();
+
+        // Every batch is a job of its own and committed on its own. Interactive
+        // work runs in between, a cancellation only drops the current batch.
+        const int size = transactions.size();
+        for (int batchStart = 0; batchStart < size; batchStart += StorageImportBatchSize) {
+            const int batchEnd = qMin(size, batchStart + StorageImportBatchSize);
+            m_executor.run(StorageExecutor::Background, [=]() {
+                if (token.isCancelled()) {
+                    return;
+                }
+
+                const auto connection = databaseConnection();
+                const int insertedBefore = change->inserted.size();
+
+                QSqlQuery query = databaseQuery();
+                connection->begindTransaction();
+                for (int index = batchStart; index < batchEnd; ++index) {
+                    if (token.isCancelled()) {
+                        connection->rollbackTransaction();
+                        change->inserted.resize(insertedBefore);
+                        return;
+                    }
+
+                    const auto transaction = transactions.at(index);
+                    const QString hash = transaction->calculateTransactionHash();
+
+                    query.prepare(StorageSqlTransactionExists);
+                    query.bindValue(":account_id", accountId);
+                    query.bindValue(":hash", hash);
+                    query.exec();
+                    query.first();
+
+                    const int count = query.record().value("CNT").toInt();
+                    if (count == 0) {
+                        const CategoryRule *rule = Q_NULLPTR;
+                        if (transaction->category().isEmpty()) {
+                            rule = matcher->match(transaction->remoteName(),
+                                                  transaction->purpose(),
+                                                  transaction->remoteIban(),
+                                                  transaction->value());
+                        }
+
+                        QSqlQuery insertQuery = transaction->createInsertQuery(accountId, query);
+                        if (rule != Q_NULLPTR) {
+                            insertQuery.bindValue(":category", rule->category);
+                        }
+
+                        if (insertQuery.exec()) {
+                            const auto transactionId = insertQuery.lastInsertId();
+                            change->inserted << transactionId.toLongLong();
+
+                            if (rule != Q_NULLPTR) {
+                                query.prepare(StorageSqlTransactionCategoryRuleInsertQuery);
+                                query.bindValue(":transaction_id", transactionId);
+                                query.bindValue(":rule_id", rule->id);
+                                query.exec();
+                            }
+                        }
+                    }
+
+                    if (reporter != Q_NULLPTR) {
+                        reporter->advance(insertTask);
+                    }
+                }
+                connection->commitTransaction();
+            });
+        }
+
+        return m_executor.run(StorageExecutor::Background, [=]() -> int {
+            if (token.isCancelled()) {
+                return -1;
+            }
+
+            enrichRemoteAccounts(accountId, transactions);
+            if (reporter != Q_NULLPTR) {
+                reporter->finishTask(enrichTask);
+            }
+            return change->inserted.size();
+        });
+    }
+
+    static AccountCoverage readCoverage(QSqlQuery &query, const quint32 &accountId)
+    {
+        query.prepare(StorageSqlAccountCoverageSelectQuery);
+        query.bindValue(":account_id", accountId);
+        query.exec();
+
+        DateIntervals intervals = {};
+        while (query.next()) {
+            intervals.append({query.value(0).toDate(), query.value(1).toDate()});
+        }
+        return AccountCoverage(intervals);
+    }
+
+    /**
+     * Validates the remote IBANs of the given transactions which are not yet
+     * known in the vault and stores bank name / BIC for them. Missing remote
+     * BICs and bank codes of the transactions are filled in from the known
+     * and the newly validated IBANs.
+     */
+    void enrichRemoteAccounts(const quint32 &accountId, const TransactionList &transactions)
+    {
+        QSet<QString> ibanSet = {};
+        for (const auto transaction : transactions) {
+            const QString iban = IbanValidator::normalize(transaction->remoteIban());
+            if (!iban.isEmpty()) {
+                ibanSet.insert(iban);
+            }
+        }
+
+        if (ibanSet.isEmpty()) {
+            return;
+        }
+
+        // Known IBANs aren't validated again, their stored bank is used
+        IbanCheckResults results = {};
+        QSqlQuery query = databaseQuery();
+        const QStringList ibans = ibanSet.values();
+        const int chunkSize = 500;
+        for (int offset = 0; offset < ibans.size(); offset += chunkSize) {
+            const QStringList chunk = ibans.mid(offset, chunkSize);
+            QStringList placeholders = {};
+            for (int i = 0; i < chunk.size(); ++i) {
+                placeholders << "?";
+            }
+
+            query.prepare(QString(StorageSqlRemoteAccountKnownQuery).arg(placeholders.join(',')));
+            for (const auto &iban : chunk) {
+                query.addBindValue(iban);
+            }
+            query.exec();
+            while (query.next()) {
+                IbanCheckResult known;
+                known.iban = query.value(0).toString();
+                known.bic = query.value(1).toString();
+                known.bankCode = query.value(2).toString();
+                known.isBankKnown = query.value(3).toBool();
+                results.insert(known.iban, known);
+                ibanSet.remove(known.iban);
+            }
+        }
+
+        const auto validated = ibanSet.isEmpty()
+                                   ? IbanCheckResults()
+                                   : IbanValidator::instance()->validate(ibanSet.values());
+
+        databaseConnection()->begindTransaction();
+        for (const auto &result : validated) {
+            query.prepare(StorageSqlRemoteAccountInsertQuery);
+            query.bindValue(":iban", result.iban);
+            query.bindValue(":bic", result.bic);
+            query.bindValue(":bank_code", result.bankCode);
+            query.bindValue(":account_number", result.accountNumber);
+            query.bindValue(":bank_name", result.bankName);
+            query.bindValue(":iban_valid", result.isIbanValid);
+            query.bindValue(":account_valid",
+                            result.isAccountChecked ? QVariant(result.isAccountValid)
+                                                    : QVariant());
+            query.bindValue(":bank_known", result.isBankKnown);
+            query.exec();
+
+            results.insert(result.iban, result);
+        }
+
+        for (const auto &result : qAsConst(results)) {
+            if (!result.isBankKnown) {
+                continue;
+            }
+
+            query.prepare(StorageSqlRemoteAccountEnrichTransactionsQuery);
+            query.bindValue(":bic", result.bic);
+            query.bindValue(":bank_code", result.bankCode);
+            query.bindValue(":account_id", accountId);
+            query.bindValue(":iban", result.iban);
+            query.exec();
+        }
+        databaseConnection()->commitTransaction();
+    }
+
+    /**
+     * Builds and binds the statement for a transaction query. Sort order and
+     * limit are optional (e.g. left out for counting), `enclosing` wraps the
+     * statement as `%1` into an outer one.
+     */
+    static void prepareTransactionQuery(QSqlQuery &query,
+                                        const TransactionQuery &transactionQuery,
+                                        const QString &columns,
+                                        const bool ordered,
+                                        const bool paged,
+                                        const QString &enclosing = QString())
+    {
+        QStringList predicates = {"1 = 1"};
+        if (transactionQuery.accountId > 0) {
+            predicates << "account_id = :account_id";
+        }
+        if (transactionQuery.fromDate.isValid()) {
+            predicates << "valuta_date >= :from_date";
+        }
+        if (transactionQuery.toDate.isValid()) {
+            predicates << "valuta_date <= :to_date";
+        }
+
+        QStringList typePlaceholders = {};
+        for (int i = 0; i < transactionQuery.types.size(); ++i) {
+            typePlaceholders << QString(":type_%1").arg(i);
+        }
+        if (!typePlaceholders.isEmpty()) {
+            predicates << QString("`type` %1 (%2)")
+                              .arg(transactionQuery.excludeTypes ? "NOT IN" : "IN",
+                                   typePlaceholders.join(", "));
+        }
+
+        QStringList categoryPlaceholders = {};
+        for (int i = 0; i < transactionQuery.categories.size(); ++i) {
+            categoryPlaceholders << QString(":category_%1").arg(i);
+        }
+        if (!categoryPlaceholders.isEmpty()) {
+            predicates << QString("`category` IN (%1)").arg(categoryPlaceholders.join(", "));
+        }
+
+        // Walking backwards from a known row reverses the sort order, the
+        // caller restores it.
+        const bool isKeyset = paged && transactionQuery.keyset != KeysetNone;
+        const bool isAscending = (transactionQuery.sortOrder == Qt::AscendingOrder)
+                                 != (isKeyset && transactionQuery.keyset == KeysetBefore);
+        if (isKeyset) {
+            predicates << QString("(%1, id) %2 (:keyset_value, :keyset_id)")
+                              .arg(sortColumn(transactionQuery.sortKey), isAscending ? ">" : "<");
+        }
+
+        QString statement = QString(StorageSqlTransactionQuerySelect)
+                                .arg(columns, predicates.join(" AND "));
+        if (ordered) {
+            statement += QString(StorageSqlTransactionQueryOrder)
+                             .arg(sortColumn(transactionQuery.sortKey),
+                                  isAscending ? "ASC" : "DESC");
+        }
+        if (paged) {
+            statement += StorageSqlTransactionQueryLimit;
+        }
+        if (!enclosing.isEmpty()) {
+            statement = enclosing.arg(statement);
+        }
+
+        query.prepare(statement);
+        if (transactionQuery.accountId > 0) {
+            query.bindValue(":account_id", transactionQuery.accountId);
+        }
+        if (transactionQuery.fromDate.isValid()) {
+            query.bindValue(":from_date", transactionQuery.fromDate);
+        }
+        if (transactionQuery.toDate.isValid()) {
+            query.bindValue(":to_date", transactionQuery.toDate);
+        }
+        for (int i = 0; i < transactionQuery.types.size(); ++i) {
+            query.bindValue(typePlaceholders.at(i), (int) transactionQuery.types.at(i));
+        }
+        for (int i = 0; i < transactionQuery.categories.size(); ++i) {
+            query.bindValue(categoryPlaceholders.at(i), transactionQuery.categories.at(i));
+        }
+        if (paged) {
+            query.bindValue(":limit", transactionQuery.limit);
+            query.bindValue(":offset", isKeyset ? 0 : transactionQuery.offset);
+        }
+        if (isKeyset) {
+            query.bindValue(":keyset_value", transactionQuery.keysetValue);
+            query.bindValue(":keyset_id", transactionQuery.keysetId);
+        }
+    }
+
+    /**
+     * NULL never compares in a row value, so the sort expressions coalesce
+     * them. The schema has an index on (account_id, expression, id) for each.
+     */
+    static QString sortColumn(const TransactionSortKey sortKey)
+    {
+        switch (sortKey) {
+        case SortByDate:
+            return "IFNULL(`date`, '')";
+        case SortByRemoteName:
+            return "IFNULL(remote_name, '')";
+        case SortByPurpose:
+            return "IFNULL(purpose, '')";
+        case SortByCategory:
+            return "IFNULL(`category`, '')";
+        case SortByValue:
+            return "IFNULL(`value`, 0)";
+        case SortById:
+            return "id";
+        case SortByValutaDate:
+        default:
+            return "IFNULL(valuta_date, '')";
+        }
+    }
+
+    CategoryRuleList loadCategoryRules()
+    {
+        CategoryRuleList rules = {};
+
+        QSqlQuery query = databaseQuery();
+        query.exec(StorageSqlCategoryRuleSelectQuery);
+        while (query.next()) {
+            CategoryRule rule;
+            rule.id = query.value("id").toUInt();
+            rule.category = query.value("category").toString();
+            rule.fields = CategoryRuleFields(query.value("fields").toInt());
+            rule.pattern = query.value("pattern").toString();
+            if (!query.value("min_value").isNull()) {
+                rule.minValue = query.value("min_value").toDouble();
+            }
+            if (!query.value("max_value").isNull()) {
+                rule.maxValue = query.value("max_value").toDouble();
+            }
+            rule.priority = query.value("priority").toInt();
+            rules.append(rule);
+        }
+
+        return rules;
+    }
+
+    static void bindCategoryRule(QSqlQuery &query, const CategoryRule &rule)
+    {
+        query.bindValue(":category", rule.category);
+        query.bindValue(":fields", (int) rule.fields);
+        query.bindValue(":pattern", rule.pattern);
+        query.bindValue(":min_value", rule.hasMinValue() ? QVariant(rule.minValue) : QVariant());
+        query.bindValue(":max_value", rule.hasMaxValue() ? QVariant(rule.maxValue) : QVariant());
+        query.bindValue(":priority", rule.priority);
+    }
 
-    StorageConnection *databaseConnection() { return m_connection; }
+    /**
+     * The latest balance is also kept with the account, so the account list
+     * shows it without reading the balances.
+     */
+    static bool storeAccountBalance(QSqlQuery &query,
+                                    const quint32 &accountId,
+                                    const AccountBalance *balance)
+    {
+        if (!balance->createInsertQuery(accountId, query).exec()) {
+            return false;
+        }
+
+        query.prepare(StorageSqlAccountBalanceUpdateQuery);
+        query.bindValue(":balance", balance->balance());
+        query.bindValue(":account_id", accountId);
+        return query.exec();
+    }
+
+    static QString categoryRuleFingerprint(const CategoryRuleList &rules)
+    {
+        QCryptographicHash hash(QCryptographicHash::Sha1);
+        for (const auto &rule : rules) {
+            hash.addData(QString("%1|%2|%3|%4|%5|%6|%7\n")
+                             .arg(rule.id)
+                             .arg(rule.category)
+                             .arg((int) rule.fields)
+                             .arg(rule.pattern)
+                             .arg(rule.minValue)
+                             .arg(rule.maxValue)
+                             .arg(rule.priority)
+                             .toUtf8());
+        }
+        return QString::fromLatin1(hash.result().toHex());
+    }
+
+    /**
+     * The compiled rules are kept until the rules change or the vault is closed.
+     * Queued jobs hold their own reference, so changing the rules while a
+     * batch waits on the executor doesn't free its matcher.
+     */
+    QSharedPointer<const CategoryMatcher> categoryMatcher()
+    {
+        QMutexLocker locker(&m_categoryMatcherMutex);
+        if (!m_categoryMatcher.isNull()) {
+            return m_categoryMatcher;
+        }
+        const quint64 generation = m_categoryMatcherGeneration;
+        locker.unlock();
+
+        // The rules are read on the executor, which may be waiting for the lock
+        const auto rules = m_executor.execute(StorageExecutor::Interactive,
+                                              [this]() { return loadCategoryRules(); });
+        const QSharedPointer<const CategoryMatcher> matcher(new CategoryMatcher(rules));
+
+        // Rules changed while reading are compiled again on the next call
+        locker.relock();
+        if (generation == m_categoryMatcherGeneration && m_categoryMatcher.isNull()) {
+            m_categoryMatcher = matcher;
+        }
+        return matcher;
+    }
+
+    void invalidateCategoryMatcher()
+    {
+        QMutexLocker locker(&m_categoryMatcherMutex);
+        m_categoryMatcher.reset();
+        ++m_categoryMatcherGeneration;
+    }
 
     QSettings *settings()
     {
@@ -180,11 +778,22 @@ public:
 
 private:
     QSettings *m_settings;
-    StorageConnection *m_connection;
+    StorageExecutor m_executor;
+    QHash<QThread *, StorageConnection *> m_readerConnections;
+    QMutex m_readerMutex;
+    QThreadPool m_readerPool;
+    QSharedPointer<const CategoryMatcher> m_categoryMatcher;
+    quint64 m_categoryMatcherGeneration;
+    QMutex m_categoryMatcherMutex;
+    TransactionCache m_transactionCache;
+    QHash<quint32, quint64> m_generations;
     QString m_filePath;
     QString m_key;
+    mutable QMutex m_keyMutex;
+    // Read by the reader threads, written on the executor and the GUI thread
+    std::atomic<bool> m_isValid;
 
-    void setupTables()
+    void setupTables(const CancellationToken &token)
     {
         QFile storageFile(":/app/olbaflinx-storage");
         if (!storageFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
@@ -198,20 +807,29 @@ private:
             queries << query.replace("#", ";").trimmed();
         }
 
-        QSqlQuery query = databaseQuery();
-        for (const auto &sqlStatement : qAsConst(queries)) {
-            if (sqlStatement.isEmpty()) {
-                continue;
-            }
+        m_executor.execute(StorageExecutor::Interactive, [this, &queries, &token]() {
+            // Only takes effect on a new vault, existing ones are converted on close
+            QSqlQuery query = databaseQuery();
+            query.exec("PRAGMA auto_vacuum = INCREMENTAL;");
 
-            databaseConnection()->begindTransaction();
-            bool success = query.exec(sqlStatement);
-            if (!success) {
-                databaseConnection()->rollbackTransaction();
-                return;
+            for (const auto &sqlStatement : qAsConst(queries)) {
+                if (token.isCancelled()) {
+                    return;
+                }
+
+                if (sqlStatement.isEmpty()) {
+                    continue;
+                }
+
+                databaseConnection()->begindTransaction();
+                bool success = query.exec(sqlStatement);
+                if (!success) {
+                    databaseConnection()->rollbackTransaction();
+                    return;
+                }
+                databaseConnection()->commitTransaction();
             }
-            databaseConnection()->commitTransaction();
-        }
+        });
     }
 };
 
@@ -231,9 +849,9 @@ void VaultStorage::setDatabaseKey(const QString &dbFileName, const QString &key)
     d_ptr->setKey(key);
 }
 
-void VaultStorage::initialize(const bool initializeSchema)
+void VaultStorage::initialize(const bool initializeSchema, const CancellationToken &token)
 {
-    d_ptr->initialize(initializeSchema);
+    d_ptr->initialize(initializeSchema, token);
 }
 
 bool VaultStorage::isStorageValid() const
@@ -244,14 +862,27 @@ bool VaultStorage::isStorageValid() const
 bool VaultStorage::changeKey(const QString &oldKey, const QString &newKey)
 {
     d_ptr->setKey(oldKey);
-    QSqlQuery query = d_ptr->databaseQuery();
     bool oldKeyValid = d_ptr->isStorageValid();
     if (!oldKeyValid) {
         return oldKeyValid;
     }
 
-    d_ptr->setKey(newKey);
-    const bool success = query.exec(QString("PRAGMA rekey='%1';").arg(d_ptr->escapeKey(newKey)));
+    // The reader connections are still keyed with the old key and the cached
+    // pages were read through them. Readers open again with the next read.
+    d_ptr->closeReader();
+    d_ptr->transactionCache()->clear();
+
+    const auto executor = d_ptr->executor();
+    const bool success = executor->execute(StorageExecutor::Interactive, [&]() -> bool {
+        QSqlQuery query = d_ptr->databaseQuery();
+        return query.exec(QString("PRAGMA rekey='%1';").arg(d_ptr->escapeKey(newKey)));
+    });
+
+    d_ptr->setKey(success ? newKey : oldKey);
+
+    // A reader opened during the rekey still has the old key
+    d_ptr->closeReader();
+    d_ptr->transactionCache()->clear();
     return success && d_ptr->isStorageValid();
 }
 
@@ -261,9 +892,9 @@ QString VaultStorage::storagePath() const
     return QString("%1/%2").arg(path, SingleApplication::organizationName());
 }
 
-void VaultStorage::close()
+void VaultStorage::close(const CancellationToken &token)
 {
-    d_ptr->close();
+    d_ptr->close(token);
 }
 
 void VaultStorage::storeSetting(const QString &key, const QVariant &value, const QString &group)
@@ -298,6 +929,21 @@ QVariant VaultStorage::setting(const QString &key,
     return value;
 }
 
+QStringList VaultStorage::settingKeys(const QString &group) const
+{
+    if (!group.isEmpty()) {
+        d_ptr->settings()->beginGroup(group);
+    }
+
+    QStringList keys = d_ptr->settings()->childKeys();
+
+    if (!group.isEmpty()) {
+        d_ptr->settings()->endGroup();
+    }
+
+    return keys;
+}
+
 void VaultStorage::addAccount(const Account *account)
 {
     if (account == Q_NULLPTR) {
@@ -308,8 +954,17 @@ void VaultStorage::addAccount(const Account *account)
         return;
     }
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    account->createInsertQuery(query).exec();
+    const bool isInserted = d_ptr->executor()->executeWrite([&]() -> bool {
+        QSqlQuery query = d_ptr->databaseQuery();
+        return account->createInsertQuery(query).exec();
+    });
+
+    if (isInserted) {
+        StorageChange change;
+        change.subject = SubjectAccount;
+        change.inserted << account->uniqueId();
+        publishChange(change);
+    }
 }
 
 void VaultStorage::addAccounts(const AccountList &accounts)
@@ -334,18 +989,28 @@ void VaultStorage::addAccounts(const AccountList &accounts)
         qApp->restoreOverrideCursor();
     });
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    accountWatcher.setFuture(QtConcurrent::run([this, accounts, &query]() -> void {
-        const int accountSize = accounts.size();
-        for (int currentIndex = 0; currentIndex < accountSize; ++currentIndex) {
-            const auto account = accounts.at(currentIndex);
-            account->createInsertQuery(query).exec();
-            const qreal percentage = currentIndex * 100.0 / accountSize;
-            Q_EMIT progress(percentage);
+    StorageChange change;
+    change.subject = SubjectAccount;
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Store accounts"), accounts.size());
+
+    const auto executor = d_ptr->executor();
+    accountWatcher.setFuture(executor->run(StorageExecutor::Normal, [&, accounts, task]() {
+        QSqlQuery query = d_ptr->databaseQuery();
+        for (const auto account : accounts) {
+            if (account->createInsertQuery(query).exec()) {
+                change.inserted << account->uniqueId();
+            }
+            reporter.advance(task);
         }
     }));
 
     loop.exec();
+    reporter.finish();
+
+    publishChange(change);
 }
 
 void VaultStorage::addAccountBalance(const quint32 &accountId, const AccountBalance *balance)
@@ -354,8 +1019,18 @@ void VaultStorage::addAccountBalance(const quint32 &accountId, const AccountBala
         return;
     }
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    balance->createInsertQuery(accountId, query).exec();
+    const bool isStored = d_ptr->executor()->executeWrite([&]() -> bool {
+        QSqlQuery query = d_ptr->databaseQuery();
+        return Private::storeAccountBalance(query, accountId, balance);
+    });
+
+    if (isStored) {
+        StorageChange change;
+        change.subject = SubjectAccount;
+        change.accountId = accountId;
+        change.updated << accountId;
+        publishChange(change);
+    }
 }
 
 void VaultStorage::addAccountBalance(const quint32 &accountId, const AccountBalanceList &balances)
@@ -371,8 +1046,8 @@ void VaultStorage::addAccountBalance(const quint32 &accountId, const AccountBala
     qApp->setOverrideCursor(Qt::WaitCursor);
 
     QEventLoop loop(this);
-    QFutureWatcher<void> accountBalancesWatcher(this);
-    connect(&accountBalancesWatcher, &QFutureWatcher<void>::finished, &loop, [&]() {
+    QFutureWatcher<bool> accountBalancesWatcher(this);
+    connect(&accountBalancesWatcher, &QFutureWatcher<bool>::finished, &loop, [&]() {
         loop.quit();
         accountBalancesWatcher.cancel();
         accountBalancesWatcher.waitForFinished();
@@ -380,18 +1055,31 @@ void VaultStorage::addAccountBalance(const quint32 &accountId, const AccountBala
         qApp->restoreOverrideCursor();
     });
 
-    QSqlQuery query = d_ptr->databaseQuery();
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Store balances"), balances.size());
+
+    const auto executor = d_ptr->executor();
     accountBalancesWatcher.setFuture(
-        QtConcurrent::run([this, accountId, balances, &query]() -> void {
-            const int balanceSize = balances.size();
-            for (int currentIndex = 0; currentIndex < balanceSize; ++currentIndex) {
-                const auto balance = balances.at(currentIndex);
-                balance->createInsertQuery(accountId, query).exec();
-                const qreal percentage = currentIndex * 100.0 / balanceSize;
-                Q_EMIT progress(percentage);
+        executor->run(StorageExecutor::Normal, [&, accountId, balances, task]() -> bool {
+            bool isStored = false;
+            QSqlQuery query = d_ptr->databaseQuery();
+            for (const auto balance : balances) {
+                isStored = Private::storeAccountBalance(query, accountId, balance) || isStored;
+                reporter.advance(task);
             }
+            return isStored;
         }));
     loop.exec();
+    reporter.finish();
+
+    if (accountBalancesWatcher.result()) {
+        StorageChange change;
+        change.subject = SubjectAccount;
+        change.accountId = accountId;
+        change.updated << accountId;
+        publishChange(change);
+    }
 }
 
 AccountList VaultStorage::accounts()
@@ -412,9 +1100,9 @@ AccountList VaultStorage::accounts()
         qApp->restoreOverrideCursor();
     });
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    accountWatcher.setFuture(QtConcurrent::run([&query]() -> AccountList {
+    accountWatcher.setFuture(QtConcurrent::run(d_ptr->readerPool(), [this]() -> AccountList {
         AccountList accounts = {};
+        QSqlQuery query = d_ptr->readerQuery();
         query.exec(StorageSqlAccountSelectQuery);
         while (query.next()) {
             const auto map = Account::queryToMap(query);
@@ -446,9 +1134,9 @@ AccountIds VaultStorage::accountIds()
         qApp->restoreOverrideCursor();
     });
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    accountWatcher.setFuture(QtConcurrent::run([&query]() -> QVector<quint32> {
+    accountWatcher.setFuture(QtConcurrent::run(d_ptr->readerPool(), [this]() -> AccountIds {
         QVector<quint32> ids = QVector<quint32>();
+        QSqlQuery query = d_ptr->readerQuery();
         query.exec(StorageSqlAccountSelectQuery);
         const int fieldNo = query.record().indexOf("unique_id");
         while (query.next()) {
@@ -463,31 +1151,98 @@ AccountIds VaultStorage::accountIds()
 
 AccountBalanceList VaultStorage::accountBalances(const quint32 accountId) { }
 
+AccountCoverage VaultStorage::accountCoverage(const quint32 &accountId) const
+{
+    if (!d_ptr->isStorageValid()) {
+        return AccountCoverage();
+    }
+
+    return QtConcurrent::run(d_ptr->readerPool(), [&]() -> AccountCoverage {
+        QSqlQuery query = d_ptr->readerQuery();
+        return d_ptr->readCoverage(query, accountId);
+    }).result();
+}
+
+bool VaultStorage::addAccountCoverage(const quint32 &accountId, const DateIntervals &intervals)
+{
+    if (intervals.isEmpty()) {
+        return true;
+    }
+
+    if (!d_ptr->isStorageValid()) {
+        return false;
+    }
+
+    // Read, merge and rewrite in one write job, the stored intervals of an
+    // account stay disjoint. The executor rolls the job back if it fails.
+    return d_ptr->executor()->executeWrite([&]() -> bool {
+        QSqlQuery query = d_ptr->databaseQuery();
+        AccountCoverage coverage = d_ptr->readCoverage(query, accountId);
+        for (const auto &interval : intervals) {
+            coverage.add(interval);
+        }
+
+        query.prepare(StorageSqlAccountCoverageDeleteQuery);
+        query.bindValue(":account_id", accountId);
+        if (!query.exec()) {
+            return false;
+        }
+
+        const auto merged = coverage.intervals();
+        for (const auto &interval : merged) {
+            query.prepare(StorageSqlAccountCoverageInsertQuery);
+            query.bindValue(":account_id", accountId);
+            query.bindValue(":from_date", interval.from);
+            query.bindValue(":to_date", interval.to);
+            if (!query.exec()) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
 void VaultStorage::addTransaction(const quint32 &accountId, const Transaction *transaction)
 {
     if (!d_ptr->isStorageValid()) {
         return;
     }
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    transaction->createInsertQuery(accountId, query).exec();
+    const qint64 transactionId = d_ptr->executor()->executeWrite([&]() -> qint64 {
+        QSqlQuery query = d_ptr->databaseQuery();
+        QSqlQuery insertQuery = transaction->createInsertQuery(accountId, query);
+        return insertQuery.exec() ? insertQuery.lastInsertId().toLongLong() : -1;
+    });
+
+    if (transactionId < 0) {
+        return;
+    }
+
+    d_ptr->transactionCache()->invalidate(accountId);
+
+    StorageChange change;
+    change.accountId = accountId;
+    change.inserted << transactionId;
+    publishChange(change);
 }
 
-void VaultStorage::addTransactions(const quint32 &accountId, const TransactionList &transactions)
+bool VaultStorage::addTransactions(const quint32 &accountId,
+                                   const TransactionList &transactions,
+                                   const CancellationToken &token)
 {
     if (transactions.isEmpty()) {
-        return;
+        return true;
     }
 
     if (!d_ptr->isStorageValid()) {
-        return;
+        return false;
     }
 
     qApp->setOverrideCursor(Qt::WaitCursor);
 
     QEventLoop loop(this);
-    QFutureWatcher<void> transactionWatcher(this);
-    connect(&transactionWatcher, &QFutureWatcher<void>::finished, &loop, [&]() {
+    QFutureWatcher<int> transactionWatcher(this);
+    connect(&transactionWatcher, &QFutureWatcher<int>::finished, &loop, [&]() {
         loop.quit();
         transactionWatcher.cancel();
         transactionWatcher.waitForFinished();
@@ -495,30 +1250,54 @@ void VaultStorage::addTransactions(const quint32 &accountId, const TransactionLi
         qApp->restoreOverrideCursor();
     });
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    transactionWatcher.setFuture(
-        QtConcurrent::run([this, accountId, transactions, &query]() -> void {
-            const int transactionSize = transactions.size();
-            for (int currentIndex = 0; currentIndex < transactionSize; ++currentIndex) {
-                const auto transaction = transactions.at(currentIndex);
-                const QString hash = transaction->calculateTransactionHash();
-
-                query.prepare(StorageSqlTransactionExists);
-                query.bindValue(":account_id", accountId);
-                query.bindValue(":hash", hash);
-                query.exec();
-                query.first();
+    const auto change = QSharedPointer<StorageChange>::create();
+    change->accountId = accountId;
+
+    // Remote accounts are validated in one batch at the end
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int insertTask = reporter.addTask(tr("Store transactions"), transactions.size(), 0.9);
+    const int enrichTask = reporter.addTask(tr("Check remote accounts"), 1, 0.1);
+
+    transactionWatcher.setFuture(d_ptr->queueTransactions(accountId,
+                                                          transactions,
+                                                          token,
+                                                          change,
+                                                          &reporter,
+                                                          insertTask,
+                                                          enrichTask));
+    loop.exec();
+    reporter.finish();
 
-                const int count = query.record().value("CNT").toInt();
-                if (count == 0) {
-                    transaction->createInsertQuery(accountId, query).exec();
-                }
+    d_ptr->transactionCache()->invalidate(accountId);
+    publishChange(*change);
 
-                const qreal percentage = currentIndex * 100.0 / transactionSize;
-                Q_EMIT progress(percentage);
-            }
-        }));
-    loop.exec();
+    return transactionWatcher.result() >= 0;
+}
+
+QFuture<int> VaultStorage::queueTransactions(const quint32 &accountId,
+                                             const TransactionList &transactions,
+                                             const CancellationToken &token)
+{
+    if (!d_ptr->isStorageValid()) {
+        return QtConcurrent::run([]() { return -1; });
+    }
+
+    const auto change = QSharedPointer<StorageChange>::create();
+    change->accountId = accountId;
+
+    const auto future = d_ptr->queueTransactions(accountId, transactions, token, change);
+
+    // Published from the GUI thread once the last batch is committed
+    const auto watcher = new QFutureWatcher<int>(this);
+    connect(watcher, &QFutureWatcher<int>::finished, this, [this, watcher, accountId, change]() {
+        d_ptr->transactionCache()->invalidate(accountId);
+        publishChange(*change);
+        watcher->deleteLater();
+    });
+    watcher->setFuture(future);
+
+    return future;
 }
 
 TransactionList VaultStorage::transactions(const quint32 &accountId,
@@ -541,32 +1320,32 @@ TransactionList VaultStorage::transactions(const quint32 &accountId,
         qApp->restoreOverrideCursor();
     });
 
-    QSqlQuery query = d_ptr->databaseQuery();
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Load transactions"), limit);
+
     transactionWatcher.setFuture(
-        QtConcurrent::run([this, accountId, limit, offset, &query]() -> TransactionList {
+        QtConcurrent::run(d_ptr->readerPool(), [&, accountId, limit, offset, task]() {
             TransactionList transactions = {};
 
+            QSqlQuery query = d_ptr->readerQuery();
             query.prepare(StorageSqlTransactionByAccountIdWithLimitQuery);
             query.bindValue(":account_id", accountId);
             query.bindValue(":limit", limit);
             query.bindValue(":offset", offset);
             query.exec();
 
-            int currentIndex = 0;
             while (query.next()) {
                 const auto map = Transaction::queryToMap(query);
                 const auto transaction = Transaction::create(map);
                 transactions.append(transaction);
-
-                const qreal percentage = currentIndex * 100.0 / limit;
-                Q_EMIT progress(percentage);
-
-                ++currentIndex;
+                reporter.advance(task);
             }
 
             return transactions;
         }));
     loop.exec();
+    reporter.finish();
 
     return transactionWatcher.result();
 }
@@ -577,13 +1356,547 @@ int VaultStorage::transactionCount(bool isStandingOrder) const
         return -1;
     }
 
-    QSqlQuery query = d_ptr->databaseQuery();
-    query.prepare(StorageSqlTransactionSelectCountQuery);
-    query.bindValue(":type",
-                    isStandingOrder ? (int) TransactionType::AB_Transaction_TypeStandingOrder
-                                    : (int) TransactionType::AB_Transaction_TypeStatement);
-    query.exec();
-    query.first();
+    return QtConcurrent::run(d_ptr->readerPool(), [&]() -> int {
+        QSqlQuery query = d_ptr->readerQuery();
+        query.prepare(StorageSqlTransactionSelectCountQuery);
+        query.bindValue(":type",
+                        isStandingOrder ? (int) TransactionType::AB_Transaction_TypeStandingOrder
+                                        : (int) TransactionType::AB_Transaction_TypeStatement);
+        query.exec();
+        query.first();
+
+        return query.record().field(0).value().toInt();
+    }).result();
+}
+
+TransactionList VaultStorage::transactions(const TransactionQuery &transactionQuery)
+{
+    if (!d_ptr->isStorageValid()) {
+        return {};
+    }
+
+    qApp->setOverrideCursor(Qt::WaitCursor);
+
+    QEventLoop loop(this);
+    QFutureWatcher<TransactionList> transactionWatcher(this);
+    connect(&transactionWatcher, &QFutureWatcher<TransactionList>::finished, &loop, [&]() {
+        loop.quit();
+        transactionWatcher.cancel();
+        transactionWatcher.waitForFinished();
+
+        qApp->restoreOverrideCursor();
+    });
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Load transactions"), transactionQuery.limit);
+
+    transactionWatcher.setFuture(QtConcurrent::run(d_ptr->readerPool(), [&]() {
+        TransactionList transactions = {};
+
+        QSqlQuery query = d_ptr->readerQuery();
+        Private::prepareTransactionQuery(query, transactionQuery, "*", true, true);
+        if (!query.exec()) {
+            return transactions;
+        }
+
+        while (query.next()) {
+            const auto map = Transaction::queryToMap(query);
+            transactions.append(Transaction::create(map));
+            reporter.advance(task);
+        }
+
+        return transactions;
+    }));
+    loop.exec();
+    reporter.finish();
+
+    return transactionWatcher.result();
+}
+
+int VaultStorage::transactionCount(const TransactionQuery &transactionQuery) const
+{
+    if (!d_ptr->isStorageValid()) {
+        return -1;
+    }
+
+    return QtConcurrent::run(d_ptr->readerPool(), [&]() -> int {
+        QSqlQuery query = d_ptr->readerQuery();
+        Private::prepareTransactionQuery(query, transactionQuery, "COUNT(id)", false, false);
+        if (!query.exec() || !query.first()) {
+            return -1;
+        }
+
+        return query.value(0).toInt();
+    }).result();
+}
+
+QFuture<TransactionRowList> VaultStorage::transactionRows(const TransactionQuery &transactionQuery)
+{
+    if (!d_ptr->isStorageValid()) {
+        return QtConcurrent::run([]() -> TransactionRowList { return {}; });
+    }
+
+    const QLocale locale = QLocale();
+    const auto cache = d_ptr->transactionCache();
+
+    // Pages already read for another view are handed out without a query
+    TransactionRowList cached = {};
+    if (cache->find(transactionQuery, locale, cached)) {
+        QFutureInterface<TransactionRowList> futureInterface(QFutureInterfaceBase::Started);
+        futureInterface.reportFinished(&cached);
+        return futureInterface.future();
+    }
+
+    const quint64 generation = cache->generation();
+    return QtConcurrent::run(d_ptr->readerPool(),
+                             [this, transactionQuery, locale, cache, generation]()
+                                 -> TransactionRowList {
+                                 TransactionRowList rows = {};
+                                 rows.reserve(transactionQuery.limit);
+
+                                 const QString columns
+                                     = QString("%1, %2")
+                                           .arg(StorageSqlTransactionRowColumns,
+                                                Private::sortColumn(transactionQuery.sortKey));
+
+                                 QSqlQuery query = d_ptr->readerQuery();
+                                 query.setForwardOnly(true);
+                                 Private::prepareTransactionQuery(query,
+                                                                  transactionQuery,
+                                                                  columns,
+                                                                  true,
+                                                                  true);
+                                 if (!query.exec()) {
+                                     return rows;
+                                 }
+
+                                 while (query.next()) {
+                                     rows.append(TransactionRow::create(query, locale, true));
+                                 }
+
+                                 if (transactionQuery.keyset == KeysetBefore) {
+                                     std::reverse(rows.begin(), rows.end());
+                                 }
+
+                                 cache->insert(transactionQuery, locale, rows, generation);
+                                 return rows;
+                             });
+}
+
+QFuture<TransactionPage> VaultStorage::transactionPage(const TransactionQuery &transactionQuery)
+{
+    if (!d_ptr->isStorageValid()) {
+        return QtConcurrent::run([]() -> TransactionPage { return {}; });
+    }
+
+    return QtConcurrent::run(d_ptr->readerPool(), [this, transactionQuery]() -> TransactionPage {
+        TransactionPage page;
+        page.transactions.reserve(transactionQuery.limit);
+
+        const QString columns
+            = QString("*, %1 AS sort_value").arg(Private::sortColumn(transactionQuery.sortKey));
+
+        QSqlQuery query = d_ptr->readerQuery();
+        query.setForwardOnly(true);
+        Private::prepareTransactionQuery(query, transactionQuery, columns, true, true);
+        if (!query.exec()) {
+            return page;
+        }
+
+        const int idIndex = query.record().indexOf("id");
+        const int sortValueIndex = query.record().indexOf("sort_value");
+        while (query.next()) {
+            page.transactions.append(Transaction::create(Transaction::queryToMap(query)));
+            page.lastId = query.value(idIndex).toLongLong();
+            page.lastSortValue = query.value(sortValueIndex);
+        }
+
+        return page;
+    });
+}
+
+void VaultStorage::setTransactionCacheBudget(const qint64 bytes)
+{
+    d_ptr->transactionCache()->setMemoryBudget(bytes);
+    storeSetting(TransactionCacheSettingKey, bytes);
+}
+
+qint64 VaultStorage::transactionCacheBudget() const
+{
+    return d_ptr->transactionCache()->memoryBudget();
+}
+
+QFuture<TransactionRowList> VaultStorage::transactionRowsById(const QVector<qint64> &ids)
+{
+    if (ids.isEmpty() || !d_ptr->isStorageValid()) {
+        return QtConcurrent::run([]() -> TransactionRowList { return {}; });
+    }
+
+    const QLocale locale = QLocale();
+    return QtConcurrent::run(d_ptr->readerPool(), [this, ids, locale]() -> TransactionRowList {
+        QStringList placeholders = {};
+        for (int i = 0; i < ids.size(); ++i) {
+            placeholders << "?";
+        }
+
+        QSqlQuery query = d_ptr->readerQuery();
+        query.setForwardOnly(true);
+        query.prepare(QString(StorageSqlTransactionRowsByIdsQuery).arg(placeholders.join(',')));
+        for (const auto id : ids) {
+            query.addBindValue(id);
+        }
+        if (!query.exec()) {
+            return {};
+        }
+
+        QHash<qint64, TransactionRow> found = {};
+        while (query.next()) {
+            const auto row = TransactionRow::create(query, locale);
+            found.insert(row.id, row);
+        }
+
+        // Keep the order of the given ids
+        TransactionRowList rows = {};
+        rows.reserve(found.size());
+        for (const auto id : ids) {
+            const auto row = found.constFind(id);
+            if (row != found.constEnd()) {
+                rows.append(row.value());
+            }
+        }
+
+        return rows;
+    });
+}
+
+QFuture<TransactionSearchIndex> VaultStorage::transactionSearchIndex(
+    const TransactionQuery &transactionQuery)
+{
+    if (!d_ptr->isStorageValid()) {
+        return QtConcurrent::run([]() -> TransactionSearchIndex { return {}; });
+    }
+
+    const QLocale locale = QLocale();
+    return QtConcurrent::run(d_ptr->readerPool(), [this, transactionQuery, locale]() {
+        TransactionSearchIndex index = {};
+
+        const QString columns = QString("%1, %2")
+                                    .arg(StorageSqlTransactionRowColumns,
+                                         Private::sortColumn(transactionQuery.sortKey));
+
+        QSqlQuery query = d_ptr->readerQuery();
+        query.setForwardOnly(true);
+        Private::prepareTransactionQuery(query, transactionQuery, columns, true, true);
+        if (!query.exec()) {
+            return index;
+        }
+
+        // Date and value are searched as the view shows them
+        while (query.next()) {
+            const auto row = TransactionRow::create(query, locale, true);
+            index.lastId = row.id;
+            index.lastSortValue = row.sortValue;
+            index.ids << row.id;
+            index.texts << QStringList({row.remoteName,
+                                        row.purpose,
+                                        row.category,
+                                        row.displayDate,
+                                        row.displayValue})
+                               .join('\n')
+                               .toLower();
+        }
+
+        return index;
+    });
+}
+
+QVector<int> VaultStorage::transactionPositions(const TransactionQuery &transactionQuery,
+                                               const QVector<qint64> &ids) const
+{
+    if (ids.isEmpty() || !d_ptr->isStorageValid()) {
+        return {};
+    }
+
+    const QString columns = QString(StorageSqlTransactionPositionColumns)
+                                .arg(Private::sortColumn(transactionQuery.sortKey),
+                                     transactionQuery.sortOrder == Qt::AscendingOrder ? "ASC"
+                                                                                      : "DESC");
+
+    const auto readerPool = d_ptr->readerPool();
+    auto positions = QtConcurrent::run(readerPool, [&]() -> QVector<int> {
+        QVector<int> positions = {};
+
+        // All chunks are read from the same snapshot
+        const auto connection = d_ptr->readerConnection();
+        connection->begindTransaction();
+
+        QSqlQuery query = d_ptr->readerQuery();
+        const int chunkSize = 500;
+        for (int offset = 0; offset < ids.size(); offset += chunkSize) {
+            const auto chunk = ids.mid(offset, chunkSize);
+            QStringList placeholders = {};
+            for (int i = 0; i < chunk.size(); ++i) {
+                placeholders << QString(":id_%1").arg(i);
+            }
+
+            Private::prepareTransactionQuery(query,
+                                             transactionQuery,
+                                             columns,
+                                             false,
+                                             false,
+                                             QString(StorageSqlTransactionPositionQuery)
+                                                 .arg("%1", placeholders.join(", ")));
+            for (int i = 0; i < chunk.size(); ++i) {
+                query.bindValue(placeholders.at(i), chunk.at(i));
+            }
+            if (!query.exec()) {
+                connection->rollbackTransaction();
+                return {};
+            }
+
+            while (query.next()) {
+                positions << query.value(1).toInt();
+            }
+        }
+
+        connection->commitTransaction();
+        return positions;
+    }).result();
+
+    std::sort(positions.begin(), positions.end());
+    return positions;
+}
+
+quint64 VaultStorage::generation(const quint32 accountId) const
+{
+    return d_ptr->generation(accountId);
+}
+
+StorageExecutorMetrics VaultStorage::executorMetrics() const
+{
+    return d_ptr->executor()->metrics();
+}
+
+void VaultStorage::connectProgress(ProgressReporter *reporter)
+{
+    connect(reporter, &ProgressReporter::progress, this, &VaultStorage::progress);
+    connect(reporter, &ProgressReporter::stateChanged, this, &VaultStorage::progressChanged);
+}
+
+void VaultStorage::publishChange(StorageChange change)
+{
+    if (change.isEmpty()) {
+        return;
+    }
+
+    change.generation = d_ptr->nextGeneration(change.accountId);
+    Q_EMIT storageChanged(change);
+}
+
+CategoryRuleList VaultStorage::categoryRules()
+{
+    if (!d_ptr->isStorageValid()) {
+        return {};
+    }
+
+    return d_ptr->executor()->execute(StorageExecutor::Interactive,
+                                      [this]() { return d_ptr->loadCategoryRules(); });
+}
+
+quint32 VaultStorage::addCategoryRule(const CategoryRule &rule)
+{
+    if (!d_ptr->isStorageValid()) {
+        return 0;
+    }
+
+    const quint32 ruleId = d_ptr->executor()->executeWrite([&]() -> quint32 {
+        QSqlQuery query = d_ptr->databaseQuery();
+        query.prepare(StorageSqlCategoryRuleInsertQuery);
+        Private::bindCategoryRule(query, rule);
+        return query.exec() ? query.lastInsertId().toUInt() : 0;
+    });
+
+    if (ruleId != 0) {
+        d_ptr->invalidateCategoryMatcher();
+    }
+    return ruleId;
+}
+
+bool VaultStorage::updateCategoryRule(const CategoryRule &rule)
+{
+    if (!d_ptr->isStorageValid()) {
+        return false;
+    }
+
+    const bool success = d_ptr->executor()->executeWrite([&]() -> bool {
+        QSqlQuery query = d_ptr->databaseQuery();
+        query.prepare(StorageSqlCategoryRuleUpdateQuery);
+        Private::bindCategoryRule(query, rule);
+        query.bindValue(":id", rule.id);
+        return query.exec();
+    });
+
+    d_ptr->invalidateCategoryMatcher();
+    return success;
+}
+
+bool VaultStorage::removeCategoryRule(const quint32 &ruleId)
+{
+    if (!d_ptr->isStorageValid()) {
+        return false;
+    }
+
+    const bool success = d_ptr->executor()->executeWrite([&]() -> bool {
+        QSqlQuery query = d_ptr->databaseQuery();
+        query.prepare(StorageSqlCategoryRuleDeleteQuery);
+        query.bindValue(":id", ruleId);
+        return query.exec();
+    });
+
+    d_ptr->invalidateCategoryMatcher();
+    return success;
+}
+
+int VaultStorage::categorizeTransactions(const CancellationToken &token)
+{
+    if (!d_ptr->isStorageValid()) {
+        return -1;
+    }
+
+    qApp->setOverrideCursor(Qt::WaitCursor);
+
+    QEventLoop loop(this);
+    QFutureWatcher<int> categorizeWatcher(this);
+    connect(&categorizeWatcher, &QFutureWatcher<int>::finished, &loop, [&]() {
+        loop.quit();
+        categorizeWatcher.cancel();
+        categorizeWatcher.waitForFinished();
+
+        qApp->restoreOverrideCursor();
+    });
+
+    const auto matcher = d_ptr->categoryMatcher();
+    const QString fingerprint = Private::categoryRuleFingerprint(categoryRules());
+
+    // Changed transaction ids per account
+    QHash<quint32, QVector<qint64>> updated = {};
+
+    ProgressReporter reporter;
+    connectProgress(&reporter);
+    const int task = reporter.addTask(tr("Categorize transactions"));
+
+    const auto executor = d_ptr->executor();
+    categorizeWatcher.setFuture(executor->run(StorageExecutor::Background, [&]() -> int {
+        QSqlQuery query = d_ptr->databaseQuery();
+        query.prepare(StorageSqlCategoryRuleRunClearQuery);
+        query.bindValue(":fingerprint", fingerprint);
+        query.exec();
+
+        query.prepare(StorageSqlCategoryRuleRunSelectQuery);
+        query.bindValue(":fingerprint", fingerprint);
+        query.exec();
+        qint64 lastId = query.first() ? query.value(0).toLongLong() : 0;
+
+        query.exec("SELECT COUNT(id) FROM transactions");
+        if (query.first()) {
+            reporter.setTaskTotal(task, query.value(0).toLongLong());
+        }
+
+        struct Change
+        {
+            qint64 id = 0;
+            quint32 accountId = 0;
+            QString category = "";
+            quint32 ruleId = 0;
+        };
+
+        int changed = 0;
+        while (!token.isCancelled()) {
+            QVector<Change> changes = {};
+            int rows = 0;
+
+            query.prepare(StorageSqlTransactionCategorizeQuery);
+            query.bindValue(":last_id", lastId);
+            query.bindValue(":limit", StorageCategorizeChunkSize);
+            query.exec();
+            while (query.next()) {
+                ++rows;
+                lastId = query.value(0).toLongLong();
+
+                const QString category = query.value(5).toString();
+                const bool hasRule = !query.value(6).isNull();
+                if (!category.isEmpty() && !hasRule) {
+                    // Set by the bank or by the user
+                    continue;
+                }
+                if (hasRule && category != query.value(8).toString()) {
+                    // Changed by the user after a rule assigned it
+                    continue;
+                }
+
+                const quint32 accountId = query.value(7).toUInt();
+                const auto rule = matcher->match(query.value(1).toString(),
+                                                 query.value(2).toString(),
+                                                 query.value(3).toString(),
+                                                 query.value(4).toDouble());
+                if (rule != Q_NULLPTR) {
+                    if (!hasRule || query.value(6).toUInt() != rule->id
+                        || category != rule->category) {
+                        changes.append({lastId, accountId, rule->category, rule->id});
+                    }
+                } else if (hasRule) {
+                    changes.append({lastId, accountId, "", 0});
+                }
+            }
+
+            if (rows == 0) {
+                break;
+            }
+
+            d_ptr->databaseConnection()->begindTransaction();
+            for (const auto &change : qAsConst(changes)) {
+                query.prepare(StorageSqlTransactionCategoryUpdateQuery);
+                query.bindValue(":category", change.category);
+                query.bindValue(":id", change.id);
+                query.exec();
+                updated[change.accountId] << change.id;
+
+                if (change.ruleId == 0) {
+                    query.prepare(StorageSqlTransactionCategoryRuleDeleteQuery);
+                    query.bindValue(":transaction_id", change.id);
+                } else {
+                    query.prepare(StorageSqlTransactionCategoryRuleInsertQuery);
+                    query.bindValue(":transaction_id", change.id);
+                    query.bindValue(":rule_id", change.ruleId);
+                    query.bindValue(":category", change.category);
+                }
+                query.exec();
+            }
+
+            query.prepare(StorageSqlCategoryRuleRunUpdateQuery);
+            query.bindValue(":fingerprint", fingerprint);
+            query.bindValue(":last_transaction_id", lastId);
+            query.exec();
+            d_ptr->databaseConnection()->commitTransaction();
+
+            changed += changes.size();
+            reporter.advance(task, rows);
+        }
+
+        return changed;
+    }));
+    loop.exec();
+    reporter.finish();
+
+    for (auto it = updated.constBegin(); it != updated.constEnd(); ++it) {
+        d_ptr->transactionCache()->invalidate(it.key());
+
+        StorageChange change;
+        change.accountId = it.key();
+        change.updated = it.value();
+        publishChange(change);
+    }
 
-    return query.record().field(0).value().toInt();
+    return categorizeWatcher.result();
 }
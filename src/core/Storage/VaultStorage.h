@@ -18,16 +18,29 @@
 #ifndef OLBAFLINX_VAULT_STORAGE_H
 #define OLBAFLINX_VAULT_STORAGE_H
 
+#include <QtCore/QFuture>
 #include <QtCore/QObject>
 #include <QtCore/QScopedPointer>
+#include <QtCore/QStringList>
 
 #include "core/Container.h"
+#include "core/Progress/CancellationToken.h"
+#include "core/Progress/ProgressReporter.h"
 #include "core/Singleton.h"
+#include "core/Storage/Account/AccountCoverage.h"
+#include "core/Storage/Category/CategoryRule.h"
+#include "core/Storage/Connection/StorageExecutor.h"
+#include "core/Storage/StorageChange.h"
+#include "core/Storage/Transaction/TransactionQuery.h"
+#include "core/Storage/Transaction/TransactionRow.h"
 
 namespace olbaflinx::core::storage {
 
 using namespace account;
+using namespace category;
+using namespace connection;
 using namespace transaction;
+using namespace progress;
 
 class VaultStorage : public QObject, public Singleton<VaultStorage>
 {
@@ -38,16 +51,23 @@ public:
     ~VaultStorage() override;
 
     void setDatabaseKey(const QString &dbFileName, const QString &key);
-    void initialize(bool initializeSchema = false);
+    /**
+     * Long running operations take a token to stop them. They stop between
+     * batches, the work committed so far is kept and the current batch is
+     * rolled back.
+     */
+    void initialize(bool initializeSchema = false,
+                    const CancellationToken &token = CancellationToken());
     bool isStorageValid() const;
     bool changeKey(const QString &oldKey, const QString &newKey);
     QString storagePath() const;
-    void close();
+    void close(const CancellationToken &token = CancellationToken());
 
     void storeSetting(const QString &key, const QVariant &value, const QString &group = QString());
     QVariant setting(const QString &key,
                      const QString &group = QString(),
                      const QVariant &defaultValue = QVariant()) const;
+    QStringList settingKeys(const QString &group = QString()) const;
 
     void addAccount(const Account *account);
     void addAccounts(const AccountList &accounts);
@@ -57,20 +77,116 @@ public:
     AccountIds accountIds();
     AccountBalanceList accountBalances(const quint32 accountId = 0);
 
+    /**
+     * Date ranges fetched successfully from the bank per account. A sync only
+     * asks for the gaps and adds what it fetched afterwards.
+     */
+    AccountCoverage accountCoverage(const quint32 &accountId) const;
+    bool addAccountCoverage(const quint32 &accountId, const DateIntervals &intervals);
+
     void addTransaction(const quint32 &accountId, const Transaction *transaction);
-    void addTransactions(const quint32 &accountId, const TransactionList &transactions);
+    bool addTransactions(const quint32 &accountId,
+                         const TransactionList &transactions,
+                         const CancellationToken &token = CancellationToken());
+
+    /**
+     * Same as `addTransactions` without waiting, the batches are stored in the
+     * background while the caller goes on. The transactions have to stay alive
+     * until the future is finished, its result is the number of new
+     * transactions or -1 if not all of them were stored.
+     */
+    QFuture<int> queueTransactions(const quint32 &accountId,
+                                   const TransactionList &transactions,
+                                   const CancellationToken &token = CancellationToken());
     TransactionList transactions(const quint32 &accountId,
                                  const qint32 &limit = 50,
                                  const qint32 &offset = 0);
     int transactionCount(bool isStandingOrder = false) const;
 
+    /**
+     * Account, date range and type filter as well as the sort order of the
+     * query are part of the SQL statement, only matching rows are loaded.
+     */
+    TransactionList transactions(const TransactionQuery &transactionQuery);
+    int transactionCount(const TransactionQuery &transactionQuery) const;
+
+    /**
+     * Asynchronous lookups for views. They run on reader threads, each with
+     * its own connection, and never block the GUI. The vault is kept in WAL
+     * mode, so readers see the last commit while an import is still writing.
+     */
+    QFuture<TransactionRowList> transactionRows(const TransactionQuery &transactionQuery);
+    QFuture<TransactionRowList> transactionRowsById(const QVector<qint64> &ids);
+
+    /**
+     * Search texts of one chunk, paged by the limit and keyset of the query.
+     */
+    QFuture<TransactionSearchIndex> transactionSearchIndex(const TransactionQuery &transactionQuery);
+
+    /**
+     * Complete transactions of one page on a reader thread, read forward in
+     * the sort order of the query. Not cached, the caller owns them.
+     */
+    QFuture<TransactionPage> transactionPage(const TransactionQuery &transactionQuery);
+
+    /**
+     * Positions of the given transactions in the sort order of the query,
+     * ascending. Ids not matching its filter are left out.
+     */
+    QVector<int> transactionPositions(const TransactionQuery &transactionQuery,
+                                      const QVector<qint64> &ids) const;
+
+    /**
+     * Pages of `transactionRows` are shared by all views through a cache of the
+     * vault. It is invalidated per account on writes, the budget is stored in
+     * the settings.
+     */
+    void setTransactionCacheBudget(const qint64 bytes);
+    [[nodiscard]] qint64 transactionCacheBudget() const;
+
+    CategoryRuleList categoryRules();
+    quint32 addCategoryRule(const CategoryRule &rule);
+    bool updateCategoryRule(const CategoryRule &rule);
+    bool removeCategoryRule(const quint32 &ruleId);
+
+    /**
+     * Applies the current category rules to the whole transaction history in
+     * chunks. Only rows whose result changes are written, manually set
+     * categories are kept, also those changed after a rule assigned one. The
+     * progress is stored per rule set, so an unchanged rule set costs nothing
+     * and an interrupted run continues where it stopped.
+     *
+     * Returns the number of changed transactions or -1 on error.
+     */
+    int categorizeTransactions(const CancellationToken &token = CancellationToken());
+
+    /**
+     * Number of changes published for the account so far.
+     */
+    [[nodiscard]] quint64 generation(const quint32 accountId) const;
+
+    /**
+     * All access to the write connection is serialized through one executor
+     * thread, these are its queue depth and latencies.
+     */
+    [[nodiscard]] StorageExecutorMetrics executorMetrics() const;
+
 Q_SIGNALS:
     void progress(const qreal progress);
+    void progressChanged(const ProgressState &state);
+
+    /**
+     * Emitted after each committed write with the rows it touched.
+     */
+    void storageChanged(const StorageChange &change);
 
 protected:
     class Private;
     QScopedPointer<Private> d_ptr;
 
+    void connectProgress(ProgressReporter *reporter);
+    void publishChange(StorageChange change);
+
     VaultStorage();
     Q_DISABLE_COPY(VaultStorage)
 };
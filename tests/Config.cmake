@@ -47,24 +47,32 @@ set(TEST_APP_CORE_DIR ${CMAKE_CURRENT_SOURCE_DIR}/../src)
 file(
         GLOB_RECURSE APP_SRC_FILES
         ${TEST_APP_CORE_DIR}/core/*.cpp
+        ${TEST_APP_CORE_DIR}/core/BankData/*.cpp
         ${TEST_APP_CORE_DIR}/core/Banking/*.cpp
         ${TEST_APP_CORE_DIR}/core/Logger/*.cpp
         ${TEST_APP_CORE_DIR}/core/MaterialDesign/*.cpp
+        ${TEST_APP_CORE_DIR}/core/Progress/*.cpp
         ${TEST_APP_CORE_DIR}/core/SingleApplication/*.cpp
+        ${TEST_APP_CORE_DIR}/core/Statement/*.cpp
         ${TEST_APP_CORE_DIR}/core/Storage/*.cpp
         ${TEST_APP_CORE_DIR}/core/Storage/Account/*.cpp
+        ${TEST_APP_CORE_DIR}/core/Storage/Category/*.cpp
         ${TEST_APP_CORE_DIR}/core/Storage/Connection/*.cpp
         ${TEST_APP_CORE_DIR}/core/Storage/Transaction/*.cpp
 )
 file(
         GLOB_RECURSE APP_HDR_FILES
         ${TEST_APP_CORE_DIR}/core/*.h
+        ${TEST_APP_CORE_DIR}/core/BankData/*.h
         ${TEST_APP_CORE_DIR}/core/Banking/*.h
         ${TEST_APP_CORE_DIR}/core/Logger/*.h
         ${TEST_APP_CORE_DIR}/core/MaterialDesign/*.h
+        ${TEST_APP_CORE_DIR}/core/Progress/*.h
         ${TEST_APP_CORE_DIR}/core/SingleApplication/*.h
+        ${TEST_APP_CORE_DIR}/core/Statement/*.h
         ${TEST_APP_CORE_DIR}/core/Storage/*.h
         ${TEST_APP_CORE_DIR}/core/Storage/Account/*.h
+        ${TEST_APP_CORE_DIR}/core/Storage/Category/*.h
         ${TEST_APP_CORE_DIR}/core/Storage/Connection/*.h
         ${TEST_APP_CORE_DIR}/core/Storage/Transaction/*.h
 )
@@ -77,12 +85,16 @@ set(
         TEST_INCLUDES
         ${TEST_APP_CORE_DIR}
         ${TEST_APP_CORE_DIR}/core
+        ${TEST_APP_CORE_DIR}/core/BankData
         ${TEST_APP_CORE_DIR}/core/Banking
         ${TEST_APP_CORE_DIR}/core/Logger
         ${TEST_APP_CORE_DIR}/core/MaterialDesign
+        ${TEST_APP_CORE_DIR}/core/Progress
         ${TEST_APP_CORE_DIR}/core/SingleApplication
+        ${TEST_APP_CORE_DIR}/core/Statement
         ${TEST_APP_CORE_DIR}/core/Storage
         ${TEST_APP_CORE_DIR}/core/Storage/Account
+        ${TEST_APP_CORE_DIR}/core/Storage/Category
         ${TEST_APP_CORE_DIR}/core/Storage/Connection
         ${TEST_APP_CORE_DIR}/core/Storage/Transaction
 )
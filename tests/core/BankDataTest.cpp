@@ -0,0 +1,276 @@
+/**
+ * Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtConcurrent/QtConcurrent>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+#include "core/BankData/BankDirectory.h"
+#include "core/BankData/IbanValidator.h"
+#include "core/SingleApplication/SingleApplication.h"
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::bankdata;
+
+namespace olbaflinx::core::bankdata::tests {
+
+class BankDataTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    BankDataTest();
+    ~BankDataTest() override;
+
+private:
+    QString directoryFile;
+    QString bankCodeFile;
+
+    static QByteArray createRecord(const QString &bankCode,
+                                   const QString &name,
+                                   const QString &location,
+                                   const QString &bic,
+                                   const QString &method,
+                                   char changeFlag = 'U',
+                                   const QString &successor = "00000000");
+    void writeBankCodeFile(const QList<QByteArray> &records);
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testUpdateWithoutOpenDirectory();
+    void testInitialUpdate();
+    void testUpdateIsIncremental();
+    void testUpdateChangesAndDeletions();
+    void testBatchLookup();
+    void testIbanCheckDigits();
+    void testIbanValidation();
+    void testBicValidation();
+};
+
+BankDataTest::BankDataTest()
+    : directoryFile(QDir::tempPath().append("/olbaflinx_bankdata_test.obfx"))
+    , bankCodeFile(QDir::tempPath().append("/olbaflinx_bankdata_test.txt"))
+{
+    SingleApplication::setApplicationName("OlbaFlinx");
+    SingleApplication::setApplicationVersion("1.0.0");
+    SingleApplication::setOrganizationName("de.chm-projects.olbaflinx.test");
+    SingleApplication::setOrganizationDomain("https://olbaflinx.chm-projects.de");
+}
+
+BankDataTest::~BankDataTest() = default;
+
+QByteArray BankDataTest::createRecord(const QString &bankCode,
+                                      const QString &name,
+                                      const QString &location,
+                                      const QString &bic,
+                                      const QString &method,
+                                      char changeFlag,
+                                      const QString &successor)
+{
+    QByteArray record;
+    record.append(bankCode.toLatin1());
+    record.append('1');
+    record.append(name.leftJustified(58, ' ', true).toLatin1());
+    record.append(QByteArray("10115"));
+    record.append(location.leftJustified(35, ' ', true).toLatin1());
+    record.append(name.leftJustified(27, ' ', true).toLatin1());
+    record.append(QByteArray("12345"));
+    record.append(bic.leftJustified(11, ' ', true).toLatin1());
+    record.append(method.toLatin1());
+    record.append(QByteArray("000001"));
+    record.append(changeFlag);
+    record.append('0');
+    record.append(successor.toLatin1());
+    record.append('\n');
+
+    return record;
+}
+
+void BankDataTest::writeBankCodeFile(const QList<QByteArray> &records)
+{
+    QFile file(bankCodeFile);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    for (const auto &record : records) {
+        file.write(record);
+    }
+    file.close();
+}
+
+void BankDataTest::initTestCase()
+{
+    QFile::remove(directoryFile);
+    QFile::remove(bankCodeFile);
+}
+
+void BankDataTest::cleanupTestCase()
+{
+    BankDirectory::instance()->close();
+
+    QFile::remove(directoryFile);
+    QFile::remove(bankCodeFile);
+}
+
+void BankDataTest::testUpdateWithoutOpenDirectory()
+{
+    const auto directory = BankDirectory::instance();
+    directory->close();
+
+    const auto result = directory->update(bankCodeFile, QDate::currentDate());
+    QVERIFY(!result.success);
+    QVERIFY(!result.errorMessage.isEmpty());
+}
+
+void BankDataTest::testInitialUpdate()
+{
+    writeBankCodeFile(
+        {createRecord("10000000", "Bundesbank", "Berlin", "MARKDEF1100", "09"),
+         createRecord("10010010", "Postbank", "Berlin", "PBNKDEFFXXX", "24"),
+         createRecord("50010517", "ING-DiBa", "Frankfurt am Main", "INGDDEFFXXX", "13")});
+
+    const auto directory = BankDirectory::instance();
+    QVERIFY(directory->open(directoryFile));
+
+    const auto result = directory->update(bankCodeFile, QDate::currentDate());
+    QVERIFY(result.success);
+    QCOMPARE(result.inserted, 3);
+    QCOMPARE(result.updated, 0);
+    QCOMPARE(result.deleted, 0);
+}
+
+void BankDataTest::testUpdateIsIncremental()
+{
+    const auto result = BankDirectory::instance()->update(bankCodeFile, QDate::currentDate());
+    QVERIFY(result.success);
+    QCOMPARE(result.inserted, 0);
+    QCOMPARE(result.updated, 0);
+    QCOMPARE(result.deleted, 0);
+    QCOMPARE(result.unchanged, 3);
+}
+
+void BankDataTest::testUpdateChangesAndDeletions()
+{
+    writeBankCodeFile(
+        {createRecord("10000000", "Bundesbank", "Berlin", "MARKDEF1100", "09"),
+         createRecord("10010010", "Postbank", "Berlin", "PBNKDEFFXXX", "24", 'D', "10010011"),
+         createRecord("50010517", "ING", "Frankfurt am Main", "INGDDEFFXXX", "13", 'M')});
+
+    const auto directory = BankDirectory::instance();
+    const auto result = directory->update(bankCodeFile, QDate(2022, 6, 5));
+    QVERIFY(result.success);
+    QCOMPARE(result.inserted, 1);
+    QCOMPARE(result.updated, 1);
+    QCOMPARE(result.deleted, 1);
+    QCOMPARE(result.unchanged, 1);
+
+    QVERIFY(!directory->institution("10010010").isValid);
+    QCOMPARE(directory->institution("10010011").bic, "PBNKDEFFXXX");
+    QCOMPARE(directory->institution("50010517").name, "ING");
+}
+
+void BankDataTest::testBatchLookup()
+{
+    const auto institutions = BankDirectory::instance()->institutions(
+        {"10000000", "50010517", "99999999", "123"});
+
+    QCOMPARE(institutions.size(), 2);
+    QCOMPARE(institutions.value("10000000").location, "Berlin");
+    QCOMPARE(institutions.value("50010517").method, "13");
+    QVERIFY(!institutions.contains("99999999"));
+
+    // Worker threads get a connection of their own
+    const auto workerInstitutions = QtConcurrent::run([]() {
+                                        return BankDirectory::instance()->institutions(
+                                            {"10000000"});
+                                    }).result();
+    QCOMPARE(workerInstitutions.value("10000000").bic, "MARKDEF1100");
+}
+
+void BankDataTest::testIbanCheckDigits()
+{
+    QStringList ibans = {"DE02500105170137075030",
+                         "DE02500105170137075031",
+                         "GB82WEST12345698765432",
+                         "NL91ABNA0417164300"};
+
+    // More than one lane of the kernel
+    for (int i = 0; i < 20; ++i) {
+        ibans << "DE02500105170137075030";
+    }
+
+    // Too long or with characters outside of A-Z and 0-9
+    ibans << QString("DE02").append(QString(60, 'Z')) << "DE02-5001/0517*0137075030"
+          << "DE02500105170137075030!";
+    ibans << "DE02500105170137075030";
+
+    const auto result = IbanValidator::checkDigits(ibans);
+    QCOMPARE(result.size(), ibans.size());
+    QVERIFY(result.at(0));
+    QVERIFY(!result.at(1));
+    QVERIFY(result.at(2));
+    QVERIFY(result.at(3));
+    QVERIFY(result.at(23));
+    QVERIFY(!result.at(24));
+    QVERIFY(!result.at(25));
+    QVERIFY(!result.at(26));
+    QVERIFY(result.at(ibans.size() - 1));
+}
+
+void BankDataTest::testIbanValidation()
+{
+    const auto validator = IbanValidator::instance();
+    validator->clearCache();
+
+    const auto results = validator->validate(
+        QStringList({"DE02 5001 0517 0137 0750 30", "de02500105170137075030", "DE00ABC"}));
+
+    QCOMPARE(results.size(), 2);
+
+    const auto result = results.value("DE02500105170137075030");
+    QVERIFY(result.isIbanValid);
+    QCOMPARE(result.bankCode, "50010517");
+    QCOMPARE(result.accountNumber, "0137075030");
+    QCOMPARE(result.bic, "INGDDEFFXXX");
+    QVERIFY(result.isBankKnown);
+
+    QVERIFY(!results.value("DE00ABC").isIbanValid);
+
+    // No account check exists outside of germany
+    const auto foreign = validator->validate(QString("GB82WEST12345698765432"));
+    QVERIFY(foreign.isIbanValid);
+    QVERIFY(!foreign.isAccountChecked);
+    QVERIFY(!foreign.isAccountValid);
+}
+
+void BankDataTest::testBicValidation()
+{
+    const auto result = IbanValidator::instance()->validate(QString("DE02500105170137075030"));
+
+    QVERIFY(IbanValidator::isBicValid("INGDDEFFXXX", result));
+    QVERIFY(IbanValidator::isBicValid("INGDDEFF", result));
+    QVERIFY(!IbanValidator::isBicValid("PBNKDEFFXXX", result));
+    QVERIFY(!IbanValidator::isBicValid("INGDNL2A", result));
+    QVERIFY(!IbanValidator::isBicValid("ING"));
+}
+
+} // namespace olbaflinx::core::bankdata::tests
+
+QTEST_MAIN(bankdata::tests::BankDataTest)
+
+#include "BankDataTest.moc"
@@ -15,12 +15,20 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
 #include <QtCore/QObject>
 #include <QtCore/QRandomGenerator>
 #include <QtTest/QtTest>
 
+#include "core/Banking/BackfillScheduler.h"
 #include "core/Banking/OnlineBanking.h"
+#include "core/Banking/ReplayTransport.h"
+#include "core/Banking/StatementImporter.h"
+#include "core/BankingHandle.h"
 #include "core/SingleApplication/SingleApplication.h"
+#include "core/Statement/StatementParser.h"
 
 #include "BaseTest.h"
 
@@ -46,6 +54,11 @@ private Q_SLOTS:
     void initTestCase();
     void cleanupTestCase();
     void testAccountInvalid();
+    void testSynchronizeReplay();
+    void testBackfillWindows();
+    void testHandlesDoNotLeak();
+    void testImportCyclesDoNotLeak();
+    void testStatementFiles();
 };
 
 BankingTest::BankingTest()
@@ -97,6 +110,179 @@ void BankingTest::testAccountInvalid()
     QCOMPARE(account->isValid(), false);
 }
 
+void BankingTest::testSynchronizeReplay()
+{
+    const QScopedPointer<Account> first(BaseTest::createFakeAccount());
+    const QScopedPointer<Account> second(BaseTest::createFakeAccount());
+    const QScopedPointer<Account> invalid(BaseTest::createFakeAccount(AB_AccountType_Invalid));
+    const QString replayFile = QDir::tempPath().append("/olbaflinx_banking_replay.db");
+
+    AB_IMEXPORTER_CONTEXT *context = AB_ImExporterContext_new();
+    for (const auto &account : {first.data(), second.data()}) {
+        AB_IMEXPORTER_ACCOUNTINFO *accountInfo = AB_ImExporterAccountInfo_new();
+        AB_ImExporterAccountInfo_SetAccountId(accountInfo, account->uniqueId());
+
+        AB_TRANSACTION *transaction = AB_Transaction_new();
+        AB_Transaction_SetUniqueAccountId(transaction, account->uniqueId());
+        AB_ImExporterAccountInfo_AddTransaction(accountInfo, transaction);
+        AB_ImExporterAccountInfo_AddBalance(accountInfo, AB_Balance_new());
+
+        AB_ImExporterContext_AddAccountInfo(context, accountInfo);
+    }
+    QVERIFY(ReplayTransport::record(context, replayFile));
+    AB_ImExporterContext_free(context);
+
+    const auto banking = OnlineBanking::instance();
+    const auto transport = new ReplayTransport(replayFile);
+    banking->setTransport(transport);
+
+    const auto results = banking->synchronize({first.data(), second.data(), invalid.data()});
+
+    // One job list for all accounts, balance and transactions for each
+    QCOMPARE(transport->sendCount(), 1);
+    QCOMPARE(transport->commands().size(), 4);
+
+    QCOMPARE(results.size(), 3);
+    for (const auto &account : {first.data(), second.data()}) {
+        const auto result = results.value(account->uniqueId());
+        QVERIFY(result.errorMessage.isEmpty());
+        QCOMPARE(result.balances.size(), 1);
+        QCOMPARE(result.transactions.size(), 1);
+        QCOMPARE(result.transactions.first()->uniqueAccountId(), account->uniqueId());
+        QCOMPARE(result.fetchedIntervals.size(), 1);
+    }
+    QVERIFY(!results.value(invalid->uniqueId()).errorMessage.isEmpty());
+    QVERIFY(results.value(invalid->uniqueId()).fetchedIntervals.isEmpty());
+
+    for (const auto &result : results) {
+        qDeleteAll(result.balances);
+        qDeleteAll(result.transactions);
+    }
+
+    banking->setTransport(Q_NULLPTR);
+    QFile::remove(replayFile);
+}
+
+void BankingTest::testBackfillWindows()
+{
+    const QDate day(2022, 1, 1);
+
+    // Newest first, the oldest window is cut at the target
+    QCOMPARE(BackfillScheduler::windows(AccountCoverage(), day, day.addDays(249), 100),
+             DateIntervals({{day.addDays(150), day.addDays(249)},
+                            {day.addDays(50), day.addDays(149)},
+                            {day, day.addDays(49)}}));
+
+    // Covered days are skipped, windows don't span a covered range
+    const AccountCoverage coverage({{day.addDays(100), day.addDays(199)}});
+    QCOMPARE(BackfillScheduler::windows(coverage, day, day.addDays(249), 100),
+             DateIntervals({{day.addDays(200), day.addDays(249)},
+                            {day, day.addDays(99)}}));
+
+    QVERIFY(BackfillScheduler::windows(coverage, day.addDays(120), day.addDays(150)).isEmpty());
+}
+
+void BankingTest::testHandlesDoNotLeak()
+{
+    const QScopedPointer<Account> account(BaseTest::createFakeAccount());
+    const QString replayFile = QDir::tempPath().append("/olbaflinx_banking_leak.db");
+
+    const ImExporterContextHandle context(AB_ImExporterContext_new());
+    AB_IMEXPORTER_ACCOUNTINFO *accountInfo = AB_ImExporterAccountInfo_new();
+    AB_ImExporterAccountInfo_SetAccountId(accountInfo, account->uniqueId());
+    AB_ImExporterAccountInfo_AddTransaction(accountInfo, AB_Transaction_new());
+    AB_ImExporterAccountInfo_AddBalance(accountInfo, AB_Balance_new());
+    AB_ImExporterContext_AddAccountInfo(context.get(), accountInfo);
+    QVERIFY(ReplayTransport::record(context.get(), replayFile));
+
+    const auto banking = OnlineBanking::instance();
+    banking->setTransport(new ReplayTransport(replayFile));
+
+    const int transactions = TransactionHandle::ownedCount();
+    const int balances = BalanceHandle::ownedCount();
+    const int contexts = ImExporterContextHandle::ownedCount();
+
+    for (int i = 0; i < 20; ++i) {
+        const auto results = banking->synchronize({account.data()});
+        QCOMPARE(results.value(account->uniqueId()).transactions.size(), 1);
+
+        for (const auto &result : results) {
+            qDeleteAll(result.balances);
+            qDeleteAll(result.transactions);
+        }
+    }
+
+    QCOMPARE(TransactionHandle::ownedCount(), transactions);
+    QCOMPARE(BalanceHandle::ownedCount(), balances);
+    QCOMPARE(ImExporterContextHandle::ownedCount(), contexts);
+
+    banking->setTransport(Q_NULLPTR);
+    QFile::remove(replayFile);
+}
+
+void BankingTest::testImportCyclesDoNotLeak()
+{
+    // Run by the BankingLeakTest under valgrind as well, the counters only see
+    // the wrappers while valgrind sees every AB_ and GWEN_ allocation
+    QByteArray data(":20:STARTUMSE\r\n:25:50010517/0137075030\r\n:60F:C220103EUR1000,00\r\n");
+    for (int i = 0; i < 100; ++i) {
+        data.append(":61:2201030103DR12,50NDDTNONREF\r\n"
+                         ":86:105?00SEPA-BASISLASTSCHRIFT?20EREF+4711?21SVWZ+Rechnung\r\n");
+    }
+    data.append(":62F:C220104EUR1237,50\r\n-\r\n");
+
+    const int transactions = TransactionHandle::ownedCount();
+    const int contexts = ImExporterContextHandle::ownedCount();
+
+    for (int cycle = 0; cycle < 50; ++cycle) {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+        const QScopedPointer<statement::StatementParser> parser(
+            statement::StatementParser::create(statement::StatementParser::Mt940Format));
+        const int count = parser->parse(&buffer, [](const TransactionList &batch, int) {
+            qDeleteAll(batch);
+            return true;
+        });
+        QCOMPARE(count, 100);
+
+        // Taken out of an aqbanking context and freed
+        ImExporterContextHandle context(AB_ImExporterContext_new());
+        AB_IMEXPORTER_ACCOUNTINFO *accountInfo = AB_ImExporterAccountInfo_new();
+        for (int i = 0; i < 100; ++i) {
+            AB_ImExporterAccountInfo_AddTransaction(accountInfo, AB_Transaction_new());
+        }
+        AB_ImExporterContext_AddAccountInfo(context.get(), accountInfo);
+
+        const auto taken = OnlineBanking::takeTransactions(context.get());
+        QCOMPARE(taken.size(), 100);
+        qDeleteAll(taken);
+    }
+
+    QCOMPARE(TransactionHandle::ownedCount(), transactions);
+    QCOMPARE(ImExporterContextHandle::ownedCount(), contexts);
+}
+
+void BankingTest::testStatementFiles()
+{
+    QDir directory(QDir::tempPath().append("/olbaflinx_statements"));
+    directory.removeRecursively();
+    QVERIFY(directory.mkpath("2022/06"));
+
+    for (const auto &name : {"2022-02.sta", "2022-01.sta", "2022-03.xml"}) {
+        QFile file(directory.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+    }
+
+    // Sorted by name, sub directories are not searched
+    QCOMPARE(StatementImporter::statementFiles(directory.path()),
+             QStringList({directory.filePath("2022-01.sta"),
+                          directory.filePath("2022-02.sta"),
+                          directory.filePath("2022-03.xml")}));
+
+    directory.removeRecursively();
+}
+
 } // namespace olbaflinx::core::banking::tests
 
 QTEST_MAIN(banking::tests::BankingTest)
@@ -0,0 +1,155 @@
+/**
+ * Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+#include "core/Storage/Category/CategoryMatcher.h"
+
+using namespace olbaflinx::core::storage::category;
+
+namespace olbaflinx::core::storage::category::tests {
+
+class CategoryTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    CategoryTest();
+    ~CategoryTest() override;
+
+private:
+    static CategoryRule createRule(quint32 id,
+                                   const QString &category,
+                                   const QString &pattern,
+                                   CategoryRuleFields fields = FieldText,
+                                   int priority = 0);
+
+private Q_SLOTS:
+    void testEmptyMatcher();
+    void testPayeeAndPurpose();
+    void testFieldRestriction();
+    void testOverlappingPatterns();
+    void testPriority();
+    void testAmountRange();
+    void testIban();
+};
+
+CategoryTest::CategoryTest() = default;
+CategoryTest::~CategoryTest() = default;
+
+CategoryRule CategoryTest::createRule(quint32 id,
+                                      const QString &category,
+                                      const QString &pattern,
+                                      CategoryRuleFields fields,
+                                      int priority)
+{
+    CategoryRule rule;
+    rule.id = id;
+    rule.category = category;
+    rule.pattern = pattern;
+    rule.fields = fields;
+    rule.priority = priority;
+
+    return rule;
+}
+
+void CategoryTest::testEmptyMatcher()
+{
+    const CategoryMatcher matcher;
+    QVERIFY(matcher.isEmpty());
+    QVERIFY(matcher.match("Shell", "Tanken", "", -50.0) == Q_NULLPTR);
+}
+
+void CategoryTest::testPayeeAndPurpose()
+{
+    const CategoryMatcher matcher({createRule(1, "Auto/Tanken", "shell"),
+                                   createRule(2, "Wohnen/Miete", "Miete")});
+
+    const auto fuel = matcher.match("SHELL Deutschland", "Kartenzahlung", "", -50.0);
+    QVERIFY(fuel != Q_NULLPTR);
+    QCOMPARE(fuel->category, "Auto/Tanken");
+
+    const auto rent = matcher.match("Hausverwaltung", "MIETE\nJuni 2022", "", -800.0);
+    QVERIFY(rent != Q_NULLPTR);
+    QCOMPARE(rent->id, 2u);
+
+    QVERIFY(matcher.match("Supermarkt", "Einkauf", "", -20.0) == Q_NULLPTR);
+}
+
+void CategoryTest::testFieldRestriction()
+{
+    const CategoryMatcher matcher({createRule(1, "Gehalt", "lohn", FieldPurpose),
+                                   createRule(2, "Arbeit", "arbeitgeber")});
+
+    QVERIFY(matcher.match("Lohnsteuerhilfe", "Beitrag", "", -10.0) == Q_NULLPTR);
+    QVERIFY(matcher.match("Arbeitgeber", "Lohn Juni", "", 2000.0) != Q_NULLPTR);
+
+    // A hit must not span two fields
+    QVERIFY(matcher.match("Ar", "beitgeber", "", 0.0) == Q_NULLPTR);
+}
+
+void CategoryTest::testOverlappingPatterns()
+{
+    const CategoryMatcher matcher({createRule(1, "A", "he"),
+                                   createRule(2, "B", "she", FieldText, 1),
+                                   createRule(3, "C", "hers", FieldText, 2)});
+
+    const auto rule = matcher.match("ushers", "", "", 0.0);
+    QVERIFY(rule != Q_NULLPTR);
+    QCOMPARE(rule->category, "C");
+}
+
+void CategoryTest::testPriority()
+{
+    const CategoryMatcher matcher({createRule(5, "Lebensmittel", "rewe"),
+                                   createRule(3, "Lebensmittel/Getränke", "rewe"),
+                                   createRule(9, "Drogerie", "dm", FieldPayee, 10)});
+
+    QCOMPARE(matcher.match("REWE Markt", "", "", -5.0)->id, 3u);
+    QCOMPARE(matcher.match("dm REWE", "", "", -5.0)->id, 9u);
+}
+
+void CategoryTest::testAmountRange()
+{
+    auto income = createRule(1, "Einnahmen", "");
+    income.minValue = 0.0;
+
+    auto rent = createRule(2, "Wohnen/Miete", "miete", FieldText, 1);
+    rent.maxValue = -500.0;
+
+    const CategoryMatcher matcher({income, rent});
+
+    QCOMPARE(matcher.match("", "Miete", "", -800.0)->id, 2u);
+    QVERIFY(matcher.match("", "Miete", "", -100.0) == Q_NULLPTR);
+    QCOMPARE(matcher.match("", "Miete", "", 800.0)->id, 1u);
+}
+
+void CategoryTest::testIban()
+{
+    const CategoryMatcher matcher(
+        {createRule(1, "Versicherung", "DE02 5001 0517 0137 0750 30", FieldIban)});
+
+    QVERIFY(matcher.match("", "", "de02500105170137075030", -30.0) != Q_NULLPTR);
+    QVERIFY(matcher.match("DE02500105170137075030", "", "", -30.0) == Q_NULLPTR);
+}
+
+} // namespace olbaflinx::core::storage::category::tests
+
+QTEST_MAIN(category::tests::CategoryTest)
+
+#include "CategoryTest.moc"
@@ -0,0 +1,131 @@
+/**
+ * Copyright (C) 2022, Alexander Saal <developer@olbaflinx.chm-projects.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtCore/QObject>
+#include <QtTest/QtTest>
+
+#include "core/Progress/ProgressReporter.h"
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::progress;
+
+namespace olbaflinx::core::progress::tests {
+
+class ProgressTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ProgressTest();
+    ~ProgressTest() override;
+
+private Q_SLOTS:
+    void testSingleTask();
+    void testWeightedTasks();
+    void testNestedTasks();
+    void testCoalescing();
+    void testFinish();
+};
+
+ProgressTest::ProgressTest() = default;
+ProgressTest::~ProgressTest() = default;
+
+void ProgressTest::testSingleTask()
+{
+    ProgressReporter reporter;
+    const int task = reporter.addTask("Rows", 200);
+    reporter.advance(task, 50);
+
+    const auto state = reporter.state();
+    QCOMPARE(state.percentage, 25.0);
+    QCOMPARE(state.processed, qint64(50));
+    QCOMPARE(state.total, qint64(200));
+    QCOMPARE(state.task, QString("Rows"));
+}
+
+void ProgressTest::testWeightedTasks()
+{
+    ProgressReporter reporter;
+    const int first = reporter.addTask("First", 10, 3.0);
+    const int second = reporter.addTask("Second", 10, 1.0);
+
+    reporter.advance(second, 10);
+    QCOMPARE(reporter.state().percentage, 25.0);
+
+    reporter.advance(first, 5);
+    QCOMPARE(reporter.state().percentage, 62.5);
+}
+
+void ProgressTest::testNestedTasks()
+{
+    ProgressReporter reporter;
+    const int parent = reporter.addTask("Parent", 0, 1.0);
+    const int other = reporter.addTask("Other", 4, 1.0);
+    const int child = reporter.addTask("Child", 4, 1.0, parent);
+    reporter.addTask("Sibling", 4, 1.0, parent);
+
+    // The parent is half done through its first child
+    reporter.finishTask(child);
+    QCOMPARE(reporter.state().percentage, 25.0);
+
+    reporter.advance(other, 2);
+    QCOMPARE(reporter.state().percentage, 50.0);
+}
+
+void ProgressTest::testCoalescing()
+{
+    ProgressReporter reporter(Q_NULLPTR, 60 * 1000);
+    QSignalSpy spy(&reporter, &ProgressReporter::progress);
+
+    const int task = reporter.addTask("Rows", 100000);
+    for (int row = 0; row < 100000; ++row) {
+        reporter.advance(task);
+    }
+
+    // The first change is reported at once, the rest within the interval not
+    QCOMPARE(spy.count(), 1);
+
+    reporter.finish();
+    QCOMPARE(spy.count(), 2);
+    QCOMPARE(spy.last().at(0).toReal(), 100.0);
+}
+
+void ProgressTest::testFinish()
+{
+    ProgressReporter reporter(Q_NULLPTR, 0);
+    QSignalSpy spy(&reporter, &ProgressReporter::stateChanged);
+
+    const int task = reporter.addTask("Rows", 4);
+    for (int row = 0; row < 4; ++row) {
+        reporter.advance(task);
+    }
+    QCOMPARE(spy.count(), 4);
+
+    reporter.finish();
+    reporter.finish();
+    QCOMPARE(spy.count(), 5);
+
+    const auto state = qvariant_cast<ProgressState>(spy.last().at(0));
+    QCOMPARE(state.remaining, qint64(0));
+    QCOMPARE(state.processed, qint64(4));
+}
+
+} // namespace olbaflinx::core::progress::tests
+
+QTEST_MAIN(progress::tests::ProgressTest)
+
+#include "ProgressTest.moc"
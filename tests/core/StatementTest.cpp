@@ -0,0 +1,659 @@
+/**
+ * Copyright (C) 2021, Alexander Saal <developer@olbaflinx.chm-projects.de>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <QtCore/QBuffer>
+#include <QtCore/QDir>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QXmlStreamReader>
+#include <QtTest/QtTest>
+
+#include "core/Banking/OnlineBanking.h"
+#include "core/SingleApplication/SingleApplication.h"
+#include "core/Statement/CsvParser.h"
+#include "core/Statement/CsvWriter.h"
+#include "core/Statement/JsonLinesWriter.h"
+#include "core/Statement/OfxWriter.h"
+#include "core/Statement/StatementParser.h"
+
+using namespace olbaflinx::core;
+using namespace olbaflinx::core::banking;
+using namespace olbaflinx::core::statement;
+
+namespace olbaflinx::core::statement::tests {
+
+class StatementTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    StatementTest();
+    ~StatementTest() override;
+
+private:
+    QDir dataDirectory;
+
+    TransactionList parse(const QString &fileName) const;
+    static QByteArray createMt940(const int entries);
+    static QByteArray createCamt053(const int entries);
+    static QByteArray createCsv(const int entries);
+    static CsvProfile csvProfile();
+    static QByteArray write(StatementWriter *writer, const TransactionList &transactions);
+
+private Q_SLOTS:
+    void initTestCase();
+    void cleanupTestCase();
+    void testDetect();
+    void testMt940Sepa();
+    void testMt940Legacy();
+    void testCamt053();
+    void testBatches();
+    void testMalformedAfterBatch();
+    void testCsvScan();
+    void testCsvProfile();
+    void testCsv();
+    void testCsvChunks();
+    void testCsvWriter();
+    void testJsonLinesWriter();
+    void testOfxWriter();
+    void testConformance_data();
+    void testConformance();
+    void testThroughput_data();
+    void testThroughput();
+};
+
+StatementTest::StatementTest()
+    : dataDirectory(QFINDTESTDATA("../data/statements"))
+{
+    SingleApplication::setApplicationName("OlbaFlinx");
+    SingleApplication::setApplicationVersion("1.0.0");
+    SingleApplication::setOrganizationName("de.chm-projects.olbaflinx.test");
+    SingleApplication::setOrganizationDomain("https://olbaflinx.chm-projects.de");
+}
+
+StatementTest::~StatementTest() = default;
+
+TransactionList StatementTest::parse(const QString &fileName) const
+{
+    const QString filePath = dataDirectory.filePath(fileName);
+    const QScopedPointer<StatementParser> parser(
+        StatementParser::create(StatementParser::detect(filePath)));
+    if (parser.isNull()) {
+        return {};
+    }
+
+    TransactionList transactions = {};
+    parser->parseFile(filePath, [&transactions](const TransactionList &batch, int) {
+        transactions << batch;
+        return true;
+    });
+    return transactions;
+}
+
+QByteArray StatementTest::createMt940(const int entries)
+{
+    QByteArray data(":20:STARTUMSE\r\n:25:50010517/0137075030\r\n:60F:C220103EUR1000,00\r\n");
+    for (int i = 0; i < entries; ++i) {
+        data.append(QString(":61:2201030103DR%1,50NDDTNONREF\r\n").arg(i % 1000).toLatin1());
+        data.append(":86:105?00SEPA-BASISLASTSCHRIFT?109310?20EREF+4711-0815?21MREF+M-20\r\n"
+                    "?2221-001?23SVWZ+Mobilfunk Rechnung?30INGDDEFFXXX?31DE02500105170137075030\r\n"
+                    "?32Telefon GmbH\r\n");
+    }
+    data.append(":62F:C220104EUR1237,50\r\n-\r\n");
+    return data;
+}
+
+QByteArray StatementTest::createCamt053(const int entries)
+{
+    QByteArray data("<?xml version=\"1.0\" encoding=\"UTF-8\"?>"
+                    "<Document xmlns=\"urn:iso:std:iso:20022:tech:xsd:camt.053.001.02\">"
+                    "<BkToCstmrStmt><Stmt><Acct><Id><IBAN>DE02500105170137075030</IBAN></Id>"
+                    "<Ccy>EUR</Ccy></Acct>");
+    for (int i = 0; i < entries; ++i) {
+        data.append(QString("<Ntry><Amt Ccy=\"EUR\">%1.50</Amt><CdtDbtInd>DBIT</CdtDbtInd>"
+                            "<BookgDt><Dt>2022-01-03</Dt></BookgDt>"
+                            "<ValDt><Dt>2022-01-03</Dt></ValDt><NtryDtls><TxDtls>"
+                            "<Refs><EndToEndId>4711-0815</EndToEndId></Refs>"
+                            "<RltdPties><Cdtr><Nm>Telefon GmbH</Nm></Cdtr><CdtrAcct><Id>"
+                            "<IBAN>DE02500105170137075030</IBAN></Id></CdtrAcct></RltdPties>"
+                            "<RmtInf><Ustrd>Mobilfunk Rechnung</Ustrd></RmtInf>"
+                            "</TxDtls></NtryDtls></Ntry>")
+                        .arg(i % 1000)
+                        .toLatin1());
+    }
+    data.append("</Stmt></BkToCstmrStmt></Document>");
+    return data;
+}
+
+QByteArray StatementTest::createCsv(const int entries)
+{
+    QByteArray data("Kontoauszug;DE02500105170137075030\r\n"
+                    "Buchungstag;Valuta;Empfaenger;IBAN;Verwendungszweck;Soll/Haben;Betrag\r\n");
+    for (int i = 0; i < entries; ++i) {
+        data.append(QString("03.01.22;03.01.2022;Telefon GmbH;DE02 5001 0517 0137 0750 30;"
+                            "\"Rechnung %1; Mobilfunk\";S;1.%2,50\r\n")
+                        .arg(i)
+                        .arg(i % 1000, 3, 10, QChar('0'))
+                        .toLatin1());
+    }
+    return data;
+}
+
+CsvProfile StatementTest::csvProfile()
+{
+    CsvProfile profile;
+    profile.name = "Test";
+    profile.encoding = "ISO-8859-15";
+    profile.skipLines = 1;
+    profile.dateFormats = QStringList({"dd.MM.yy", "dd.MM.yyyy"});
+    profile.signConvention = CsvProfile::DebitCreditIndicator;
+    profile.setColumn(CsvProfile::DateField, 0);
+    profile.setColumn(CsvProfile::ValutaDateField, 1);
+    profile.setColumn(CsvProfile::RemoteNameField, 2);
+    profile.setColumn(CsvProfile::RemoteIbanField, 3);
+    profile.setColumn(CsvProfile::PurposeField, 4);
+    profile.setColumn(CsvProfile::IndicatorField, 5);
+    profile.setColumn(CsvProfile::ValueField, 6);
+    return profile;
+}
+
+QByteArray StatementTest::write(StatementWriter *writer, const TransactionList &transactions)
+{
+    AB_ACCOUNT_SPEC *accountSpec = AB_AccountSpec_new();
+    AB_AccountSpec_SetUniqueId(accountSpec, 1);
+    AB_AccountSpec_SetIban(accountSpec, "DE02500105170137075030");
+    const Account account(accountSpec);
+    AB_AccountSpec_free(accountSpec);
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    if (!buffer.open(QIODevice::WriteOnly) || !writer->begin(&buffer)) {
+        return {};
+    }
+
+    writer->beginAccount(&account, QDate(2022, 1, 1), QDate(2022, 1, 31));
+    for (const auto transaction : transactions) {
+        writer->write(transaction);
+    }
+    writer->endAccount();
+
+    return writer->end() ? data : QByteArray();
+}
+
+void StatementTest::initTestCase()
+{
+    QVERIFY(dataDirectory.exists());
+
+    bool initialized = OnlineBanking::instance()
+                           ->initialize(SingleApplication::applicationName(),
+                                        QString("%1").arg(QRandomGenerator::system()->generate()),
+                                        SingleApplication::applicationVersion());
+    QVERIFY(initialized);
+}
+
+void StatementTest::cleanupTestCase()
+{
+    OnlineBanking::instance()->finalize();
+}
+
+void StatementTest::testDetect()
+{
+    QCOMPARE(StatementParser::detect(dataDirectory.filePath("sepa.sta")),
+             StatementParser::Mt940Format);
+    QCOMPARE(StatementParser::detect(dataDirectory.filePath("legacy.sta")),
+             StatementParser::Mt940Format);
+    QCOMPARE(StatementParser::detect(dataDirectory.filePath("camt053.xml")),
+             StatementParser::Camt053Format);
+
+    QByteArray csv("Datum;Betrag;Verwendungszweck\n03.01.2022;-12,50;Miete\n");
+    QBuffer buffer(&csv);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QCOMPARE(StatementParser::detect(&buffer), StatementParser::UnknownFormat);
+    QCOMPARE(buffer.pos(), 0);
+}
+
+void StatementTest::testMt940Sepa()
+{
+    const auto transactions = parse("sepa.sta");
+    QCOMPARE(transactions.size(), 2);
+
+    const auto debit = transactions.at(0);
+    QCOMPARE(debit->date(), QDate(2022, 1, 3));
+    QCOMPARE(debit->valutaDate(), QDate(2022, 1, 3));
+    QCOMPARE(debit->value(), -12.5);
+    QCOMPARE(debit->currency(), "EUR");
+    QCOMPARE(debit->localBankCode(), "50010517");
+    QCOMPARE(debit->localAccountNumber(), "0137075030");
+    QCOMPARE(debit->transactionKey(), "DDT");
+    QCOMPARE(debit->transactionCode(), 105);
+    QCOMPARE(debit->transactionText(), "SEPA-BASISLASTSCHRIFT");
+    QCOMPARE(debit->primanota(), "9310");
+    QCOMPARE(debit->endToEndReference(), "4711-0815");
+    QCOMPARE(debit->mandateId(), "M-2021-001");
+    QCOMPARE(debit->creditorSchemeId(), "DE98ZZZ09999999999");
+    QCOMPARE(debit->purpose(), "Mobilfunk Rechnung 12/2021");
+    QCOMPARE(debit->remoteIban(), "DE02500105170137075030");
+    QCOMPARE(debit->remoteBic(), "INGDDEFFXXX");
+    QCOMPARE(debit->remoteName(), "Telefon GmbH");
+
+    const auto credit = transactions.at(1);
+    QCOMPARE(credit->value(), 250.0);
+    QCOMPARE(credit->endToEndReference(), "");
+    QCOMPARE(credit->purpose(), "Gehalt Januar");
+    QCOMPARE(credit->remoteName(), "Arbeitgeber AG");
+
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testMt940Legacy()
+{
+    const auto transactions = parse("legacy.sta");
+    QCOMPARE(transactions.size(), 2);
+
+    // Booked in the old year, valuta in the new one
+    const auto debit = transactions.at(0);
+    QCOMPARE(debit->date(), QDate(2021, 12, 31));
+    QCOMPARE(debit->valutaDate(), QDate(2022, 1, 1));
+    QCOMPARE(debit->value(), -45.0);
+    QCOMPARE(debit->localAccountNumber(), "1234567");
+    QCOMPARE(debit->customerReference(), "KREF123");
+    QCOMPARE(debit->bankReference(), "BANKREF9");
+    QCOMPARE(debit->purpose(), "Miete Januar\nWohnung 3");
+    QCOMPARE(debit->remoteBankCode(), "10020030");
+    QCOMPARE(debit->remoteAccountNumber(), "1234567890");
+    QCOMPARE(debit->remoteName(), "Vermieter GmbH");
+
+    // Unstructured details are the purpose as they are
+    const auto credit = transactions.at(1);
+    QCOMPARE(credit->date(), QDate(2022, 1, 2));
+    QCOMPARE(credit->value(), 5.0);
+    QCOMPARE(credit->purpose(), "Zinsen");
+
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testCamt053()
+{
+    const auto transactions = parse("camt053.xml");
+    QCOMPARE(transactions.size(), 2);
+
+    const auto debit = transactions.at(0);
+    QCOMPARE(debit->date(), QDate(2022, 1, 3));
+    QCOMPARE(debit->value(), -12.5);
+    QCOMPARE(debit->currency(), "EUR");
+    QCOMPARE(debit->localIban(), "DE02500105170137075030");
+    QCOMPARE(debit->localBic(), "INGDDEFFXXX");
+    QCOMPARE(debit->bankReference(), "REF-0001");
+    QCOMPARE(debit->transactionText(), "SEPA-BASISLASTSCHRIFT");
+    QCOMPARE(debit->endToEndReference(), "4711-0815");
+    QCOMPARE(debit->mandateId(), "M-2021-001");
+    QCOMPARE(debit->creditorSchemeId(), "DE98ZZZ09999999999");
+    QCOMPARE(debit->purpose(), "Mobilfunk Rechnung 12/2021");
+    QCOMPARE(debit->remoteName(), "Telefon GmbH");
+    QCOMPARE(debit->remoteIban(), "DE02500105170137075030");
+    QCOMPARE(debit->remoteBic(), "INGDDEFFXXX");
+
+    // The debtor is the remote party of a credit
+    const auto credit = transactions.at(1);
+    QCOMPARE(credit->value(), 250.0);
+    QCOMPARE(credit->endToEndReference(), "");
+    QCOMPARE(credit->remoteName(), "Arbeitgeber AG");
+    QCOMPARE(credit->remoteIban(), "DE89370400440532013000");
+    QCOMPARE(credit->remoteBic(), "COBADEFFXXX");
+
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testBatches()
+{
+    QByteArray data = createMt940(StorageImportBatchSize * 2 + 1);
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    QVector<int> batchSizes = {};
+    const QScopedPointer<StatementParser> parser(
+        StatementParser::create(StatementParser::Mt940Format));
+    const int count = parser->parse(&buffer, [&batchSizes](const TransactionList &batch, int) {
+        batchSizes << batch.size();
+        qDeleteAll(batch);
+        return true;
+    });
+
+    QCOMPARE(count, StorageImportBatchSize * 2 + 1);
+    QCOMPARE(batchSizes, QVector<int>({StorageImportBatchSize, StorageImportBatchSize, 1}));
+}
+
+void StatementTest::testMalformedAfterBatch()
+{
+    // A full batch is read before the malformed statement line
+    QByteArray data = createMt940(StorageImportBatchSize + 1);
+    data.replace(":62F:", ":61:2201XX0103DR1,50NDDTNONREF\r\n:62F:");
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    int batches = 0;
+    const QScopedPointer<StatementParser> parser(
+        StatementParser::create(StatementParser::Mt940Format));
+    const int count = parser->parse(&buffer, [&batches](const TransactionList &batch, int) {
+        ++batches;
+        qDeleteAll(batch);
+        return true;
+    });
+
+    QCOMPARE(count, -1);
+    QCOMPARE(batches, 0);
+    QVERIFY(!parser->errorMessage().isEmpty());
+}
+
+void StatementTest::testCsvScan()
+{
+    // Quoted delimiters and line feeds across the 64 byte blocks of the scanner
+    QByteArray data("a;\"b;\nc\";d\n");
+    for (int i = 0; i < 3; ++i) {
+        data.append("0123456789;\"x\"\"y;zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz\";e\n");
+    }
+    data.append("f;\"open");
+
+    QVector<quint32> separators = {};
+    const int end = CsvParser::scan(data.constData(), data.size(), ';', '"', separators);
+
+    QCOMPARE(end, data.lastIndexOf('\n') + 1);
+    QCOMPARE(separators.size(), 12);
+    QCOMPARE(separators.at(0), quint32(data.indexOf(';')));
+    QCOMPARE(separators.at(1), quint32(data.indexOf("\";d") + 1));
+    QCOMPARE(separators.at(2), quint32(data.indexOf("d\n") + 1) | CsvParser::RecordEnd);
+    QCOMPARE(separators.last(), quint32(end - 1) | CsvParser::RecordEnd);
+}
+
+void StatementTest::testCsvProfile()
+{
+    const auto profile = csvProfile();
+    QVERIFY(profile.isValid());
+
+    const auto restored = CsvProfile::fromVariant(profile.toVariant());
+    QCOMPARE(restored.name, profile.name);
+    QCOMPARE(restored.encoding, profile.encoding);
+    QCOMPARE(restored.delimiter, profile.delimiter);
+    QCOMPARE(restored.dateFormats, profile.dateFormats);
+    QCOMPARE(restored.signConvention, profile.signConvention);
+    QCOMPARE(restored.columns, profile.columns);
+
+    CsvProfile incomplete = profile;
+    incomplete.setColumn(CsvProfile::IndicatorField, -1);
+    QVERIFY(!incomplete.isValid());
+}
+
+void StatementTest::testCsv()
+{
+    QByteArray data = createCsv(2);
+    data.append("\r\nSaldo;;;;;;\r\n");
+    data.append("04.01.2022;04.01.2022;\"Arbeitgeber \"\"AG\"\"\";;\"Gehalt\nJanuar\";H;250,00");
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TransactionList transactions = {};
+    CsvParser parser(csvProfile());
+    const int count = parser.parse(&buffer, [&transactions](const TransactionList &batch, int) {
+        transactions << batch;
+        return true;
+    });
+
+    QCOMPARE(count, 3);
+    QCOMPARE(parser.skippedRecords(), 1);
+
+    const auto debit = transactions.at(1);
+    QCOMPARE(debit->date(), QDate(2022, 1, 3));
+    QCOMPARE(debit->valutaDate(), QDate(2022, 1, 3));
+    QCOMPARE(debit->value(), -1001.5);
+    QCOMPARE(debit->currency(), "EUR");
+    QCOMPARE(debit->remoteName(), "Telefon GmbH");
+    QCOMPARE(debit->remoteIban(), "DE02500105170137075030");
+    QCOMPARE(debit->purpose(), "Rechnung 1; Mobilfunk");
+
+    const auto credit = transactions.at(2);
+    QCOMPARE(credit->value(), 250.0);
+    QCOMPARE(credit->remoteName(), "Arbeitgeber \"AG\"");
+    QCOMPARE(credit->purpose(), "Gehalt\nJanuar");
+
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testCsvChunks()
+{
+    // Several chunks, converted on the pool
+    const int entries = 200000;
+    QByteArray data = createCsv(entries);
+    QVERIFY(data.size() > 2 * CsvChunkSize);
+
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    int count = 0;
+    bool isOrdered = true;
+    CsvParser parser(csvProfile());
+    const int parsed = parser.parse(&buffer, [&](const TransactionList &batch, const int total) {
+        for (const auto transaction : batch) {
+            const QString purpose = QString("Rechnung %1; Mobilfunk").arg(count++);
+            isOrdered = isOrdered && transaction->purpose() == purpose;
+        }
+        qDeleteAll(batch);
+        return total >= count;
+    });
+
+    QCOMPARE(parsed, entries);
+    QCOMPARE(count, entries);
+    QVERIFY(isOrdered);
+    QCOMPARE(parser.skippedRecords(), 0);
+}
+
+void StatementTest::testCsvWriter()
+{
+    const auto transactions = parse("sepa.sta");
+    QVERIFY(!transactions.isEmpty());
+
+    CsvWriter writer;
+    QByteArray data = write(&writer, transactions);
+    QVERIFY(!data.isEmpty());
+
+    // Read back with the column mapping of the writer
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+    TransactionList parsed = {};
+    CsvParser parser(CsvWriter::profile());
+    const int count = parser.parse(&buffer, [&parsed](const TransactionList &batch, int) {
+        parsed << batch;
+        return true;
+    });
+
+    QCOMPARE(count, transactions.size());
+    for (int i = 0; i < count; ++i) {
+        const auto expected = transactions.at(i);
+        const auto actual = parsed.at(i);
+        QCOMPARE(actual->date(), expected->date());
+        QCOMPARE(actual->valutaDate(), expected->valutaDate());
+        QCOMPARE(actual->value(), expected->value());
+        QCOMPARE(actual->remoteName(), expected->remoteName());
+        QCOMPARE(actual->remoteIban(), expected->remoteIban());
+        QCOMPARE(actual->purpose(), expected->purpose());
+        QCOMPARE(actual->endToEndReference(), expected->endToEndReference());
+    }
+
+    qDeleteAll(parsed);
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testJsonLinesWriter()
+{
+    const auto transactions = parse("sepa.sta");
+    QVERIFY(!transactions.isEmpty());
+
+    JsonLinesWriter writer;
+    const auto lines = write(&writer, transactions).split('\n');
+
+    // One object per line, the file ends with a line feed
+    QCOMPARE(lines.size(), transactions.size() + 1);
+    QVERIFY(lines.last().isEmpty());
+
+    for (int i = 0; i < transactions.size(); ++i) {
+        QJsonParseError error;
+        const auto object = QJsonDocument::fromJson(lines.at(i), &error).object();
+        QCOMPARE(error.error, QJsonParseError::NoError);
+        QCOMPARE(object.value("accountId").toInt(), 1);
+        QCOMPARE(object.value("value").toDouble(), transactions.at(i)->value());
+        QCOMPARE(object.value("purpose").toString(), transactions.at(i)->purpose());
+    }
+
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testOfxWriter()
+{
+    const auto transactions = parse("sepa.sta");
+    QVERIFY(!transactions.isEmpty());
+
+    OfxWriter writer;
+    const auto data = write(&writer, transactions);
+    QVERIFY(data.contains("OFXHEADER=\"200\""));
+
+    int count = 0;
+    QXmlStreamReader reader(data);
+    while (!reader.atEnd()) {
+        if (reader.readNext() == QXmlStreamReader::StartElement) {
+            if (reader.name() == QLatin1String("STMTTRN")) {
+                ++count;
+            } else if (reader.name() == QLatin1String("DTSTART")) {
+                QCOMPARE(reader.readElementText(), "20220101");
+            }
+        }
+    }
+
+    QVERIFY(!reader.hasError());
+    QCOMPARE(count, transactions.size());
+
+    qDeleteAll(transactions);
+}
+
+void StatementTest::testConformance_data()
+{
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<QString>("importerName");
+    QTest::addColumn<QString>("profileName");
+
+    QTest::newRow("mt940 sepa") << "sepa.sta" << "swift" << "SWIFT-MT940";
+    QTest::newRow("mt940 legacy") << "legacy.sta" << "swift" << "SWIFT-MT940";
+    QTest::newRow("camt.053") << "camt053.xml" << "xml" << "camt_053_001_02";
+}
+
+void StatementTest::testConformance()
+{
+    QFETCH(QString, fileName);
+    QFETCH(QString, importerName);
+    QFETCH(QString, profileName);
+
+    const auto banking = OnlineBanking::instance();
+    const auto context = banking->importContextFromFile(importerName,
+                                                        profileName,
+                                                        dataDirectory.filePath(fileName));
+    if (context.isNull()) {
+        QSKIP("The aqbanking importer is not available");
+    }
+
+    const auto expected = OnlineBanking::takeTransactions(context.get());
+    const auto actual = parse(fileName);
+    QCOMPARE(actual.size(), expected.size());
+
+    // Line breaks of the purpose are up to the importer
+    const auto purpose = [](const Transaction *transaction) {
+        return transaction->purpose().simplified().remove(' ');
+    };
+
+    // Every field a native parser fills in must match the aqbanking importer
+    for (int i = 0; i < actual.size(); ++i) {
+        const auto transaction = actual.at(i);
+        const auto reference = expected.at(i);
+
+        QCOMPARE(transaction->date(), reference->date());
+        QCOMPARE(transaction->valutaDate(), reference->valutaDate());
+        QCOMPARE(transaction->value(), reference->value());
+        QCOMPARE(transaction->currency(), reference->currency());
+        QCOMPARE(transaction->localIban(), reference->localIban());
+        QCOMPARE(transaction->localBic(), reference->localBic());
+        QCOMPARE(transaction->localBankCode(), reference->localBankCode());
+        QCOMPARE(transaction->localAccountNumber(), reference->localAccountNumber());
+        QCOMPARE(transaction->remoteName(), reference->remoteName());
+        QCOMPARE(transaction->remoteIban(), reference->remoteIban());
+        QCOMPARE(transaction->remoteBic(), reference->remoteBic());
+        QCOMPARE(transaction->remoteBankCode(), reference->remoteBankCode());
+        QCOMPARE(transaction->remoteAccountNumber(), reference->remoteAccountNumber());
+        QCOMPARE(purpose(transaction), purpose(reference));
+        QCOMPARE(transaction->transactionText(), reference->transactionText());
+        QCOMPARE(transaction->transactionKey(), reference->transactionKey());
+        QCOMPARE(transaction->transactionCode(), reference->transactionCode());
+        QCOMPARE(transaction->primanota(), reference->primanota());
+        QCOMPARE(transaction->customerReference(), reference->customerReference());
+        QCOMPARE(transaction->bankReference(), reference->bankReference());
+        QCOMPARE(transaction->endToEndReference(), reference->endToEndReference());
+        QCOMPARE(transaction->mandateId(), reference->mandateId());
+        QCOMPARE(transaction->creditorSchemeId(), reference->creditorSchemeId());
+    }
+
+    qDeleteAll(actual);
+    qDeleteAll(expected);
+}
+
+void StatementTest::testThroughput_data()
+{
+    QTest::addColumn<QByteArray>("data");
+
+    QTest::newRow("mt940") << createMt940(20000);
+    QTest::newRow("camt.053") << createCamt053(20000);
+    QTest::newRow("csv") << createCsv(20000);
+}
+
+void StatementTest::testThroughput()
+{
+    QFETCH(QByteArray, data);
+
+    int count = 0;
+    QBENCHMARK {
+        QBuffer buffer(&data);
+        QVERIFY(buffer.open(QIODevice::ReadOnly));
+
+        // CSV isn't detected, its layout comes from the profile
+        QScopedPointer<StatementParser> parser(
+            StatementParser::create(StatementParser::detect(&buffer)));
+        if (parser.isNull()) {
+            parser.reset(new CsvParser(csvProfile()));
+        }
+
+        count = parser->parse(&buffer, [](const TransactionList &batch, int) {
+            qDeleteAll(batch);
+            return true;
+        });
+    }
+    QCOMPARE(count, 20000);
+}
+
+} // namespace olbaflinx::core::statement::tests
+
+QTEST_MAIN(statement::tests::StatementTest)
+
+#include "StatementTest.moc"
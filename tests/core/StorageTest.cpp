@@ -17,11 +17,16 @@
 #include <QtCore/QDir>
 #include <QtCore/QList>
 #include <QtCore/QMap>
+#include <QtCore/QSemaphore>
+#include <QtSql/QSqlQuery>
 #include <QtTest/QtTest>
 
 #include "core/SingleApplication/SingleApplication.h"
 #include "core/Storage/Account/Account.h"
 #include "core/Storage/Account/AccountBalance.h"
+#include "core/Storage/Account/AccountCoverage.h"
+#include "core/Storage/Connection/StorageConnection.h"
+#include "core/Storage/Connection/StorageExecutor.h"
 #include "core/Storage/Transaction/Transaction.h"
 
 #include "core/Storage/VaultStorage.h"
@@ -64,6 +69,11 @@ private Q_SLOTS:
 
     void testCreateAccountValid();
     void testCreateAccountInvalid();
+
+    void testExecutorPriorities();
+    void testExecutorRollsBackFailedWrite();
+
+    void testAccountCoverage();
 };
 
 StorageTest::StorageTest()
@@ -276,6 +286,140 @@ void StorageTest::testCreateAccountInvalid()
     delete account;
 }
 
+void StorageTest::testExecutorPriorities()
+{
+    StorageExecutor executor;
+    QSemaphore started;
+    QSemaphore release;
+    QStringList order = {};
+
+    executor.run(StorageExecutor::Background, [&]() {
+        started.release();
+        release.acquire();
+    });
+    started.acquire();
+
+    executor.run(StorageExecutor::Background, [&]() { order << "background"; });
+    executor.write([&]() { order << "write"; });
+    executor.run(StorageExecutor::Interactive, [&]() { order << "interactive"; });
+
+    auto metrics = executor.metrics();
+    QCOMPARE(metrics.queueDepth, 3);
+    QCOMPARE(metrics.interactiveQueueDepth, 1);
+    QCOMPARE(metrics.backgroundQueueDepth, 1);
+
+    release.release();
+    const int result = executor.execute(StorageExecutor::Background, []() { return 42; });
+
+    QCOMPARE(result, 42);
+    QCOMPARE(order, QStringList({"interactive", "write", "background"}));
+
+    metrics = executor.metrics();
+    QCOMPARE(metrics.queueDepth, 0);
+    QCOMPARE(metrics.executedJobs, qint64(5));
+}
+
+void StorageTest::testExecutorRollsBackFailedWrite()
+{
+    const QString fileName = QDir::tempPath().append("/testExecutorRollback.obfx");
+    QFile::remove(fileName);
+
+    StorageExecutor executor;
+    QVERIFY(executor.open(fileName));
+
+    const auto exec = [&executor](const QString &statement) -> bool {
+        QSqlQuery query(executor.connection()->database());
+        return query.exec(statement);
+    };
+    const auto fromDates = [&executor](const int accountId) -> QStringList {
+        return executor.execute(StorageExecutor::Interactive, [&]() {
+            QSqlQuery query(executor.connection()->database());
+            query.exec(QString("SELECT from_date FROM account_coverage WHERE account_id = %1")
+                           .arg(accountId));
+
+            QStringList dates = {};
+            while (query.next()) {
+                dates << query.value(0).toString();
+            }
+            return dates;
+        });
+    };
+
+    QVERIFY(executor.executeWrite([&]() -> bool {
+        return exec("CREATE TABLE account_coverage (account_id integer not null, "
+                    "from_date date not null, to_date date not null)")
+               && exec("INSERT INTO account_coverage VALUES (1, '2022-06-01', '2022-06-30')");
+    }));
+
+    // A coverage rewrite whose last interval can't be stored
+    const auto rewrite = [&]() -> bool {
+        return exec("DELETE FROM account_coverage WHERE account_id = 1")
+               && exec("INSERT INTO account_coverage VALUES (1, '2022-05-01', '2022-06-30')")
+               && exec("INSERT INTO account_coverage VALUES (1, NULL, '2022-07-31')");
+    };
+
+    QVERIFY(!executor.executeWrite(rewrite));
+    QCOMPARE(fromDates(1), QStringList({"2022-06-01"}));
+
+    // Committed together with another write, only the failed one is undone
+    QSemaphore started;
+    QSemaphore release;
+    executor.run(StorageExecutor::Interactive, [&]() {
+        started.release();
+        release.acquire();
+    });
+    started.acquire();
+
+    auto stored = executor.write([&]() -> bool {
+        return exec("INSERT INTO account_coverage VALUES (2, '2022-01-01', '2022-01-31')");
+    });
+    auto failed = executor.write(rewrite);
+    release.release();
+
+    QVERIFY(stored.result());
+    QVERIFY(!failed.result());
+    QCOMPARE(executor.metrics().groupCommits, qint64(1));
+    QCOMPARE(fromDates(1), QStringList({"2022-06-01"}));
+    QCOMPARE(fromDates(2), QStringList({"2022-01-01"}));
+
+    executor.close();
+    QVERIFY(QFile::remove(fileName));
+}
+
+void StorageTest::testAccountCoverage()
+{
+    const QDate day(2022, 6, 1);
+
+    AccountCoverage coverage;
+    QVERIFY(coverage.isEmpty());
+    QCOMPARE(coverage.missing(day, day.addDays(9)), DateIntervals({{day, day.addDays(9)}}));
+
+    // Overlapping and adjacent intervals are merged
+    coverage.add({day.addDays(10), day.addDays(19)});
+    coverage.add({day.addDays(30), day.addDays(39)});
+    coverage.add({day.addDays(15), day.addDays(24)});
+    coverage.add({day.addDays(25), day.addDays(26)});
+    coverage.add({day.addDays(5), day.addDays(1)});
+
+    QCOMPARE(coverage.intervals(),
+             DateIntervals({{day.addDays(10), day.addDays(26)},
+                            {day.addDays(30), day.addDays(39)}}));
+    QCOMPARE(coverage.firstDate(), day.addDays(10));
+    QVERIFY(coverage.contains(day.addDays(26)));
+    QVERIFY(!coverage.contains(day.addDays(27)));
+
+    QCOMPARE(coverage.missing(day, day.addDays(49)),
+             DateIntervals({{day, day.addDays(9)},
+                            {day.addDays(27), day.addDays(29)},
+                            {day.addDays(40), day.addDays(49)}}));
+    QCOMPARE(coverage.missing(day.addDays(12), day.addDays(20)), DateIntervals());
+    QCOMPARE(coverage.missing(day.addDays(20), day.addDays(30)),
+             DateIntervals({{day.addDays(27), day.addDays(29)}}));
+
+    coverage.add({day.addDays(27), day.addDays(29)});
+    QCOMPARE(coverage.intervals(), DateIntervals({{day.addDays(10), day.addDays(39)}}));
+}
+
 } // namespace olbaflinx::core::storage::tests
 
 QTEST_MAIN(storage::tests::StorageTest)